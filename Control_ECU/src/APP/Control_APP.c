@@ -1,366 +1,1600 @@
-/******************************************************************************
- *
- * Project: Smart_Home
- *
- * File Name: Control_APP.c
- *
- * Author: Kerolous_Labib_Georgy
- *
- * Description:
- * ------------
- * This file implements the main control logic for a Smart Home system.
- * It monitors temperature and distance sensors, controls DC motors (windows),
- * detects system faults, and communicates with another module via UART.
- *
- *******************************************************************************/
-
-#include <avr/io.h>
-#include <util/delay.h>
-#include <avr/interrupt.h>
-#include "uart.h"
-#include "dc_motor.h"
-#include "ultrasonic.h"
-#include "lm35_sensor.h"
-#include "twi.h"
-#include "external_eeprom.h"
-#include "adc.h"
-#include "gpio.h"
-
-/*******************************************************************************
- *                                  Definitions                                *
- *******************************************************************************/
-
-/* UART command bytes */
-#define START_MONITORING     1
-#define DISPLAY_VALUES       2
-#define DETECT_FAULTS        3
-#define STOP_MONITORING      4
-
-/* Communication flags */
-#define READY 0XFF
-#define DONE 0XDF
-#define SYNC_BYTE 0xAA
-#define END_BYTE   'T'
-#define ACK 0x05
-
-/* Critical limits for sensors */
-#define CRITICAL_TEMP             90     // Temperature threshold in °C
-#define CRITICAL_DISTANCE         10     // Minimum safe distance in cm
-
-/* Diagnostic Trouble Codes (DTC) */
-#define DTC_P001 0x01 /* Distance too close */
-#define DTC_P002 0x02 /* Overheat */
-
-/* Window button pin mapping */
-#define WIN1_OPEN_PORT         PORTD_ID
-#define WIN1_OPEN_PIN          PIN2
-#define WIN1_CLOSE_PORT        PORTD_ID
-#define WIN1_CLOSE_PIN         PIN3
-
-#define WIN2_OPEN_PORT         PORTD_ID
-#define WIN2_OPEN_PIN          PIN4
-#define WIN2_CLOSE_PORT        PORTD_ID
-#define WIN2_CLOSE_PIN         PIN5
-
-/* Button states */
-typedef enum {
-	BUTTON_RELEASED,
-	BUTTON_PRESSED
-} BUTTON_STATE;
-
-/* EEPROM max memory address */
-#define EEPROM_MAX_ADDRESS 0x07FF
-
-/*******************************************************************************
- *                           Global Variables                                  *
- *******************************************************************************/
-
-volatile uint8 g_Monitoring = 0;          // System monitoring flag
-volatile uint8 g_tempValue = 0;           // Current temperature reading
-volatile uint16 g_distanceValue = 0;      // Current distance reading
-volatile uint8 g_win1_State = 0;          // Window 1 state (open/close)
-volatile uint8 g_win2_State = 0;          // Window 2 state (open/close)
-volatile uint8 g_distanceLogged = 0;      // Distance fault logged flag
-volatile uint8 g_temperatureLogged = 0;   // Temperature fault logged flag
-volatile uint8 g_faultCount = 0;          // Number of stored faults
-
-static uint16 EEPROM_addressWrite = 0X0000;   // EEPROM write pointer
-uint16 EEPROM_addressRead = 0X0000;           // EEPROM read pointer
-uint8 EEPROM_byte;                            // EEPROM buffer
-
-/*******************************************************************************
- *                           Configuration Structs                             *
- *******************************************************************************/
-
-/* UART communication settings */
-UART_ConfigType UART_Config = {
-	.bit_data = UART_8_BIT_DATA,
-	.parity = UART_PARITY_DISABLED,
-	.stop_bit = UART_ONE_STOP_BIT,
-	.baud_rate = 9600
-};
-
-/* I2C (TWI) configuration for EEPROM communication */
-TWI_ConfigType TWI_Config = {
-	.address = 0X01,
-	.bit_rate = TWI_FAST_MODE
-};
-
-/* ADC configuration for analog sensors (temperature) */
-ADC_typeConfig ADC_config = {
-	.reference = ADC_REF_AVCC,
-	.prescaler = ADC_PRESCALER_64
-};
-
-/* DC Motor configuration (Window 1) */
-MOTOR_typeConfig MOTOR1_typeconfig = {
-	.PORT_ID = PORTB_ID,
-	.IN1_ID = PIN0,
-	.IN2_ID = PIN1,
-	.EN_ID = PIN3
-};
-
-/* DC Motor configuration (Window 2) */
-MOTOR_typeConfig MOTOR2_typeconfig = {
-	.PORT_ID = PORTB_ID,
-	.IN1_ID = PIN4,
-	.IN2_ID = PIN5,
-	.EN_ID = PIN3
-};
-
-/*******************************************************************************
- *                           Function Prototypes                               *
- *******************************************************************************/
-void CONTROL_sendPack(void);
-void CONTROL_winState(void);
-void detectFaults(void);
-void readSensors(void);
-void CONTROL_sendFaults(void);
-
-/*******************************************************************************
- *                                main Function                                *
- *******************************************************************************/
-int main(void){
-
-//    /* Clear EEPROM fault logs at startup */
-//    EEPROM_writeByte(0x0000, 0x00);
-//    _delay_ms(10);
-//    EEPROM_writeByte(0x000, 0x00);
-//    _delay_ms(10);
-
-	/* === Configure button pins as inputs === */
-	GPIO_setupPinDirection(WIN1_OPEN_PORT, WIN1_OPEN_PIN, PIN_INPUT);
-	GPIO_setupPinDirection(WIN1_CLOSE_PORT, WIN1_CLOSE_PIN, PIN_INPUT);
-	GPIO_setupPinDirection(WIN2_OPEN_PORT, WIN2_OPEN_PIN, PIN_INPUT);
-	GPIO_setupPinDirection(WIN2_CLOSE_PORT, WIN2_CLOSE_PIN, PIN_INPUT);
-
-	SREG |= (1 << 7); /* Enable global interrupts */
-
-	uint8 keyValue = 0;  // Store received UART command
-
-	/* Initialize peripherals */
-	ADC_init(&ADC_config);
-	UART_init(&UART_Config);
-	TWI_init(&TWI_Config);
-
-	for(;;){
-		CONTROL_winState(); // Check and control windows
-
-		/* Process UART commands */
-		if(UART_dataAvailable()){
-			keyValue = UART_recieveByte();   // Receive command
-			UART_sendByte(ACK);              // Acknowledge reception
-
-			switch(keyValue){
-
-			case START_MONITORING:
-				Ultrasonic_init();
-				DcMotor_Init(&MOTOR1_typeconfig);
-				DcMotor_Init(&MOTOR2_typeconfig);
-				g_Monitoring = 1;
-				break;
-
-			case DISPLAY_VALUES:
-				CONTROL_sendPack();           // Send sensor data packet
-				break;
-
-			case DETECT_FAULTS:
-				CONTROL_sendFaults();          // Send logged faults
-				g_distanceLogged = 0;
-				g_temperatureLogged = 0;
-				break;
-
-			case STOP_MONITORING:
-				g_Monitoring = 0;
-				break;
-
-			default:
-				break;
-			}
-			keyValue = 0; /* Reset command after processing */
-		}
-
-		/* Monitoring mode: read sensors and detect faults */
-		if(g_Monitoring){
-			readSensors();
-			detectFaults();
-			_delay_ms(100);
-		}
-		else{
-			_delay_ms(50);
-		}
-	}
-}
-
-/*******************************************************************************
- *                           Function Definitions                              *
- *******************************************************************************/
-
-/*
- * Function: CONTROL_sendPack
- * ---------------------------
- * Sends current sensor and window states over UART to the control panel.
- */
-void CONTROL_sendPack(void)
-{
-	g_tempValue = LM35_getTemperature();
-
-	UART_sendByte((uint8)(g_distanceValue >> 8));  // Send high byte of distance
-	while(UART_recieveByte() != ACK);
-
-	UART_sendByte((uint8)(g_distanceValue & 0xFF)); // Send low byte
-	while(UART_recieveByte() != ACK);
-
-	UART_sendByte(g_tempValue);                     // Send temperature
-	while(UART_recieveByte() != ACK);
-
-	UART_sendByte(g_win1_State);                    // Send window 1 state
-	while(UART_recieveByte() != ACK);
-
-	UART_sendByte(g_win2_State);                    // Send window 2 state
-	while(UART_recieveByte() != ACK);
-}
-
-/*
- * Function: readSensors
- * ----------------------
- * Reads distance and temperature sensors and updates global values.
- */
-void readSensors(void)
-{
-	g_distanceValue = Ultrasonic_readDistance();
-	g_tempValue = LM35_getTemperature();
-
-	CONTROL_winState();
-}
-
-/*
- * Function: CONTROL_winState
- * ---------------------------
- * Controls both windows (open/close) based on button inputs.
- */
-void CONTROL_winState(void)
-{
-	uint8 win1_open = GPIO_readPin(WIN1_OPEN_PORT, WIN1_OPEN_PIN);
-	uint8 win1_close = GPIO_readPin(WIN1_CLOSE_PORT, WIN1_CLOSE_PIN);
-	uint8 win2_open = GPIO_readPin(WIN2_OPEN_PORT, WIN2_OPEN_PIN);
-	uint8 win2_close = GPIO_readPin(WIN2_CLOSE_PORT, WIN2_CLOSE_PIN);
-
-	/* === WINDOW 1 CONTROL === */
-	if(win1_open == BUTTON_PRESSED && win1_close == BUTTON_RELEASED){
-		DcMotor_Rotate(&MOTOR1_typeconfig, CW, 100);     // Open window
-		_delay_ms(1000);
-		DcMotor_Rotate(&MOTOR1_typeconfig, STOP, 100);
-		g_win1_State = 1;                                // Mark as open
-	}
-	else if(win1_open == BUTTON_RELEASED && win1_close == BUTTON_PRESSED){
-		DcMotor_Rotate(&MOTOR1_typeconfig, A_CW, 100);   // Close window
-		_delay_ms(1000);
-		DcMotor_Rotate(&MOTOR1_typeconfig, STOP, 100);
-		g_win1_State = 0;                                // Mark as closed
-	}
-
-	/* === WINDOW 2 CONTROL === */
-	if(win2_open == BUTTON_PRESSED && win2_close == BUTTON_RELEASED){
-		DcMotor_Rotate(&MOTOR2_typeconfig, CW, 100);
-		_delay_ms(1000);
-		DcMotor_Rotate(&MOTOR2_typeconfig, STOP, 100);
-		g_win2_State = 1;
-	}
-	else if(win2_open == BUTTON_RELEASED && win2_close == BUTTON_PRESSED){
-		DcMotor_Rotate(&MOTOR2_typeconfig, A_CW, 100);
-		_delay_ms(1000);
-		DcMotor_Rotate(&MOTOR2_typeconfig, STOP, 100);
-		g_win2_State = 0;
-	}
-}
-
-/*
- * Function: detectFaults
- * -----------------------
- * Detects and logs critical temperature or distance faults to EEPROM.
- */
-void detectFaults(void)
-{
-	g_distanceValue = Ultrasonic_readDistance();
-	g_tempValue = LM35_getTemperature();
-	/* Distance too close fault */
-	if ((g_distanceValue < CRITICAL_DISTANCE) && (!g_distanceLogged)){
-		if(EEPROM_addressWrite <= EEPROM_MAX_ADDRESS){
-			if(EEPROM_writeByte(EEPROM_addressWrite, DTC_P001) == SUCCESS){
-				EEPROM_addressWrite++;
-				g_distanceLogged = 1;
-			}
-			_delay_ms(10);
-		}
-	}
-
-	/* Overheating fault */
-	if ((g_tempValue > CRITICAL_TEMP) && (!g_temperatureLogged)){
-		if(EEPROM_addressWrite <= EEPROM_MAX_ADDRESS){
-			if(EEPROM_writeByte(EEPROM_addressWrite, DTC_P002) == SUCCESS){
-				EEPROM_addressWrite++;
-				g_temperatureLogged = 1;
-			}
-			_delay_ms(10);
-		}
-	}
-}
-
-/*
- * Function: CONTROL_sendFaults
- * -----------------------------
- * Reads fault codes from EEPROM and sends them to the controller via UART.
- */
-void CONTROL_sendFaults(void)
-{
-	uint8 faultCode = 0;
-	EEPROM_addressRead = 0x0000;
-
-	while(EEPROM_addressRead <= EEPROM_addressWrite)
-	{
-		if(EEPROM_readByte(EEPROM_addressRead, &faultCode) == SUCCESS)
-		{
-			if(faultCode == 0xFF || faultCode == 0x00) {
-				break;  // Empty memory location
-			}
-			UART_sendByte(faultCode);
-			while(UART_recieveByte() != ACK);
-		}
-		else {
-			break;  // Communication error
-		}
-		EEPROM_addressRead++;
-		_delay_ms(10);
-	}
-
-	/* End of transmission */
-	UART_sendByte(END_BYTE);
-	while(UART_recieveByte() != ACK);
-
-	/* Reset if EEPROM is full */
-	if(EEPROM_addressWrite > EEPROM_MAX_ADDRESS)
-	{
-		EEPROM_addressWrite = 0x0000;
-	}
-}
+/******************************************************************************
+ *
+ * Project: Smart_Home
+ *
+ * File Name: Control_APP.c
+ *
+ * Author: Kerolous_Labib_Georgy
+ *
+ * Description:
+ * ------------
+ * This file implements the main control logic for a Smart Home system.
+ * It monitors temperature and distance sensors, controls DC motors (windows),
+ * detects system faults, and communicates with another module via UART.
+ *
+ * The HMI link never blocks the loop: every command comes in a request frame
+ * and is answered at once with a response frame carrying the same correlation
+ * id, a lost frame is retried by the HMI. The response of the last command
+ * that changes something is kept, a retry of that request gets it again
+ * instead of running the command twice. The HMI may pipeline several
+ * requests, each one is answered on its own so the order does not matter.
+ * Frames are queued per channel and sent by priority, the fault log export
+ * (bulk channel) never delays a response or a telemetry frame by more than
+ * one frame. The export is pulled by the HMI one window of LOG_DATA frames at
+ * a time, so it never sends more than the HMI asked for. The loop is only
+ * held by the link while a request is processed and when the baud rate
+ * changes (the transmit buffer drains first).
+ *
+ * Several Control ECUs can share the line with one HMI: each one is built with
+ * its own NODE_ADDRESS and only answers while the HMI addresses it (9-bit
+ * multi-drop mode, see uart.h). The link then stays at the base rate, the
+ * training and the rate negotiation are point-to-point only.
+ *
+ * A diagnostic tester can use the same link with UDS-style services
+ * (ReadDataByIdentifier, ReadDTCInformation, ClearDiagnosticInformation), see
+ * diag.h. The DTCs are the logged fault codes, with a status byte and an
+ * occurrence counter kept by the journal until the next clear. The checks of
+ * a fault are debounced and its status follows the pending, confirmed and
+ * aging rules of dtc.h, a monitoring session being one operation cycle. A
+ * fault is logged once per episode, while it stays present its detections and
+ * last seen time are only counted in its slot of the journal.
+ *
+ * The faults are checked by the rule table of fault_rules.h: every rule
+ * compares a signal (temperature or distance) to its threshold, with its own
+ * hysteresis and debounce count, for one fault code. The table is kept in the
+ * internal EEPROM and edited from the HMI with READ_RULE and WRITE_RULE, the
+ * defaults of g_defaultRules are used until one was written.
+ *
+ * The faults are logged in a wear-leveled journal (see fault_log.h) that keeps
+ * its place across power cycles and spreads the writes over the whole EEPROM,
+ * the wear of its pages is read with the READ_WEAR command. CLEAR_DTC empties
+ * it in one write, or erases every page with page writes and reports the
+ * progress in CLEAR_PROGRESS frames on the bulk channel, at most one every
+ * CLEAR_PROGRESS_MS and the last one when the erase is over. The HMI reads
+ * the progress with CLEAR_DTC as well, so a lost frame is made up for.
+ *
+ * FIND_FAULTS looks a time range up in the time index of the journal (minutes
+ * of operation, kept across power cycles), the faults of the current run by
+ * default.
+ *
+ * A tester on the I2C bus (TWI slave, see twi.h) reads the same data without
+ * using the HMI link: the registers hold the data of every DID in ID order,
+ * then the status byte of each DTC, refreshed every SENSE_PERIOD_MS.
+ *
+ *******************************************************************************/
+
+#include <avr/io.h>
+#include <util/delay.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include <string.h>
+#include "uart.h"
+#include "dc_motor.h"
+#include "ultrasonic.h"
+#include "lm35_sensor.h"
+#include "twi.h"
+#include "external_eeprom.h"
+#include "adc.h"
+#include "gpio.h"
+#include "sw_timer.h"
+#include "frame.h"
+#include "autobaud.h"
+#include "diag.h"
+#include "fault_log.h"
+#include "dtc.h"
+#include "fault_rules.h"
+
+/*******************************************************************************
+ *                                  Definitions                                *
+ *******************************************************************************/
+
+/* Commands carried by the request frames (must match the HMI) */
+#define START_MONITORING     1
+#define DISPLAY_VALUES       2
+#define DETECT_FAULTS        3
+#define STOP_MONITORING      4
+#define READ_THRESHOLDS      5
+#define READ_SUMMARY         6
+#define EXPORT_FAULTS        7
+#define READ_DIDS            8
+#define READ_WEAR            9
+#define CLEAR_DTC            10
+#define FIND_FAULTS          11
+#define READ_RULE            12
+#define WRITE_RULE           13
+
+/* Request and response payloads: command first, then
+ *   DISPLAY_VALUES response : distance high/low, temperature, win1, win2
+ *   READ_THRESHOLDS response: threshold of the first rule on the temperature and on the
+ *                             distance (0 without a rule, 255 at most)
+ *   READ_SUMMARY response   : monitoring flag, faults in the journal (high/low)
+ *   EXPORT_FAULTS request   : index of the first fault (high/low), number of LOG_DATA frames wanted
+ *   EXPORT_FAULTS response  : nothing, the faults follow in LOG_DATA frames on the bulk channel
+ *   READ_DIDS request       : IDs of the data wanted (FRAME_DID_xxx, 2 bytes each)
+ *   READ_DIDS response      : ID and data of each one, unknown IDs and the ones
+ *                             that do not fit in the frame are left out
+ *   DETECT_FAULTS request   : index of the first fault (high/low), number of faults wanted
+ *   DETECT_FAULTS response  : flags, fault codes
+ *   CLEAR_DTC request       : CLEAR_QUICK, CLEAR_ERASE or CLEAR_STATUS (nothing is cleared)
+ *   CLEAR_DTC response      : CLEAR_DONE, CLEAR_STARTED (the erase goes on in the
+ *                             background) or CLEAR_FAILED (the log is kept), then
+ *                             the journal pages erased and the pages in the journal
+ *                             (2 bytes each)
+ *   FIND_FAULTS request     : first and last log time in minutes (3 bytes each),
+ *                             nothing = since this ECU started
+ *   FIND_FAULTS response    : index of the first fault, index after the last one
+ *                             (2 bytes each), log time now (3 bytes), nothing on an EEPROM error
+ *   READ_RULE request       : index of the rule (0 to FRAME_RULES_COUNT - 1)
+ *   READ_RULE response      : index, rule (FRAME_RULE_xxx layout), nothing past the table
+ *   WRITE_RULE request      : index, rule (FRAME_RULE_xxx layout)
+ *   WRITE_RULE response     : RULE_SAVED or RULE_REJECTED (not valid, or its code has a rule) */
+#define FAULTS_MORE          0x01   // More faults after the ones in this response
+#define FAULTS_MAX_COUNT     (FRAME_MAX_PAYLOAD - 2)
+#define CLEAR_QUICK          0      // Empty the log in one write
+#define CLEAR_ERASE          1      // Empty the log, then erase every journal page
+#define CLEAR_STATUS         2      // Only report the state of the erase
+#define CLEAR_DONE           0
+#define CLEAR_STARTED        1
+#define CLEAR_FAILED         2
+#define RULE_SAVED           0
+#define RULE_REJECTED        1
+
+/* Address of this node on a multi-drop line (1 to 254, set per node at build time),
+ * 0 (UART_NO_ADDRESS) for a point-to-point link with the HMI */
+#define NODE_ADDRESS              UART_NO_ADDRESS
+
+/* Link training bytes */
+#define SYNC_BYTE AUTOBAUD_SYNC_BYTE   /* Link training preamble sent by the HMI at startup */
+#define ACK 0x05
+
+/* Retried request: the response of the last command that changes something is sent
+ * again for a request with its correlation id during this time, later the id is a new request */
+#define REPLAY_WINDOW_MS          2000
+
+/* Sensing period while monitoring */
+#define SENSE_PERIOD_MS           100
+
+/* Telemetry stream limits, the maximum is what the link can carry (10 bits per UART byte)
+ * with the usual delta frame: change mask and distance */
+#define STREAM_MIN_RATE_HZ        2
+#define STREAM_TYPICAL_FRAME_SIZE (FRAME_OVERHEAD + 1 + 2)
+#define STREAM_MAX_RATE_HZ        (g_baudRates[g_baudIndex] / (10UL * STREAM_TYPICAL_FRAME_SIZE))
+
+/* Baud rate negotiation (the HMI leads it, index in FRAME_BAUD_RATES) */
+#define BAUD_MAX_INDEX            (FRAME_BAUD_RATES_COUNT - 1)  // Fastest rate supported here
+#define BAUD_CONFIRM_TIMEOUT_MS   1500   // New rate not confirmed: back to the previous one
+#define BAUD_LINK_LOST_MS         3500   // No link check at a raised rate: back to the base rate
+
+/* Fault log erase: shortest time between two CLEAR_PROGRESS frames */
+#define CLEAR_PROGRESS_MS         250
+
+/* Link training at startup: SYNC bytes timed before the main loop (up to ~16 ms each) */
+#define TRAINING_MAX_ATTEMPTS     120
+#define TRAINING_TOLERANCE        50     // Two measures must agree within 1/50 (2%)
+
+/* Software timers */
+#define TIMER_SENSE               0      // Sensor reading / fault detection period
+#define TIMER_STREAM              1      // Telemetry frame schedule
+#define TIMER_BAUD                2      // Baud rate confirmation / link check watchdog
+#define TIMER_CLEAR               3      // Fault log erase progress frames
+
+/* Diagnostic Trouble Codes (DTC) */
+#define DTC_P001 0x01 /* Distance too close */
+#define DTC_P002 0x02 /* Overheat */
+#define DTC_P003 0x03 /* Free for a new rule */
+#define DTC_P004 0x04 /* Free for a new rule */
+
+/* Diagnostic view of the DTCs: 3-byte number with the fault code in the middle
+ * byte, status bits of dtc.h */
+#define DTC_COUNT                 DTC_MAX_CODES
+#define DTC_NUMBER_HIGH           0x00
+#define DTC_NUMBER_LOW            0x00
+#define DTC_FORMAT_ISO14229       0x01
+#define DTC_GROUP_ALL             0xFFFFFFUL
+#define DTC_RECORD_OCCURRENCES    0x01   // Extended data record: occurrence counter
+#define DTC_RECORD_LAST_SEEN      0x02   // Extended data record: episodes logged (2 bytes), last detected (3 bytes)
+#define DTC_RECORD_ALL            0xFF
+
+/* ReadDTCInformation sub-functions */
+#define DTC_REPORT_COUNT_BY_MASK  0x01
+#define DTC_REPORT_BY_MASK        0x02
+#define DTC_REPORT_EXT_DATA       0x06
+#define DTC_REPORTS_COUNT         (DTC_REPORT_EXT_DATA + 1)
+
+/* TWI slave registers: data of the DIDs (offsets 0 temperature, 1 distance,
+ * 3 windows, 5 monitoring, 6 faults logged, 8 uptime, 12 fault counts,
+ * 14 loop time, 18 line errors, 20 frames dropped, 22 thresholds, 24 log cache, 28 DTC counts),
+ * then the DTC status bytes. The DID data length is the sum of FRAME_DID_SIZE_LIST
+ * (up to SLAVE_MAX_DIDS sizes, the check below fails the build past it). */
+#define SLAVE_MAX_DIDS            16
+#define SLAVE_SUM_16(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p, ...) \
+	((a) + (b) + (c) + (d) + (e) + (f) + (g) + (h) + (i) + (j) + (k) + (l) + (m) + (n) + (o) + (p))
+#define SLAVE_SUM_SIZES(...)      SLAVE_SUM_16(__VA_ARGS__)  // Expands the list into arguments first
+#define SLAVE_DIDS_LENGTH         SLAVE_SUM_SIZES(FRAME_DID_SIZE_LIST, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+#define SLAVE_REG_DTC_STATUS      SLAVE_DIDS_LENGTH
+#define SLAVE_REGS_COUNT          (SLAVE_REG_DTC_STATUS + DTC_COUNT)
+
+/* Window button pin mapping */
+#define WIN1_OPEN_PORT         PORTD_ID
+#define WIN1_OPEN_PIN          PIN2
+#define WIN1_CLOSE_PORT        PORTD_ID
+#define WIN1_CLOSE_PIN         PIN3
+
+#define WIN2_OPEN_PORT         PORTD_ID
+#define WIN2_OPEN_PIN          PIN4
+#define WIN2_CLOSE_PORT        PORTD_ID
+#define WIN2_CLOSE_PIN         PIN5
+
+/* Button states */
+typedef enum {
+	BUTTON_RELEASED,
+	BUTTON_PRESSED
+} BUTTON_STATE;
+
+/* Data identifier getter: writes the data of the DID (MSB first) */
+typedef void (*DID_GetterType)(uint8 *data);
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+volatile uint8 g_Monitoring = 0;          // System monitoring flag
+volatile uint8 g_tempValue = 0;           // Current temperature reading
+volatile uint16 g_distanceValue = 0;      // Current distance reading
+volatile uint8 g_win1_State = 0;          // Window 1 state (open/close)
+volatile uint8 g_win2_State = 0;          // Window 2 state (open/close)
+volatile uint8 g_faultCount = 0;          // Number of stored faults
+
+static uint16 g_streamPeriod_ms = 0;          // Telemetry period (0 = no subscriber)
+static uint8 g_streamRate_Hz = 0;             // Telemetry rate asked by the subscriber
+static uint8 g_streamSeq = 0;                 // Sequence number of the telemetry frames
+static uint8 g_streamLast[FRAME_TELEMETRY_LENGTH]; // Last sample sent, reference of the delta frames
+static uint8 g_streamKeyInterval = 0;         // Frames between two keyframes (one per second)
+static uint8 g_streamKeyCountdown = 0;        // Frames left before the next keyframe (0 = next one)
+static uint8 g_streamCredit = 0;              // Last sequence number the HMI can buffer
+static FRAME_ReceiverType g_frameRx;          // Receiver for frames coming from the HMI
+
+static uint8 g_replayResponse[FRAME_MAX_PAYLOAD]; // Response of the last command that changes something
+static uint8 g_replayLength = 0;              // Its length (0 = none kept)
+static uint8 g_replaySeq = 0;                 // Correlation id of its request
+static uint32 g_replayTime = 0;               // Time it was answered
+
+static boolean g_exportActive = FALSE;        // Fault log export window in progress
+static uint16 g_exportIndex = 0;              // Next fault of the export
+static uint8 g_exportFrames = 0;              // LOG_DATA frames left in the window
+static uint8 g_exportSeq = 0;                 // Correlation id of the EXPORT_FAULTS request
+static uint8 g_eraseSeq = 0;                  // Sequence number of the CLEAR_PROGRESS frames
+static boolean g_eraseEnd = FALSE;            // The last CLEAR_PROGRESS frame is still to be sent
+
+static UART_BaudRateType g_baudRates[FRAME_BAUD_RATES_COUNT] = FRAME_BAUD_RATES;  // Scaled by the training
+static uint8 g_baudIndex = 0;                 // Current baud rate
+static uint8 g_baudPrevious = 0;              // Last confirmed rate, used if the new one fails
+static boolean g_baudConfirmed = TRUE;        // The HMI checked the link at the current rate
+static uint16 g_lineErrors = 0;               // FE + DOR + PE count at the last link check
+
+uint8 EEPROM_byte;                            // EEPROM buffer
+
+static const uint8 g_dtcCodes[DTC_COUNT] = { DTC_P001, DTC_P002, DTC_P003, DTC_P004 };
+
+/* Build check: the DTC counts DID has one byte per fault code of this ECU */
+typedef char DTC_COUNT_CHECK[(FRAME_FAULT_CODES_COUNT == DTC_COUNT) ? 1 : -1];
+
+static uint16 g_loopLast_ms = 0;              // Duration of the last main loop pass
+static uint16 g_loopMax_ms = 0;               // Longest main loop pass since startup
+
+static volatile uint8 g_slaveRegisters[SLAVE_REGS_COUNT];  // Read by the TWI interrupt
+
+/*******************************************************************************
+ *                           Configuration Structs                             *
+ *******************************************************************************/
+
+/* UART communication settings */
+UART_ConfigType UART_Config = {
+	.bit_data = (NODE_ADDRESS != UART_NO_ADDRESS) ? UART_9_BIT_DATA : UART_8_BIT_DATA,  // 9th bit marks the addresses
+	.parity = UART_PARITY_DISABLED,
+	.stop_bit = UART_ONE_STOP_BIT,
+	.baud_rate = 9600
+};
+
+/* I2C (TWI) configuration for EEPROM communication */
+TWI_ConfigType TWI_Config = {
+	.address = 0X01,
+	.bit_rate = TWI_FAST_MODE
+};
+
+/* External EEPROM holding the fault journal (see external_eeprom.h for the other parts) */
+EEPROM_DeviceType EEPROM_Device = EEPROM_24C16(1);
+
+/* ADC configuration for analog sensors (temperature) */
+ADC_typeConfig ADC_config = {
+	.reference = ADC_REF_AVCC,
+	.prescaler = ADC_PRESCALER_64
+};
+
+/* DC Motor configuration (Window 1) */
+MOTOR_typeConfig MOTOR1_typeconfig = {
+	.PORT_ID = PORTB_ID,
+	.IN1_ID = PIN0,
+	.IN2_ID = PIN1,
+	.EN_ID = PIN3
+};
+
+/* DC Motor configuration (Window 2) */
+MOTOR_typeConfig MOTOR2_typeconfig = {
+	.PORT_ID = PORTB_ID,
+	.IN1_ID = PIN4,
+	.IN2_ID = PIN5,
+	.EN_ID = PIN3
+};
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+void CONTROL_processCommand(uint8 keyValue);
+void CONTROL_processFrame(const FRAME_Type *frame);
+void CONTROL_processRequest(const FRAME_Type *frame);
+boolean CONTROL_changesState(const FRAME_Type *frame);
+boolean CONTROL_readFault(uint16 index, uint8 *faultCode);
+void CONTROL_subscribe(uint8 rate_Hz);
+void CONTROL_setBaud(uint8 index);
+void CONTROL_baudRequest(uint8 index);
+void CONTROL_linkCheck(void);
+void CONTROL_baudFallback(void);
+void CONTROL_linkTraining(void);
+void CONTROL_sendTelemetry(void);
+void CONTROL_exportFaults(void);
+boolean CONTROL_clearFaults(boolean erase);
+void CONTROL_eraseFaults(void);
+void CONTROL_updateSlaveRegisters(void);
+uint8 CONTROL_diagReadDid(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength);
+uint8 CONTROL_diagReadDtc(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength);
+uint8 CONTROL_diagClearDtc(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength);
+uint8 CONTROL_dtcCountByMask(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength);
+uint8 CONTROL_dtcByMask(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength);
+uint8 CONTROL_dtcExtData(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength);
+uint8 CONTROL_dtcStatus(uint8 dtc);
+uint8 CONTROL_dtcOccurrences(uint8 dtc);
+uint8 CONTROL_readDid(uint16 id, uint8 *data, uint8 room);
+void CONTROL_didTemperature(uint8 *data);
+void CONTROL_didDistance(uint8 *data);
+void CONTROL_didWindows(uint8 *data);
+void CONTROL_didMonitoring(uint8 *data);
+void CONTROL_didFaultsLogged(uint8 *data);
+void CONTROL_didUptime(uint8 *data);
+void CONTROL_didFaultCounts(uint8 *data);
+void CONTROL_didLoopTime(uint8 *data);
+void CONTROL_didLineErrors(uint8 *data);
+void CONTROL_didFramesDropped(uint8 *data);
+void CONTROL_didThresholds(uint8 *data);
+void CONTROL_didLogCache(uint8 *data);
+void CONTROL_didDtcCounts(uint8 *data);
+uint8 CONTROL_threshold(uint8 signal);
+void CONTROL_winState(void);
+void detectFaults(void);
+void readSensors(void);
+
+/*******************************************************************************
+ *                           Diagnostic Tables (flash)                         *
+ *******************************************************************************/
+
+/* Services indexed by SID - DIAG_SID_FIRST */
+static const DIAG_ServiceType g_diagServices[DIAG_SID_COUNT] PROGMEM = {
+	[DIAG_SID_CLEAR_DTC - DIAG_SID_FIRST] = CONTROL_diagClearDtc,
+	[DIAG_SID_READ_DTC - DIAG_SID_FIRST]  = CONTROL_diagReadDtc,
+	[DIAG_SID_READ_DID - DIAG_SID_FIRST]  = CONTROL_diagReadDid
+};
+
+/* ReadDTCInformation reports indexed by sub-function */
+static const DIAG_ServiceType g_dtcReports[DTC_REPORTS_COUNT] PROGMEM = {
+	[DTC_REPORT_COUNT_BY_MASK] = CONTROL_dtcCountByMask,
+	[DTC_REPORT_BY_MASK]       = CONTROL_dtcByMask,
+	[DTC_REPORT_EXT_DATA]      = CONTROL_dtcExtData
+};
+
+/* Data identifier registry: getters and data sizes indexed by DID - FRAME_DID_FIRST */
+static const DID_GetterType g_didGetters[FRAME_DIDS_COUNT] PROGMEM = {
+	[FRAME_DID_TEMPERATURE - FRAME_DID_FIRST]    = CONTROL_didTemperature,
+	[FRAME_DID_DISTANCE - FRAME_DID_FIRST]       = CONTROL_didDistance,
+	[FRAME_DID_WINDOWS - FRAME_DID_FIRST]        = CONTROL_didWindows,
+	[FRAME_DID_MONITORING - FRAME_DID_FIRST]     = CONTROL_didMonitoring,
+	[FRAME_DID_FAULTS_LOGGED - FRAME_DID_FIRST]  = CONTROL_didFaultsLogged,
+	[FRAME_DID_UPTIME - FRAME_DID_FIRST]         = CONTROL_didUptime,
+	[FRAME_DID_FAULT_COUNTS - FRAME_DID_FIRST]   = CONTROL_didFaultCounts,
+	[FRAME_DID_LOOP_TIME - FRAME_DID_FIRST]      = CONTROL_didLoopTime,
+	[FRAME_DID_LINE_ERRORS - FRAME_DID_FIRST]    = CONTROL_didLineErrors,
+	[FRAME_DID_FRAMES_DROPPED - FRAME_DID_FIRST] = CONTROL_didFramesDropped,
+	[FRAME_DID_THRESHOLDS - FRAME_DID_FIRST]     = CONTROL_didThresholds,
+	[FRAME_DID_LOG_CACHE - FRAME_DID_FIRST]      = CONTROL_didLogCache,
+	[FRAME_DID_DTC_COUNTS - FRAME_DID_FIRST]     = CONTROL_didDtcCounts
+};
+static const uint8 g_didSizes[FRAME_DIDS_COUNT] PROGMEM = FRAME_DID_SIZES;
+
+/* Build check: one size per DID and all of them in SLAVE_DIDS_LENGTH, so the DID data
+ * filled by CONTROL_updateSlaveRegisters() always fits in its registers */
+typedef char SLAVE_DIDS_CHECK[(sizeof((uint8[])FRAME_DID_SIZES) == FRAME_DIDS_COUNT &&
+                               FRAME_DIDS_COUNT <= SLAVE_MAX_DIDS) ? 1 : -1];
+
+/* Fault rules used until a table is written from the HMI */
+static const RULE_Type g_defaultRules[RULE_MAX_RULES] PROGMEM = {
+	{ FRAME_SIGNAL_DISTANCE,    FRAME_COMPARE_BELOW, 10, 2, 5, DTC_P001 },  // Closer than 10 cm
+	{ FRAME_SIGNAL_TEMPERATURE, FRAME_COMPARE_ABOVE, 90, 2, 5, DTC_P002 },  // Above 90 °C
+	{ FRAME_SIGNAL_NONE,        FRAME_COMPARE_BELOW, 0,  0, 1, DTC_P003 },
+	{ FRAME_SIGNAL_NONE,        FRAME_COMPARE_BELOW, 0,  0, 1, DTC_P004 }
+};
+
+/*******************************************************************************
+ *                                main Function                                *
+ *******************************************************************************/
+int main(void){
+
+	/* === Configure button pins as inputs === */
+	GPIO_setupPinDirection(WIN1_OPEN_PORT, WIN1_OPEN_PIN, PIN_INPUT);
+	GPIO_setupPinDirection(WIN1_CLOSE_PORT, WIN1_CLOSE_PIN, PIN_INPUT);
+	GPIO_setupPinDirection(WIN2_OPEN_PORT, WIN2_OPEN_PIN, PIN_INPUT);
+	GPIO_setupPinDirection(WIN2_CLOSE_PORT, WIN2_CLOSE_PIN, PIN_INPUT);
+
+	SREG |= (1 << 7); /* Enable global interrupts */
+
+	uint8 data = 0;  // Store received UART byte
+	uint32 loopStart, loopTime;
+
+	/* Initialize peripherals */
+	ADC_init(&ADC_config);
+	UART_init(&UART_Config);
+	TWI_init(&TWI_Config);
+	EEPROM_init(&EEPROM_Device);
+	SWTIMER_init();
+	LOG_init();  // Find the fault journal head left by the previous run
+	DTC_init();
+	RULE_init(g_defaultRules);
+
+	/* Match the HMI baud rate before anything is exchanged, or wait to be addressed on a shared line */
+	if(NODE_ADDRESS != UART_NO_ADDRESS){
+		UART_setAddress(NODE_ADDRESS);
+	}
+	else{
+		CONTROL_linkTraining();
+	}
+
+	FRAME_resetReceiver(&g_frameRx);
+	DIAG_init(g_diagServices);
+	CONTROL_updateSlaveRegisters();
+	TWI_slaveInit(g_slaveRegisters, SLAVE_REGS_COUNT);
+	SWTIMER_startPeriodic(TIMER_SENSE, SENSE_PERIOD_MS);
+
+	loopStart = SWTIMER_getTime();
+	for(;;){
+		/* Loop timing, read through FRAME_DID_LOOP_TIME */
+		loopTime = SWTIMER_getTime() - loopStart;
+		loopStart += loopTime;
+		g_loopLast_ms = (loopTime > 0xFFFF) ? 0xFFFF : (uint16)loopTime;
+		if(g_loopLast_ms > g_loopMax_ms){
+			g_loopMax_ms = g_loopLast_ms;
+		}
+
+		CONTROL_winState(); // Check and control windows
+
+		/* Process UART input: frames start with FRAME_SOF, other bytes are link training leftovers */
+		while(UART_dataAvailable()){
+			data = UART_recieveByte();
+
+			if(FRAME_isReceiving(&g_frameRx) || data == FRAME_SOF){
+				if(FRAME_receiveByte(&g_frameRx, data)){
+					CONTROL_processFrame(&g_frameRx.frame);
+				}
+			}
+			else{
+				CONTROL_processCommand(data);
+			}
+		}
+		FRAME_checkTimeout(&g_frameRx);  // Resync on the next SOF if a frame stopped midway
+
+		/* Segmented diagnostic responses, fault log export and erase, then the queued frames by priority */
+		DIAG_service();
+		CONTROL_exportFaults();
+		CONTROL_eraseFaults();
+		FRAME_service();
+
+		/* Internal EEPROM writes put off while it was busy with another block */
+		LOG_service();
+		RULE_service();
+
+		/* Streaming mode: push a telemetry frame on every period of the schedule */
+		if(SWTIMER_expired(TIMER_STREAM)){
+			CONTROL_sendTelemetry();
+		}
+
+		/* New baud rate not confirmed in time, or the link checks stopped */
+		if(SWTIMER_expired(TIMER_BAUD)){
+			CONTROL_baudFallback();
+		}
+
+		/* Monitoring mode: read sensors and detect faults every SENSE_PERIOD_MS */
+		if(SWTIMER_expired(TIMER_SENSE)){
+			if(g_Monitoring){
+				readSensors();
+				detectFaults();
+			}
+			CONTROL_updateSlaveRegisters();
+			LOG_getTime();  // Keeps the log time counting across the software timers wrap
+		}
+	}
+}
+
+/*******************************************************************************
+ *                           Function Definitions                              *
+ *******************************************************************************/
+
+/*
+ * Function: CONTROL_processCommand
+ * ---------------------------------
+ * Handles one byte received outside a frame. Only SYNC_BYTE is expected there
+ * (training from a restarted HMI: the rate already matches, the ACK answers it),
+ * any other byte is line noise and is ignored. A multi-drop node never
+ * answers, there is no training on a shared line.
+ */
+void CONTROL_processCommand(uint8 keyValue)
+{
+	if(keyValue == SYNC_BYTE && NODE_ADDRESS == UART_NO_ADDRESS && UART_txSpace() != 0){
+		UART_sendByte(ACK);
+	}
+}
+
+/*
+ * Function: CONTROL_processFrame
+ * -------------------------------
+ * Handles a frame received from the HMI.
+ */
+void CONTROL_processFrame(const FRAME_Type *frame)
+{
+	switch(frame->type){
+
+	case FRAME_TYPE_SUBSCRIBE:
+		if(frame->length >= 1){
+			g_streamRate_Hz = frame->payload[0];
+			CONTROL_subscribe(g_streamRate_Hz);
+
+			/* Initial credit, one frame if the HMI gives none */
+			g_streamCredit = g_streamSeq + ((frame->length >= 2 && frame->payload[1] != 0) ? frame->payload[1] : 1) - 1;
+		}
+		break;
+
+	case FRAME_TYPE_CREDIT:
+		if(frame->length >= 1){
+			g_streamCredit = frame->payload[0];
+		}
+		break;
+
+	case FRAME_TYPE_BAUD_REQUEST:
+		if(frame->length >= 1){
+			CONTROL_baudRequest(frame->payload[0]);
+		}
+		break;
+
+	case FRAME_TYPE_LINK_CHECK:
+		CONTROL_linkCheck();
+		break;
+
+	case FRAME_TYPE_REQUEST:
+		if(frame->length >= 1){
+			CONTROL_processRequest(frame);
+		}
+		break;
+
+	case FRAME_TYPE_DIAG:
+		DIAG_receiveFrame(frame);
+		break;
+
+	default:
+		break;  // Unknown frame
+	}
+}
+
+/*
+ * Function: CONTROL_processRequest
+ * ---------------------------------
+ * Executes a command request and answers at once with a response frame that
+ * carries the same correlation id. Nothing is waited for: if the command
+ * channel queue is full the response is dropped and the HMI retries. A read
+ * gives the same result when it is executed again. The response of a command
+ * that changes something is kept, and a retry of its request (same correlation
+ * id and command within REPLAY_WINDOW_MS) only gets that response again: a
+ * clear is never run a second time over the faults logged since.
+ */
+void CONTROL_processRequest(const FRAME_Type *frame)
+{
+	uint8 response[FRAME_MAX_PAYLOAD];
+	uint8 length = 1;
+	uint8 count;
+	uint16 index;
+	uint16 end;
+	LOG_TimeType from;
+	LOG_TimeType to;
+	LOG_WearType wear;
+	RULE_Type rule;
+
+	if(g_replayLength != 0 && frame->seq == g_replaySeq && frame->payload[0] == g_replayResponse[0] &&
+	   SWTIMER_getTime() - g_replayTime < REPLAY_WINDOW_MS){
+		FRAME_queue(FRAME_TYPE_RESPONSE, frame->seq, g_replayResponse, g_replayLength);
+		return;
+	}
+
+	response[0] = frame->payload[0];
+
+	switch(frame->payload[0]){
+
+	case START_MONITORING:
+		Ultrasonic_init();
+		DcMotor_Init(&MOTOR1_typeconfig);
+		DcMotor_Init(&MOTOR2_typeconfig);
+		g_Monitoring = 1;
+		DTC_startCycle();  // A monitoring session is an operation cycle
+		break;
+
+	case DISPLAY_VALUES:
+		g_tempValue = LM35_getTemperature();
+		response[length++] = (uint8)(g_distanceValue >> 8);
+		response[length++] = (uint8)(g_distanceValue & 0xFF);
+		response[length++] = g_tempValue;
+		response[length++] = g_win1_State;
+		response[length++] = g_win2_State;
+		break;
+
+	case DETECT_FAULTS:
+		index = (frame->length >= 3) ? ((uint16)frame->payload[1] << 8) | frame->payload[2] : 0;
+		count = (frame->length >= 4) ? frame->payload[3] : 1;
+		if(count > FAULTS_MAX_COUNT){
+			count = FAULTS_MAX_COUNT;
+		}
+
+		response[length++] = 0;  // Flags
+		while(count != 0 && CONTROL_readFault(index, &response[length])){
+			length++;
+			index++;
+			count--;
+		}
+
+		if(CONTROL_readFault(index, &EEPROM_byte)){
+			response[1] |= FAULTS_MORE;
+		}
+		break;
+
+	case STOP_MONITORING:
+		g_Monitoring = 0;
+		DTC_endCycle();
+		break;
+
+	case READ_THRESHOLDS:
+		response[length++] = CONTROL_threshold(FRAME_SIGNAL_TEMPERATURE);
+		response[length++] = CONTROL_threshold(FRAME_SIGNAL_DISTANCE);
+		break;
+
+	case READ_SUMMARY:
+		index = LOG_count();
+		response[length++] = g_Monitoring;
+		response[length++] = (uint8)(index >> 8);
+		response[length++] = (uint8)(index & 0xFF);
+		break;
+
+	case EXPORT_FAULTS:
+		/* A retried request sends the same window again */
+		g_exportIndex = (frame->length >= 3) ? ((uint16)frame->payload[1] << 8) | frame->payload[2] : 0;
+		g_exportFrames = (frame->length >= 4 && frame->payload[3] != 0) ? frame->payload[3] : 1;
+		g_exportSeq = frame->seq;
+		g_exportActive = TRUE;
+		break;
+
+	case READ_DIDS:
+		for(index = 1; index + 1 < frame->length; index += 2){
+			length += CONTROL_readDid(((uint16)frame->payload[index] << 8) | frame->payload[index + 1],
+			                          &response[length], FRAME_MAX_PAYLOAD - length);
+		}
+		break;
+
+	case READ_WEAR:
+		/* Journal pages, head page, most worn page and its cycles, fewest cycles
+		 * (2 bytes each, nothing on an EEPROM error) */
+		if(LOG_getWear(&wear)){
+			response[length++] = (uint8)(wear.pages >> 8);
+			response[length++] = (uint8)(wear.pages & 0xFF);
+			response[length++] = (uint8)(wear.headPage >> 8);
+			response[length++] = (uint8)(wear.headPage & 0xFF);
+			response[length++] = (uint8)(wear.maxPage >> 8);
+			response[length++] = (uint8)(wear.maxPage & 0xFF);
+			response[length++] = (uint8)(wear.maxCycles >> 8);
+			response[length++] = (uint8)(wear.maxCycles & 0xFF);
+			response[length++] = (uint8)(wear.minCycles >> 8);
+			response[length++] = (uint8)(wear.minCycles & 0xFF);
+		}
+		break;
+
+	case CLEAR_DTC:
+		/* A retried erase request while the erase runs does not restart it */
+		if(LOG_isErasing()){
+			response[length++] = CLEAR_STARTED;
+		}
+		else if(frame->length >= 2 && frame->payload[1] == CLEAR_STATUS){
+			response[length++] = CLEAR_DONE;
+		}
+		else if(frame->length >= 2 && frame->payload[1] == CLEAR_ERASE){
+			response[length++] = CONTROL_clearFaults(TRUE) ? CLEAR_STARTED : CLEAR_FAILED;
+		}
+		else{
+			response[length++] = CONTROL_clearFaults(FALSE) ? CLEAR_DONE : CLEAR_FAILED;
+		}
+		index = LOG_getErasedPages();
+		response[length++] = (uint8)(index >> 8);
+		response[length++] = (uint8)(index & 0xFF);
+		response[length++] = (uint8)(LOG_getPages() >> 8);
+		response[length++] = (uint8)(LOG_getPages() & 0xFF);
+		break;
+
+	case FIND_FAULTS:
+		/* Page-grained time range from the journal time index, read with DETECT_FAULTS */
+		to = LOG_getTime();
+		from = LOG_getStartTime();
+		if(frame->length >= 7){
+			from = ((LOG_TimeType)frame->payload[1] << 16) | ((uint16)frame->payload[2] << 8) | frame->payload[3];
+			to = ((LOG_TimeType)frame->payload[4] << 16) | ((uint16)frame->payload[5] << 8) | frame->payload[6];
+		}
+		if(LOG_findRange(from, to, &index, &end)){
+			response[length++] = (uint8)(index >> 8);
+			response[length++] = (uint8)(index & 0xFF);
+			response[length++] = (uint8)(end >> 8);
+			response[length++] = (uint8)(end & 0xFF);
+			to = LOG_getTime();
+			response[length++] = (uint8)(to >> 16);
+			response[length++] = (uint8)(to >> 8);
+			response[length++] = (uint8)(to & 0xFF);
+		}
+		break;
+
+	case READ_RULE:
+		if(frame->length >= 2 && RULE_get(frame->payload[1], &rule)){
+			response[length++] = frame->payload[1];
+			RULE_pack(&rule, &response[length]);
+			length += FRAME_RULE_LENGTH;
+		}
+		break;
+
+	case WRITE_RULE:
+		/* The same rule written again by a retry is accepted again */
+		response[length] = RULE_REJECTED;
+		if(frame->length >= 2 + FRAME_RULE_LENGTH){
+			RULE_unpack(&frame->payload[2], &rule);
+			if(RULE_set(frame->payload[1], &rule)){
+				response[length] = RULE_SAVED;
+			}
+		}
+		length++;
+		break;
+
+	default:
+		break;  // Unknown command, the response still ends the transaction
+	}
+
+	if(CONTROL_changesState(frame)){
+		memcpy(g_replayResponse, response, length);
+		g_replayLength = length;
+		g_replaySeq = frame->seq;
+		g_replayTime = SWTIMER_getTime();
+	}
+	FRAME_queue(FRAME_TYPE_RESPONSE, frame->seq, response, length);
+}
+
+/*
+ * Function: CONTROL_changesState
+ * -------------------------------
+ * Returns TRUE for the requests that must not be executed twice: starting and
+ * stopping the monitoring (an operation cycle of the DTCs), clearing the log
+ * and writing a rule (an EEPROM write). Only their responses are kept, so the
+ * reads pipelined with them never push one out.
+ */
+boolean CONTROL_changesState(const FRAME_Type *frame)
+{
+	switch(frame->payload[0]){
+	case START_MONITORING:
+	case STOP_MONITORING:
+	case WRITE_RULE:
+		return TRUE;
+
+	case CLEAR_DTC:
+		return !(frame->length >= 2 && frame->payload[1] == CLEAR_STATUS);
+
+	default:
+		return FALSE;
+	}
+}
+
+/*
+ * Function: CONTROL_subscribe
+ * ----------------------------
+ * Starts (rate 2 Hz up to the link limit) or stops (rate 0) the telemetry push.
+ */
+void CONTROL_subscribe(uint8 rate_Hz)
+{
+	if(rate_Hz == 0){
+		g_streamPeriod_ms = 0;
+		SWTIMER_stop(TIMER_STREAM);
+		return;
+	}
+
+	if(rate_Hz < STREAM_MIN_RATE_HZ){
+		rate_Hz = STREAM_MIN_RATE_HZ;
+	}
+	else if(rate_Hz > STREAM_MAX_RATE_HZ){
+		rate_Hz = STREAM_MAX_RATE_HZ;
+	}
+
+	/* Round the period up so the clamped rate never exceeds the link limit */
+	g_streamPeriod_ms = (1000 + rate_Hz - 1) / rate_Hz;
+	g_streamKeyInterval = rate_Hz;
+	g_streamKeyCountdown = 0;  // The stream starts with a keyframe
+	SWTIMER_startPeriodic(TIMER_STREAM, g_streamPeriod_ms);
+}
+
+/*
+ * Function: CONTROL_setBaud
+ * --------------------------
+ * Switches the UART to a rate of FRAME_BAUD_RATES, the telemetry stream is
+ * clamped again to what the new rate can carry.
+ */
+void CONTROL_setBaud(uint8 index)
+{
+	UART_ErrorCountersType counters;
+
+	g_baudIndex = index;
+	UART_setBaudRate(g_baudRates[index]);
+	FRAME_resetReceiver(&g_frameRx);
+
+	/* Errors seen while both ends were switching do not count against the new rate */
+	UART_getErrorCounters(&counters);
+	g_lineErrors = counters.frame_errors + counters.data_overruns + counters.parity_errors;
+
+	if(g_streamPeriod_ms != 0){
+		CONTROL_subscribe(g_streamRate_Hz);
+	}
+}
+
+/*
+ * Function: CONTROL_baudRequest
+ * ------------------------------
+ * BAUD_REQUEST: accepts the fastest rate both ECUs support, answers at the
+ * current rate then switches. The HMI must confirm with a link check at the
+ * new rate before BAUD_CONFIRM_TIMEOUT_MS.
+ * With the link queue full the request is not answered and the rate is kept,
+ * the HMI asks again on its next tick.
+ */
+void CONTROL_baudRequest(uint8 index)
+{
+	uint8 accepted = (index > BAUD_MAX_INDEX) ? BAUD_MAX_INDEX : index;
+
+	if(!FRAME_queue(FRAME_TYPE_BAUD_ACCEPT, 0, &accepted, 1)){
+		return;
+	}
+	/* The answer must be in the UART buffer before the switch, a bulk or telemetry
+	 * frame there may leave it no room yet: wait for the buffer to drain */
+	while(FRAME_queueSpace(FRAME_CHANNEL_LINK) != FRAME_QUEUE_DEPTH){
+		FRAME_service();
+	}
+
+	if(g_baudConfirmed){
+		g_baudPrevious = g_baudIndex;
+	}
+	g_baudConfirmed = FALSE;
+	CONTROL_setBaud(accepted);  // Waits until the answer left at the old rate
+	SWTIMER_start(TIMER_BAUD, BAUD_CONFIRM_TIMEOUT_MS);
+}
+
+/*
+ * Function: CONTROL_linkCheck
+ * ----------------------------
+ * LINK_CHECK: confirms the current rate and reports the line errors (FE, DOR,
+ * PE) counted since the previous check, the HMI uses them to step the rate down.
+ * Above the base rate the checks must keep coming or the link falls back.
+ */
+void CONTROL_linkCheck(void)
+{
+	UART_ErrorCountersType counters;
+	uint16 errors;
+	uint8 report;
+
+	g_baudConfirmed = TRUE;
+
+	UART_getErrorCounters(&counters);
+	errors = counters.frame_errors + counters.data_overruns + counters.parity_errors;
+	report = ((uint16)(errors - g_lineErrors) > 0xFF) ? 0xFF : (uint8)(errors - g_lineErrors);
+	g_lineErrors = errors;
+
+	FRAME_queue(FRAME_TYPE_LINK_STATUS, 0, &report, 1);
+
+	if(g_baudIndex != 0){
+		SWTIMER_start(TIMER_BAUD, BAUD_LINK_LOST_MS);
+	}
+	else{
+		SWTIMER_stop(TIMER_BAUD);
+	}
+}
+
+/*
+ * Function: CONTROL_linkTraining
+ * -------------------------------
+ * Startup autobaud: the HMI repeats SYNC_BYTE until it gets an ACK. Two SYNC
+ * bytes in a row with the same measured rate set the UART, then the ACK is sent
+ * at that rate. The negotiable rates are scaled by the same ratio, so a clock
+ * difference between the ECUs is compensated on all of them.
+ * Without SYNC bytes (HMI not training) the configured rate is kept.
+ */
+void CONTROL_linkTraining(void)
+{
+	uint32 baud;
+	uint32 previous = 0;
+	uint8 attempt, i;
+
+	for(attempt = 0; attempt < TRAINING_MAX_ATTEMPTS; attempt++){
+		baud = AUTOBAUD_measure();
+
+		if(baud != 0 && previous != 0 &&
+		   baud + baud / TRAINING_TOLERANCE >= previous &&
+		   previous + previous / TRAINING_TOLERANCE >= baud){
+
+			baud = (baud + previous) / 2;
+			for(i = FRAME_BAUD_RATES_COUNT - 1; i > 0; i--){
+				g_baudRates[i] = (g_baudRates[i] / 100) * baud / (g_baudRates[0] / 100);
+			}
+			g_baudRates[0] = baud;
+
+			UART_setBaudRate(baud);
+			UART_sendByte(ACK);
+			return;
+		}
+		previous = baud;
+	}
+}
+
+/*
+ * Function: CONTROL_baudFallback
+ * -------------------------------
+ * A new rate was not confirmed: back to the previous one.
+ * The link checks stopped at a confirmed rate: back to the base rate, where
+ * the HMI falls back too when its checks are not answered.
+ */
+void CONTROL_baudFallback(void)
+{
+	CONTROL_setBaud(g_baudConfirmed ? 0 : g_baudPrevious);
+	g_baudConfirmed = TRUE;
+
+	if(g_baudIndex != 0){
+		SWTIMER_start(TIMER_BAUD, BAUD_LINK_LOST_MS);
+	}
+}
+
+/*
+ * Function: CONTROL_sendTelemetry
+ * --------------------------------
+ * Pushes one telemetry frame (no acknowledgment).
+ * Most samples go as a delta frame with only the fields that changed since the
+ * previous one, a timestamped keyframe with every field is sent once per second
+ * so a receiver that missed a frame resynchronizes.
+ * The sequence number lets the receiver count the frames it missed. When the
+ * telemetry channel queue is full the sample is dropped instead of
+ * blocking the loop, its sequence number is still used so the gap shows and the
+ * next frame is a keyframe.
+ * Flow control: the HMI grants credit as the last sequence number it can buffer.
+ * Out of credit, the sample is skipped without using a sequence number (nothing
+ * is lost, the next delta is still taken against the last sample sent) and the
+ * loop goes back to sensing.
+ */
+void CONTROL_sendTelemetry(void)
+{
+	uint8 sample[FRAME_TELEMETRY_LENGTH];
+	uint8 delta[FRAME_DELTA_MAX_LENGTH];
+	uint8 length;
+	uint32 time_ms;
+	uint8 seq;
+
+	if((sint8)(g_streamCredit - g_streamSeq) < 0){
+		return;  // The HMI has not consumed the previous frames yet
+	}
+
+	time_ms = SWTIMER_getTime();
+	seq = g_streamSeq++;
+	g_tempValue = LM35_getTemperature();
+
+	sample[FRAME_TELEMETRY_TIME]         = (uint8)(time_ms >> 24);
+	sample[FRAME_TELEMETRY_TIME + 1]     = (uint8)(time_ms >> 16);
+	sample[FRAME_TELEMETRY_TIME + 2]     = (uint8)(time_ms >> 8);
+	sample[FRAME_TELEMETRY_TIME + 3]     = (uint8)time_ms;
+	sample[FRAME_TELEMETRY_DISTANCE]     = (uint8)(g_distanceValue >> 8);
+	sample[FRAME_TELEMETRY_DISTANCE + 1] = (uint8)(g_distanceValue & 0xFF);
+	sample[FRAME_TELEMETRY_TEMP]         = g_tempValue;
+	sample[FRAME_TELEMETRY_WIN1]         = g_win1_State;
+	sample[FRAME_TELEMETRY_WIN2]         = g_win2_State;
+
+	if(g_streamKeyCountdown == 0){
+		if(!FRAME_queue(FRAME_TYPE_TELEMETRY, seq, sample, FRAME_TELEMETRY_LENGTH)){
+			return;  // Link saturated, retry the keyframe next period
+		}
+		g_streamKeyCountdown = g_streamKeyInterval;
+	}
+	else{
+		length = FRAME_encodeDelta(sample, g_streamLast, delta);
+		if(!FRAME_queue(FRAME_TYPE_TELEMETRY_DELTA, seq, delta, length)){
+			g_streamKeyCountdown = 0;  // Link saturated, resynchronize with a keyframe
+			return;
+		}
+	}
+
+	g_streamKeyCountdown--;
+	memcpy(g_streamLast, sample, FRAME_TELEMETRY_LENGTH);
+}
+
+/*
+ * Function: CONTROL_exportFaults
+ * -------------------------------
+ * Fault log export, runs on every loop pass: queues the next LOG_DATA frame
+ * of the window asked for by EXPORT_FAULTS (as many fault codes as a frame
+ * holds) when the bulk channel has room. The window ends after its last frame
+ * or after the frame without fault codes, which ends the log.
+ */
+void CONTROL_exportFaults(void)
+{
+	uint8 payload[FRAME_MAX_PAYLOAD];
+	uint8 length = 2;
+	uint16 index = g_exportIndex;
+
+	if(!g_exportActive || FRAME_queueSpace(FRAME_CHANNEL_BULK) == 0){
+		return;
+	}
+
+	payload[0] = (uint8)(index >> 8);
+	payload[1] = (uint8)(index & 0xFF);
+	while(length < FRAME_MAX_PAYLOAD && CONTROL_readFault(index, &payload[length])){
+		length++;
+		index++;
+	}
+
+	FRAME_queue(FRAME_TYPE_LOG_DATA, g_exportSeq, payload, length);
+	g_exportIndex = index;
+	g_exportFrames--;
+	if(length == 2 || g_exportFrames == 0){
+		g_exportActive = FALSE;  // End of the log or of the window sent
+	}
+}
+
+/*
+ * Function: CONTROL_clearFaults
+ * ------------------------------
+ * Empties the fault log (and starts erasing its pages if erase is TRUE), which
+ * also resets the DTC counters and statuses, then restarts their debounce.
+ * Returns FALSE on an EEPROM error, the log and the DTCs are kept then.
+ */
+boolean CONTROL_clearFaults(boolean erase)
+{
+	if(!(erase ? LOG_eraseStart() : LOG_clear())){
+		return FALSE;
+	}
+
+	if(erase){
+		SWTIMER_startPeriodic(TIMER_CLEAR, CLEAR_PROGRESS_MS);
+	}
+	DTC_clear();
+	return TRUE;
+}
+
+/*
+ * Function: CONTROL_eraseFaults
+ * ------------------------------
+ * Fault log erase, runs on every loop pass: erases the next journal page and
+ * sends a CLEAR_PROGRESS frame (pages erased, pages in the journal) every
+ * CLEAR_PROGRESS_MS. A progress frame that finds the bulk channel full is
+ * skipped, the one with all the pages erased waits for room since it ends
+ * the erase.
+ */
+void CONTROL_eraseFaults(void)
+{
+	uint8 payload[4];
+	uint16 erased;
+	boolean report;
+
+	if(!LOG_isErasing() && !g_eraseEnd){
+		return;
+	}
+
+	erased = LOG_eraseStep();  // All the pages once the erase is over
+	report = SWTIMER_expired(TIMER_CLEAR);
+	if(!LOG_isErasing()){
+		SWTIMER_stop(TIMER_CLEAR);
+		g_eraseEnd = TRUE;
+		report = TRUE;
+	}
+	if(!report || FRAME_queueSpace(FRAME_CHANNEL_BULK) == 0){
+		return;
+	}
+
+	payload[0] = (uint8)(erased >> 8);
+	payload[1] = (uint8)(erased & 0xFF);
+	payload[2] = (uint8)(LOG_getPages() >> 8);
+	payload[3] = (uint8)(LOG_getPages() & 0xFF);
+	FRAME_queue(FRAME_TYPE_CLEAR_PROGRESS, g_eraseSeq++, payload, 4);
+	g_eraseEnd = FALSE;
+}
+
+/*
+ * Function: readSensors
+ * ----------------------
+ * Reads distance and temperature sensors and updates global values.
+ */
+void readSensors(void)
+{
+	g_distanceValue = Ultrasonic_readDistance();
+	g_tempValue = LM35_getTemperature();
+
+	CONTROL_winState();
+}
+
+/*
+ * Function: CONTROL_winState
+ * ---------------------------
+ * Controls both windows (open/close) based on button inputs.
+ */
+void CONTROL_winState(void)
+{
+	uint8 win1_open = GPIO_readPin(WIN1_OPEN_PORT, WIN1_OPEN_PIN);
+	uint8 win1_close = GPIO_readPin(WIN1_CLOSE_PORT, WIN1_CLOSE_PIN);
+	uint8 win2_open = GPIO_readPin(WIN2_OPEN_PORT, WIN2_OPEN_PIN);
+	uint8 win2_close = GPIO_readPin(WIN2_CLOSE_PORT, WIN2_CLOSE_PIN);
+
+	/* === WINDOW 1 CONTROL === */
+	if(win1_open == BUTTON_PRESSED && win1_close == BUTTON_RELEASED){
+		DcMotor_Rotate(&MOTOR1_typeconfig, CW, 100);     // Open window
+		_delay_ms(1000);
+		DcMotor_Rotate(&MOTOR1_typeconfig, STOP, 100);
+		g_win1_State = 1;                                // Mark as open
+	}
+	else if(win1_open == BUTTON_RELEASED && win1_close == BUTTON_PRESSED){
+		DcMotor_Rotate(&MOTOR1_typeconfig, A_CW, 100);   // Close window
+		_delay_ms(1000);
+		DcMotor_Rotate(&MOTOR1_typeconfig, STOP, 100);
+		g_win1_State = 0;                                // Mark as closed
+	}
+
+	/* === WINDOW 2 CONTROL === */
+	if(win2_open == BUTTON_PRESSED && win2_close == BUTTON_RELEASED){
+		DcMotor_Rotate(&MOTOR2_typeconfig, CW, 100);
+		_delay_ms(1000);
+		DcMotor_Rotate(&MOTOR2_typeconfig, STOP, 100);
+		g_win2_State = 1;
+	}
+	else if(win2_open == BUTTON_RELEASED && win2_close == BUTTON_PRESSED){
+		DcMotor_Rotate(&MOTOR2_typeconfig, A_CW, 100);
+		_delay_ms(1000);
+		DcMotor_Rotate(&MOTOR2_typeconfig, STOP, 100);
+		g_win2_State = 0;
+	}
+}
+
+/*
+ * Function: detectFaults
+ * -----------------------
+ * Samples the signals and checks them against the fault rules in one pass,
+ * the results go to the DTC statuses, which log a new episode of a fault to
+ * EEPROM once it is debounced.
+ */
+void detectFaults(void)
+{
+	uint16 signals[FRAME_SIGNALS_COUNT];
+
+	g_distanceValue = Ultrasonic_readDistance();
+	g_tempValue = LM35_getTemperature();
+	signals[FRAME_SIGNAL_TEMPERATURE] = g_tempValue;
+	signals[FRAME_SIGNAL_DISTANCE] = g_distanceValue;
+
+	RULE_evaluate(signals);
+}
+
+/*
+ * Function: CONTROL_threshold
+ * ----------------------------
+ * Returns the threshold of the first fault rule on a signal in one byte
+ * (saturated at 255), 0 if no rule watches the signal.
+ */
+uint8 CONTROL_threshold(uint8 signal)
+{
+	uint16 threshold;
+
+	if(!RULE_getThreshold(signal, &threshold)){
+		return 0;
+	}
+	return (threshold > 0xFF) ? 0xFF : (uint8)threshold;
+}
+
+/*
+ * Function: CONTROL_readFault
+ * ----------------------------
+ * Reads the fault code logged at an index of the fault journal, 0 being the oldest.
+ * Returns FALSE past the end of the log or on a read error.
+ */
+boolean CONTROL_readFault(uint16 index, uint8 *faultCode)
+{
+	return LOG_read(index, faultCode);
+}
+
+
+/*
+ * Function: CONTROL_diagReadDid
+ * ------------------------------
+ * ReadDataByIdentifier (0x22): request DID (2 bytes) repeated, response DID
+ * then data for every supported one. Unsupported DIDs are skipped, at least
+ * one must be supported.
+ */
+uint8 CONTROL_diagReadDid(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength)
+{
+	uint16 id;
+	uint8 i;
+
+	if(length == 0 || (length % 2) != 0){
+		return DIAG_NRC_INVALID_FORMAT;
+	}
+
+	*responseLength = 0;
+	for(i = 0; i < length; i += 2){
+		id = ((uint16)request[i] << 8) | request[i + 1];
+		if(id < FRAME_DID_FIRST || id >= FRAME_DID_FIRST + FRAME_DIDS_COUNT){
+			continue;
+		}
+		if(CONTROL_readDid(id, &response[*responseLength], (DIAG_MAX_LENGTH - 1) - *responseLength) == 0){
+			return DIAG_NRC_RESPONSE_TOO_LONG;
+		}
+		*responseLength += 2 + pgm_read_byte(&g_didSizes[id - FRAME_DID_FIRST]);
+	}
+
+	return (*responseLength == 0) ? DIAG_NRC_REQUEST_OUT_OF_RANGE : DIAG_NRC_NONE;
+}
+
+/*
+ * Function: CONTROL_diagReadDtc
+ * ------------------------------
+ * ReadDTCInformation (0x19): runs the report of the sub-function, the response
+ * starts with the sub-function.
+ */
+uint8 CONTROL_diagReadDtc(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength)
+{
+	DIAG_ServiceType report = NULL_PTR;
+	uint8 nrc;
+
+	if(length == 0){
+		return DIAG_NRC_INVALID_FORMAT;
+	}
+	if(request[0] < DTC_REPORTS_COUNT){
+		report = (DIAG_ServiceType)pgm_read_word(&g_dtcReports[request[0]]);
+	}
+	if(report == NULL_PTR){
+		return DIAG_NRC_SUBFUNCTION_NOT_SUPPORTED;
+	}
+
+	response[0] = request[0];
+	nrc = report(&request[1], length - 1, &response[1], responseLength);
+	(*responseLength)++;
+	return nrc;
+}
+
+/*
+ * Function: CONTROL_dtcCountByMask
+ * ---------------------------------
+ * reportNumberOfDTCByStatusMask (0x01): request status mask, response status
+ * availability mask, DTC format and the number of DTCs matching the mask (2 bytes).
+ */
+uint8 CONTROL_dtcCountByMask(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength)
+{
+	uint8 count = 0;
+	uint8 dtc;
+
+	if(length != 1){
+		return DIAG_NRC_INVALID_FORMAT;
+	}
+
+	for(dtc = 0; dtc < DTC_COUNT; dtc++){
+		if(CONTROL_dtcStatus(dtc) & request[0]){
+			count++;
+		}
+	}
+
+	response[0] = DTC_STATUS_AVAILABLE;
+	response[1] = DTC_FORMAT_ISO14229;
+	response[2] = 0;
+	response[3] = count;
+	*responseLength = 4;
+	return DIAG_NRC_NONE;
+}
+
+/*
+ * Function: CONTROL_dtcByMask
+ * ----------------------------
+ * reportDTCByStatusMask (0x02): request status mask, response status
+ * availability mask then DTC number (3 bytes) and status of every matching DTC.
+ */
+uint8 CONTROL_dtcByMask(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength)
+{
+	uint8 index = 1;
+	uint8 status;
+	uint8 dtc;
+
+	if(length != 1){
+		return DIAG_NRC_INVALID_FORMAT;
+	}
+
+	response[0] = DTC_STATUS_AVAILABLE;
+	for(dtc = 0; dtc < DTC_COUNT; dtc++){
+		status = CONTROL_dtcStatus(dtc);
+		if(status & request[0]){
+			response[index++] = DTC_NUMBER_HIGH;
+			response[index++] = g_dtcCodes[dtc];
+			response[index++] = DTC_NUMBER_LOW;
+			response[index++] = status;
+		}
+	}
+
+	*responseLength = index;
+	return DIAG_NRC_NONE;
+}
+
+/*
+ * Function: CONTROL_dtcExtData
+ * -----------------------------
+ * reportDTCExtDataRecordByDTCNumber (0x06): request DTC number (3 bytes) and
+ * record number, response DTC number, status, then the record number and data
+ * of the occurrence counter (detections), of the last seen record (episodes
+ * logged and log time of the last detection) or of both.
+ */
+uint8 CONTROL_dtcExtData(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength)
+{
+	LOG_SlotType slot;
+	uint8 dtc;
+
+	if(length != 4){
+		return DIAG_NRC_INVALID_FORMAT;
+	}
+
+	for(dtc = 0; dtc < DTC_COUNT; dtc++){
+		if(request[0] == DTC_NUMBER_HIGH && request[1] == g_dtcCodes[dtc] && request[2] == DTC_NUMBER_LOW){
+			break;
+		}
+	}
+	if(dtc == DTC_COUNT || (request[3] != DTC_RECORD_OCCURRENCES && request[3] != DTC_RECORD_LAST_SEEN &&
+	                        request[3] != DTC_RECORD_ALL)){
+		return DIAG_NRC_REQUEST_OUT_OF_RANGE;
+	}
+
+	response[0] = request[0];
+	response[1] = request[1];
+	response[2] = request[2];
+	response[3] = CONTROL_dtcStatus(dtc);
+	*responseLength = 4;
+	if(request[3] != DTC_RECORD_LAST_SEEN){
+		response[(*responseLength)++] = DTC_RECORD_OCCURRENCES;
+		response[(*responseLength)++] = CONTROL_dtcOccurrences(dtc);
+	}
+	if(request[3] != DTC_RECORD_OCCURRENCES && LOG_getSlot(g_dtcCodes[dtc], &slot)){
+		response[(*responseLength)++] = DTC_RECORD_LAST_SEEN;
+		response[(*responseLength)++] = (uint8)(slot.episodes >> 8);
+		response[(*responseLength)++] = (uint8)slot.episodes;
+		response[(*responseLength)++] = (uint8)(slot.lastSeen >> 16);
+		response[(*responseLength)++] = (uint8)(slot.lastSeen >> 8);
+		response[(*responseLength)++] = (uint8)slot.lastSeen;
+	}
+	return DIAG_NRC_NONE;
+}
+
+/*
+ * Function: CONTROL_diagClearDtc
+ * -------------------------------
+ * ClearDiagnosticInformation (0x14): request DTC group (3 bytes), only all the
+ * DTCs (0xFFFFFF) can be cleared since they share one log. The journal is
+ * emptied in one write (LOG_clear()), the statuses and counters are reset.
+ */
+uint8 CONTROL_diagClearDtc(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength)
+{
+	if(length != 3){
+		return DIAG_NRC_INVALID_FORMAT;
+	}
+	if((((uint32)request[0] << 16) | ((uint32)request[1] << 8) | request[2]) != DTC_GROUP_ALL){
+		return DIAG_NRC_REQUEST_OUT_OF_RANGE;
+	}
+
+	if(!CONTROL_clearFaults(FALSE)){
+		return DIAG_NRC_GENERAL_PROGRAMMING_FAILURE;
+	}
+
+	*responseLength = 0;
+	return DIAG_NRC_NONE;
+}
+
+/*
+ * Function: CONTROL_dtcStatus
+ * ----------------------------
+ * Returns the diagnostic status byte of a DTC (index in g_dtcCodes).
+ */
+uint8 CONTROL_dtcStatus(uint8 dtc)
+{
+	return DTC_getStatus(g_dtcCodes[dtc]);
+}
+
+/*
+ * Function: CONTROL_dtcOccurrences
+ * ---------------------------------
+ * Returns the occurrence counter of a DTC (index in g_dtcCodes): the times it
+ * was detected, not only logged, 0xFF past 254.
+ */
+uint8 CONTROL_dtcOccurrences(uint8 dtc)
+{
+	LOG_SlotType slot;
+
+	if(!LOG_getSlot(g_dtcCodes[dtc], &slot)){
+		return 0;
+	}
+	return (slot.detections > 0xFF) ? 0xFF : (uint8)slot.detections;
+}
+
+/*
+ * Function: CONTROL_readDid
+ * --------------------------
+ * Writes the ID (2 bytes) and the data of a DID of the registry.
+ * Returns the number of bytes written, 0 if the DID is unknown or does not fit in room.
+ */
+uint8 CONTROL_readDid(uint16 id, uint8 *data, uint8 room)
+{
+	DID_GetterType getter;
+	uint8 size;
+
+	if(id < FRAME_DID_FIRST || id >= FRAME_DID_FIRST + FRAME_DIDS_COUNT){
+		return 0;
+	}
+	size = pgm_read_byte(&g_didSizes[id - FRAME_DID_FIRST]);
+	if(2 + size > room){
+		return 0;
+	}
+
+	getter = (DID_GetterType)pgm_read_word(&g_didGetters[id - FRAME_DID_FIRST]);
+	data[0] = (uint8)(id >> 8);
+	data[1] = (uint8)(id & 0xFF);
+	getter(&data[2]);
+	return 2 + size;
+}
+
+/*
+ * Function: CONTROL_updateSlaveRegisters
+ * ---------------------------------------
+ * Refreshes the registers read by the I2C testers. The values are built aside
+ * and copied with interrupts disabled between two tester transactions, so a
+ * bulk read never mixes two refreshes. Skipped while a tester is reading, the
+ * next period catches up.
+ */
+void CONTROL_updateSlaveRegisters(void)
+{
+	uint8 registers[SLAVE_REGS_COUNT];
+	DID_GetterType getter;
+	uint8 length = 0;
+	uint8 index;
+
+	for(index = 0; index < FRAME_DIDS_COUNT; index++){
+		getter = (DID_GetterType)pgm_read_word(&g_didGetters[index]);
+		getter(&registers[length]);
+		length += pgm_read_byte(&g_didSizes[index]);
+	}
+	for(index = 0; index < DTC_COUNT; index++){
+		registers[SLAVE_REG_DTC_STATUS + index] = CONTROL_dtcStatus(index);
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+		if(!TWI_slaveIsBusy()){
+			for(index = 0; index < SLAVE_REGS_COUNT; index++){
+				g_slaveRegisters[index] = registers[index];
+			}
+		}
+	}
+}
+
+/*
+ * Functions: CONTROL_didxxx
+ * --------------------------
+ * Data of the data identifiers, multi-byte values MSB first.
+ */
+void CONTROL_didTemperature(uint8 *data)
+{
+	g_tempValue = LM35_getTemperature();
+	data[0] = g_tempValue;
+}
+
+void CONTROL_didDistance(uint8 *data)
+{
+	data[0] = (uint8)(g_distanceValue >> 8);
+	data[1] = (uint8)(g_distanceValue & 0xFF);
+}
+
+void CONTROL_didWindows(uint8 *data)
+{
+	data[0] = g_win1_State;
+	data[1] = g_win2_State;
+}
+
+void CONTROL_didMonitoring(uint8 *data)
+{
+	data[0] = g_Monitoring;
+}
+
+void CONTROL_didFaultsLogged(uint8 *data)
+{
+	uint16 count = LOG_count();
+
+	data[0] = (uint8)(count >> 8);
+	data[1] = (uint8)(count & 0xFF);
+}
+
+void CONTROL_didUptime(uint8 *data)
+{
+	uint32 time_ms = SWTIMER_getTime();
+
+	data[0] = (uint8)(time_ms >> 24);
+	data[1] = (uint8)(time_ms >> 16);
+	data[2] = (uint8)(time_ms >> 8);
+	data[3] = (uint8)time_ms;
+}
+
+void CONTROL_didFaultCounts(uint8 *data)
+{
+	data[0] = CONTROL_dtcOccurrences(0);
+	data[1] = CONTROL_dtcOccurrences(1);
+}
+
+void CONTROL_didLoopTime(uint8 *data)
+{
+	data[0] = (uint8)(g_loopLast_ms >> 8);
+	data[1] = (uint8)(g_loopLast_ms & 0xFF);
+	data[2] = (uint8)(g_loopMax_ms >> 8);
+	data[3] = (uint8)(g_loopMax_ms & 0xFF);
+}
+
+void CONTROL_didLineErrors(uint8 *data)
+{
+	UART_ErrorCountersType counters;
+	uint16 errors;
+
+	UART_getErrorCounters(&counters);
+	errors = counters.frame_errors + counters.data_overruns + counters.parity_errors;
+	data[0] = (uint8)(errors >> 8);
+	data[1] = (uint8)(errors & 0xFF);
+}
+
+void CONTROL_didFramesDropped(uint8 *data)
+{
+	data[0] = (uint8)(g_frameRx.dropped >> 8);
+	data[1] = (uint8)(g_frameRx.dropped & 0xFF);
+}
+
+void CONTROL_didThresholds(uint8 *data)
+{
+	data[0] = CONTROL_threshold(FRAME_SIGNAL_TEMPERATURE);
+	data[1] = CONTROL_threshold(FRAME_SIGNAL_DISTANCE);
+}
+
+void CONTROL_didLogCache(uint8 *data)
+{
+	LOG_CacheStatsType stats;
+
+	LOG_getCacheStats(&stats);
+	data[0] = (uint8)(stats.hits >> 8);
+	data[1] = (uint8)(stats.hits & 0xFF);
+	data[2] = (uint8)(stats.misses >> 8);
+	data[3] = (uint8)(stats.misses & 0xFF);
+}
+
+void CONTROL_didDtcCounts(uint8 *data)
+{
+	uint8 dtc;
+
+	for(dtc = 0; dtc < DTC_COUNT; dtc++){
+		data[dtc] = CONTROL_dtcOccurrences(dtc);
+	}
+}
@@ -0,0 +1,358 @@
+/******************************************************************************
+ *
+ * Module: DIAG
+ *
+ * File Name: diag.c
+ *
+ * Description: Source file for the UDS-style diagnostic layer of the Control ECU
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include "diag.h"
+#include "sw_timer.h"
+#include <avr/pgmspace.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Segment kinds, high nibble of the PCI byte */
+#define DIAG_PCI_SINGLE                   0x0
+#define DIAG_PCI_FIRST                    0x1
+#define DIAG_PCI_CONSECUTIVE              0x2
+#define DIAG_PCI_FLOW_CONTROL             0x3
+
+/* Flow status, low nibble of a flow control PCI */
+#define DIAG_FLOW_CONTINUE                0x0
+#define DIAG_FLOW_WAIT                    0x1
+#define DIAG_FLOW_OVERFLOW                0x2
+
+/* Data bytes carried by each segment kind */
+#define DIAG_SINGLE_DATA                  (FRAME_MAX_PAYLOAD - 1)
+#define DIAG_FIRST_DATA                   (FRAME_MAX_PAYLOAD - 2)
+#define DIAG_CONSECUTIVE_DATA             (FRAME_MAX_PAYLOAD - 1)
+
+/* Highest STMIN in ms, the other values (100 us steps) are rounded up to 1 ms */
+#define DIAG_STMIN_MAX_MS                 0x7F
+
+/*******************************************************************************
+ *                                Data Types                                   *
+ *******************************************************************************/
+
+typedef enum
+{
+	DIAG_IDLE,
+	DIAG_RX_CONSECUTIVE,   /* Segmented request, waiting for its consecutive frames */
+	DIAG_TX_WAIT_FLOW,     /* Segmented response, waiting for a flow control */
+	DIAG_TX_CONSECUTIVE    /* Segmented response, sending its consecutive frames */
+}DIAG_StateType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const DIAG_ServiceType *g_services_P = NULL_PTR;  /* Flash table set by DIAG_init() */
+
+static DIAG_StateType g_state = DIAG_IDLE;
+static uint32 g_segmentTime = 0;       /* Time of the last segment sent or received */
+static uint8 g_frameSeq = 0;           /* SEQ of the diagnostic frames */
+
+static uint8 g_rxBuffer[DIAG_MAX_LENGTH];
+static uint8 g_rxLength = 0;           /* Length of the segmented request */
+static uint8 g_rxIndex = 0;            /* Bytes received so far */
+static uint8 g_rxSegment = 0;          /* Sequence number of the next consecutive frame */
+
+static uint8 g_txBuffer[DIAG_MAX_LENGTH];
+static uint8 g_txLength = 0;           /* Length of the response */
+static uint8 g_txIndex = 0;            /* Bytes sent so far */
+static uint8 g_txSegment = 0;          /* Sequence number of the next consecutive frame */
+static uint8 g_txBlockSize = 0;        /* Consecutive frames per block (0 = no limit) */
+static uint8 g_txBlockLeft = 0;        /* Consecutive frames left in the current block */
+static uint8 g_txSeparation_ms = 0;    /* Time between two consecutive frames: STMIN and one tick */
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Queue a diagnostic frame, returns FALSE if the channel is full.
+ */
+static boolean DIAG_sendSegment(const uint8 *payload, uint8 length)
+{
+	return FRAME_queue(FRAME_TYPE_DIAG, g_frameSeq++, payload, length);
+}
+
+/*
+ * Description :
+ * Send a flow control frame for a segmented request (no block limit, no delay).
+ */
+static void DIAG_sendFlowControl(uint8 status)
+{
+	uint8 payload[3];
+
+	payload[0] = (DIAG_PCI_FLOW_CONTROL << 4) | status;
+	payload[1] = 0;
+	payload[2] = 0;
+	DIAG_sendSegment(payload, 3);
+}
+
+/*
+ * Description :
+ * Send the response in g_txBuffer: a single frame, or the first frame of a
+ * segmented response whose consecutive frames follow the tester flow control.
+ * A response lost on a full channel is recovered by the tester retrying.
+ */
+static void DIAG_transmit(uint8 length)
+{
+	uint8 payload[FRAME_MAX_PAYLOAD];
+
+	g_state = DIAG_IDLE;
+
+	if(length <= DIAG_SINGLE_DATA)
+	{
+		payload[0] = (DIAG_PCI_SINGLE << 4) | length;
+		memcpy(&payload[1], g_txBuffer, length);
+		DIAG_sendSegment(payload, length + 1);
+		return;
+	}
+
+	payload[0] = (DIAG_PCI_FIRST << 4);  /* Length high nibble, always 0 up to DIAG_MAX_LENGTH */
+	payload[1] = length;
+	memcpy(&payload[2], g_txBuffer, DIAG_FIRST_DATA);
+	if(DIAG_sendSegment(payload, FRAME_MAX_PAYLOAD))
+	{
+		g_txLength = length;
+		g_txIndex = DIAG_FIRST_DATA;
+		g_txSegment = 1;
+		g_segmentTime = SWTIMER_getTime();
+		g_state = DIAG_TX_WAIT_FLOW;
+	}
+}
+
+/*
+ * Description :
+ * Dispatch a complete request to its service and send the response.
+ */
+static void DIAG_processRequest(const uint8 *request, uint8 length)
+{
+	DIAG_ServiceType service = NULL_PTR;
+	uint8 sid = request[0];
+	uint8 dataLength = 0;
+	uint8 nrc;
+
+	if(sid >= DIAG_SID_FIRST && sid < DIAG_SID_FIRST + DIAG_SID_COUNT && g_services_P != NULL_PTR)
+	{
+		service = (DIAG_ServiceType)pgm_read_word(&g_services_P[sid - DIAG_SID_FIRST]);
+	}
+
+	if(service == NULL_PTR)
+	{
+		nrc = DIAG_NRC_SERVICE_NOT_SUPPORTED;
+	}
+	else
+	{
+		nrc = service(&request[1], length - 1, &g_txBuffer[1], &dataLength);
+	}
+
+	if(nrc == DIAG_NRC_NONE)
+	{
+		g_txBuffer[0] = sid + DIAG_POSITIVE_RESPONSE;
+		DIAG_transmit(dataLength + 1);
+	}
+	else
+	{
+		g_txBuffer[0] = DIAG_NEGATIVE_RESPONSE;
+		g_txBuffer[1] = sid;
+		g_txBuffer[2] = nrc;
+		DIAG_transmit(3);
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Set the service table (flash, DIAG_SID_COUNT entries, NULL_PTR for an
+ * unsupported SID) and drop any message in progress.
+ */
+void DIAG_init(const DIAG_ServiceType *services_P)
+{
+	g_services_P = services_P;
+	g_state = DIAG_IDLE;
+}
+
+/*
+ * Description :
+ * Handle a FRAME_TYPE_DIAG frame received from the tester.
+ */
+void DIAG_receiveFrame(const FRAME_Type *frame)
+{
+	const uint8 *payload = frame->payload;
+	uint8 status = payload[0] & 0x0F;
+	uint8 count;
+
+	if(frame->length == 0)
+	{
+		return;
+	}
+
+	switch(payload[0] >> 4)
+	{
+	case DIAG_PCI_SINGLE:
+		if(status != 0 && status < frame->length)
+		{
+			g_state = DIAG_IDLE;  /* A new request aborts the message in progress */
+			DIAG_processRequest(&payload[1], status);
+		}
+		break;
+
+	case DIAG_PCI_FIRST:
+		if(frame->length != FRAME_MAX_PAYLOAD)
+		{
+			break;
+		}
+		if(status != 0 || payload[1] > DIAG_MAX_LENGTH)
+		{
+			DIAG_sendFlowControl(DIAG_FLOW_OVERFLOW);
+			break;
+		}
+		if(payload[1] <= DIAG_SINGLE_DATA)
+		{
+			break;  /* Must have been a single frame */
+		}
+		memcpy(g_rxBuffer, &payload[2], DIAG_FIRST_DATA);
+		g_rxLength = payload[1];
+		g_rxIndex = DIAG_FIRST_DATA;
+		g_rxSegment = 1;
+		g_segmentTime = SWTIMER_getTime();
+		g_state = DIAG_RX_CONSECUTIVE;
+		DIAG_sendFlowControl(DIAG_FLOW_CONTINUE);
+		break;
+
+	case DIAG_PCI_CONSECUTIVE:
+		if(g_state != DIAG_RX_CONSECUTIVE)
+		{
+			break;
+		}
+		count = g_rxLength - g_rxIndex;
+		if(count > DIAG_CONSECUTIVE_DATA)
+		{
+			count = DIAG_CONSECUTIVE_DATA;
+		}
+		if(status != g_rxSegment || frame->length < count + 1)
+		{
+			g_state = DIAG_IDLE;  /* Lost segment, the tester sends the request again */
+			break;
+		}
+		memcpy(&g_rxBuffer[g_rxIndex], &payload[1], count);
+		g_rxIndex += count;
+		g_rxSegment = (g_rxSegment + 1) & 0x0F;
+		g_segmentTime = SWTIMER_getTime();
+		if(g_rxIndex == g_rxLength)
+		{
+			g_state = DIAG_IDLE;
+			DIAG_processRequest(g_rxBuffer, g_rxLength);
+		}
+		break;
+
+	case DIAG_PCI_FLOW_CONTROL:
+		if(g_state != DIAG_TX_WAIT_FLOW || frame->length < 3)
+		{
+			break;
+		}
+		g_segmentTime = SWTIMER_getTime();
+		if(status == DIAG_FLOW_CONTINUE)
+		{
+			g_txBlockSize = payload[1];
+			g_txBlockLeft = payload[1];
+			g_txSeparation_ms = (payload[2] <= DIAG_STMIN_MAX_MS) ? payload[2] : 1;
+			if(g_txSeparation_ms != 0)
+			{
+				/* Two readings of the timer N ticks apart may be only N - 1 ms apart */
+				g_txSeparation_ms += SWTIMER_TICK_MS;
+			}
+			g_segmentTime -= g_txSeparation_ms;  /* First consecutive frame without delay */
+			g_state = DIAG_TX_CONSECUTIVE;
+			DIAG_service();
+		}
+		else if(status != DIAG_FLOW_WAIT)
+		{
+			g_state = DIAG_IDLE;  /* Overflow or invalid, the response is dropped */
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+/*
+ * Description :
+ * Send the consecutive frames of a segmented response as the diagnostic channel
+ * gets room and check the transport timeouts. Must be called from the main loop.
+ */
+void DIAG_service(void)
+{
+	uint8 payload[FRAME_MAX_PAYLOAD];
+	uint8 count;
+	uint32 now = SWTIMER_getTime();
+
+	switch(g_state)
+	{
+	case DIAG_RX_CONSECUTIVE:
+		if(now - g_segmentTime > DIAG_CONSECUTIVE_TIMEOUT_MS)
+		{
+			g_state = DIAG_IDLE;
+		}
+		break;
+
+	case DIAG_TX_WAIT_FLOW:
+		if(now - g_segmentTime > DIAG_FLOW_CONTROL_TIMEOUT_MS)
+		{
+			g_state = DIAG_IDLE;
+		}
+		break;
+
+	case DIAG_TX_CONSECUTIVE:
+		while(g_state == DIAG_TX_CONSECUTIVE && now - g_segmentTime >= g_txSeparation_ms &&
+		      FRAME_queueSpace(FRAME_CHANNEL_DIAG) != 0)
+		{
+			count = g_txLength - g_txIndex;
+			if(count > DIAG_CONSECUTIVE_DATA)
+			{
+				count = DIAG_CONSECUTIVE_DATA;
+			}
+			payload[0] = (DIAG_PCI_CONSECUTIVE << 4) | g_txSegment;
+			memcpy(&payload[1], &g_txBuffer[g_txIndex], count);
+			DIAG_sendSegment(payload, count + 1);
+
+			g_txIndex += count;
+			g_txSegment = (g_txSegment + 1) & 0x0F;
+			g_segmentTime = now;
+
+			if(g_txIndex == g_txLength)
+			{
+				g_state = DIAG_IDLE;
+			}
+			else if(g_txBlockSize != 0 && --g_txBlockLeft == 0)
+			{
+				g_state = DIAG_TX_WAIT_FLOW;  /* End of the block */
+			}
+
+			if(g_txSeparation_ms != 0)
+			{
+				break;  /* One consecutive frame per STMIN */
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+}
@@ -0,0 +1,107 @@
+/******************************************************************************
+ *
+ * Module: DIAG
+ *
+ * File Name: diag.h
+ *
+ * Description: Header file for the UDS-style diagnostic layer of the Control ECU.
+ *
+ * Messages: SID | PARAMETERS, answered with SID + 0x40 | DATA (positive) or
+ * 0x7F | SID | NRC (negative). The services are given by the application as a
+ * flash table indexed by SID - DIAG_SID_FIRST, so a request is dispatched in
+ * constant time whatever the number of services.
+ *
+ * Transport: messages longer than a frame are segmented ISO-TP style in
+ * FRAME_TYPE_DIAG frames, the first payload byte (PCI) gives the segment kind:
+ *   - 0x0L           : single frame, L data bytes (1 to 15)
+ *   - 0x1H LL        : first frame, 12-bit message length, then the first data bytes
+ *   - 0x2N           : consecutive frame, N = sequence number (1 to 15 then 0)
+ *   - 0x3S BS STMIN  : flow control from the receiver of a segmented message,
+ *                      S = 0 continue, 1 wait, 2 overflow; BS consecutive frames
+ *                      before the next flow control (0 = all); STMIN ms between them
+ * One message is handled at a time, a new request aborts the response in progress.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef DIAG_H_
+#define DIAG_H_
+
+#include "std_types.h"
+#include "frame.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Longest request or response, segmented over several frames */
+#define DIAG_MAX_LENGTH                   64
+
+/* Range of the service table */
+#define DIAG_SID_FIRST                    0x10
+#define DIAG_SID_COUNT                    0x30
+
+/* Service identifiers */
+#define DIAG_SID_CLEAR_DTC                0x14  /* ClearDiagnosticInformation */
+#define DIAG_SID_READ_DTC                 0x19  /* ReadDTCInformation */
+#define DIAG_SID_READ_DID                 0x22  /* ReadDataByIdentifier */
+
+#define DIAG_POSITIVE_RESPONSE            0x40  /* Added to the SID */
+#define DIAG_NEGATIVE_RESPONSE            0x7F
+
+/* Negative response codes */
+#define DIAG_NRC_NONE                     0x00  /* Positive response */
+#define DIAG_NRC_SERVICE_NOT_SUPPORTED    0x11
+#define DIAG_NRC_SUBFUNCTION_NOT_SUPPORTED 0x12
+#define DIAG_NRC_INVALID_FORMAT           0x13  /* Incorrect message length or invalid format */
+#define DIAG_NRC_RESPONSE_TOO_LONG        0x14
+#define DIAG_NRC_CONDITIONS_NOT_CORRECT   0x22
+#define DIAG_NRC_REQUEST_OUT_OF_RANGE     0x31
+#define DIAG_NRC_GENERAL_PROGRAMMING_FAILURE 0x72
+
+/* Transport timeouts: flow control awaited after a first frame or a block (N_Bs),
+ * consecutive frame awaited while a request is received (N_Cr) */
+#define DIAG_FLOW_CONTROL_TIMEOUT_MS      1000
+#define DIAG_CONSECUTIVE_TIMEOUT_MS       1000
+
+/*******************************************************************************
+ *                                Data Types                                   *
+ *******************************************************************************/
+
+/*
+ * Service handler:
+ * - request        : parameters of the request (after the SID)
+ * - length         : number of parameter bytes
+ * - response       : data of the positive response (after the SID), room for
+ *                    DIAG_MAX_LENGTH - 1 bytes
+ * - responseLength : set to the number of data bytes written
+ * Returns DIAG_NRC_NONE for a positive response, the negative response code otherwise.
+ */
+typedef uint8 (*DIAG_ServiceType)(const uint8 *request, uint8 length, uint8 *response, uint8 *responseLength);
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Set the service table (flash, DIAG_SID_COUNT entries, NULL_PTR for an
+ * unsupported SID) and drop any message in progress.
+ */
+void DIAG_init(const DIAG_ServiceType *services_P);
+
+/*
+ * Description :
+ * Handle a FRAME_TYPE_DIAG frame received from the tester.
+ */
+void DIAG_receiveFrame(const FRAME_Type *frame);
+
+/*
+ * Description :
+ * Send the consecutive frames of a segmented response as the diagnostic channel
+ * gets room and check the transport timeouts. Must be called from the main loop.
+ */
+void DIAG_service(void);
+
+#endif /* DIAG_H_ */
@@ -0,0 +1,265 @@
+/******************************************************************************
+ *
+ * Module: DTC
+ *
+ * File Name: dtc.c
+ *
+ * Description: Source file for the status of the Diagnostic Trouble Codes of the Control ECU
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include "dtc.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static sint8 g_debounce[DTC_MAX_CODES];  /* Consecutive failed (> 0) or passed (< 0) results */
+static uint8 g_passedCodes = 0;          /* Bit n: test of code n + 1 passed in this cycle */
+static boolean g_cycleActive = FALSE;    /* An operation cycle runs */
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Set the status byte and aging counter of a code in its journal slot.
+ * Returns TRUE if one of them changed.
+ */
+static boolean DTC_setStatus(uint8 faultCode, uint8 status, uint8 aging)
+{
+	LOG_SlotType slot;
+
+	LOG_getSlot(faultCode, &slot);
+	if(slot.status == status && slot.aging == aging)
+	{
+		return FALSE;
+	}
+	LOG_setStatus(faultCode, status, aging);
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Debounced failed result: log a new episode, then set the failed bits. A
+ * fault still pending from an earlier cycle is confirmed.
+ */
+static void DTC_fail(uint8 faultCode, const LOG_SlotType *slot)
+{
+	uint8 status = slot->status;
+
+	if(status & DTC_STATUS_TEST_FAILED)
+	{
+		LOG_repeat(faultCode);  /* Same episode */
+	}
+	else if(!LOG_append(faultCode))
+	{
+		return;  /* Tried again at the next failed result */
+	}
+
+	if((status & DTC_STATUS_PENDING) && !(status & DTC_STATUS_FAILED_THIS_CYCLE))
+	{
+		status |= DTC_STATUS_CONFIRMED;
+	}
+	status |= DTC_STATUS_TEST_FAILED | DTC_STATUS_FAILED_THIS_CYCLE |
+	          DTC_STATUS_PENDING | DTC_STATUS_FAILED_SINCE_CLEAR;
+	if(DTC_setStatus(faultCode, status, 0))
+	{
+		LOG_saveSlots();
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Load the statuses from the fault journal, must be called after LOG_init().
+ * No cycle is running. The status of a slot rebuilt from the journal is
+ * confirmed if the code was logged since the last clear.
+ */
+void DTC_init(void)
+{
+	LOG_SlotType slot;
+	boolean rebuilt = FALSE;
+	uint8 code;
+
+	for(code = 1; code <= DTC_MAX_CODES; code++)
+	{
+		LOG_getSlot(code, &slot);
+		if(slot.status == LOG_NO_STATUS)
+		{
+			slot.status = (slot.episodes != 0) ? (DTC_STATUS_CONFIRMED | DTC_STATUS_FAILED_SINCE_CLEAR) : 0;
+			LOG_setStatus(code, slot.status, 0);
+			rebuilt = TRUE;
+		}
+		/* A fault failed before the reset is not logged again if it is still there */
+		g_debounce[code - 1] = (slot.status & DTC_STATUS_TEST_FAILED) ? DTC_DEBOUNCE_MAX : 0;
+	}
+	if(rebuilt)
+	{
+		LOG_saveSlots();
+	}
+	g_passedCodes = 0;
+	g_cycleActive = FALSE;
+}
+
+/*
+ * Description :
+ * Start an operation cycle, nothing is done if one is already running.
+ */
+void DTC_startCycle(void)
+{
+	LOG_SlotType slot;
+	boolean changed = FALSE;
+	uint8 code;
+
+	if(g_cycleActive)
+	{
+		return;
+	}
+	g_cycleActive = TRUE;
+	g_passedCodes = 0;
+
+	for(code = 1; code <= DTC_MAX_CODES; code++)
+	{
+		LOG_getSlot(code, &slot);
+		changed |= DTC_setStatus(code, slot.status & ~DTC_STATUS_FAILED_THIS_CYCLE, slot.aging);
+	}
+	if(changed)
+	{
+		LOG_saveSlots();
+	}
+}
+
+/*
+ * Description :
+ * End the operation cycle: update the pending bits and the aging counters.
+ * Nothing is done if no cycle is running.
+ */
+void DTC_endCycle(void)
+{
+	LOG_SlotType slot;
+	boolean changed = FALSE;
+	uint8 code;
+
+	if(!g_cycleActive)
+	{
+		return;
+	}
+	g_cycleActive = FALSE;
+
+	for(code = 1; code <= DTC_MAX_CODES; code++)
+	{
+		LOG_getSlot(code, &slot);
+		if((slot.status & DTC_STATUS_FAILED_THIS_CYCLE) || !(g_passedCodes & (1 << (code - 1))))
+		{
+			continue;  /* Not a clean cycle for this code */
+		}
+
+		slot.status &= ~DTC_STATUS_PENDING;
+		if(slot.status & DTC_STATUS_CONFIRMED)
+		{
+			slot.aging++;
+			if(slot.aging >= DTC_AGING_CYCLES)
+			{
+				slot.status &= ~DTC_STATUS_CONFIRMED;  /* Healed */
+				slot.aging = 0;
+			}
+		}
+		changed |= DTC_setStatus(code, slot.status, slot.aging);
+	}
+	if(changed)
+	{
+		LOG_saveSlots();
+	}
+}
+
+/*
+ * Description :
+ * Give the result of one check of a fault code, debounced over debounce
+ * results (1 to DTC_DEBOUNCE_MAX). The test fails only once its record is
+ * logged, a failed append is tried again at the next failed result.
+ */
+void DTC_report(uint8 faultCode, boolean failed, uint8 debounce)
+{
+	LOG_SlotType slot;
+	sint8 *count;
+
+	if(faultCode < 1 || faultCode > DTC_MAX_CODES || debounce < 1 || debounce > DTC_DEBOUNCE_MAX)
+	{
+		return;
+	}
+	count = &g_debounce[faultCode - 1];
+	LOG_getSlot(faultCode, &slot);
+
+	if(failed)
+	{
+		if(*count < 0)
+		{
+			*count = 0;
+		}
+		if(*count < debounce)
+		{
+			(*count)++;
+		}
+		if(*count >= debounce)
+		{
+			DTC_fail(faultCode, &slot);
+		}
+	}
+	else
+	{
+		if(*count > 0)
+		{
+			*count = 0;
+		}
+		if(*count > -(sint8)debounce)
+		{
+			(*count)--;
+		}
+		if(*count <= -(sint8)debounce)
+		{
+			g_passedCodes |= (1 << (faultCode - 1));
+			if(DTC_setStatus(faultCode, slot.status & ~DTC_STATUS_TEST_FAILED, slot.aging))
+			{
+				LOG_saveSlots();  /* Episode over */
+			}
+		}
+	}
+}
+
+/*
+ * Description :
+ * Restart the debounce of every code, after the journal was cleared (which
+ * resets the statuses).
+ */
+void DTC_clear(void)
+{
+	uint8 i;
+
+	for(i = 0; i < DTC_MAX_CODES; i++)
+	{
+		g_debounce[i] = 0;
+	}
+	g_passedCodes = 0;
+}
+
+/*
+ * Description :
+ * Returns the status byte of a fault code, 0 for a code without a status.
+ */
+uint8 DTC_getStatus(uint8 faultCode)
+{
+	LOG_SlotType slot;
+
+	if(!LOG_getSlot(faultCode, &slot))
+	{
+		return 0;
+	}
+	return slot.status;
+}
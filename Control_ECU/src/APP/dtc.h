@@ -0,0 +1,107 @@
+/******************************************************************************
+ *
+ * Module: DTC
+ *
+ * File Name: dtc.h
+ *
+ * Description: Header file for the status of the Diagnostic Trouble Codes of
+ *              the Control ECU, after the UDS (ISO 14229) status bits.
+ *
+ * Debounce: every check of a fault gives a failed or passed result with the
+ * debounce count of its rule (see fault_rules.h). The test fails once that
+ * many consecutive results failed and passes again once as many consecutive
+ * results passed, so a single noisy sample changes nothing. A new episode of
+ * the fault (test failed again) is logged to the fault journal, the failed
+ * results while it lasts are only counted.
+ *
+ * Operation cycle: one monitoring session, from DTC_startCycle() to
+ * DTC_endCycle(). A fault that fails in a cycle is pending, and confirmed when
+ * it fails again in the next cycle (still pending, no clean cycle between).
+ * A cycle is clean for a fault when its test passed and never failed in it:
+ * the fault is no longer pending, and a confirmed fault heals (confirmed
+ * cleared) after DTC_AGING_CYCLES clean cycles in a row.
+ *
+ * The status byte and the aging counter are kept in the slot of the code in
+ * the fault journal (see fault_log.h), and saved only when one of them
+ * changes. A cycle cut by a reset is not counted.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef DTC_H_
+#define DTC_H_
+
+#include "std_types.h"
+#include "fault_log.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Fault codes with a status: 1 to DTC_MAX_CODES */
+#define DTC_MAX_CODES                     LOG_COUNTED_CODES
+
+/* Largest debounce count of a check */
+#define DTC_DEBOUNCE_MAX                  100
+
+/* Clean operation cycles in a row that heal a confirmed fault */
+#define DTC_AGING_CYCLES                  3
+
+/* Status bits */
+#define DTC_STATUS_TEST_FAILED            0x01  /* testFailed: failed at the last debounced result */
+#define DTC_STATUS_FAILED_THIS_CYCLE      0x02  /* testFailedThisOperationCycle */
+#define DTC_STATUS_PENDING                0x04  /* pendingDTC: failed in this or the last completed cycle */
+#define DTC_STATUS_CONFIRMED              0x08  /* confirmedDTC: failed in two cycles, not healed yet */
+#define DTC_STATUS_FAILED_SINCE_CLEAR     0x20  /* testFailedSinceLastClear */
+#define DTC_STATUS_AVAILABLE              (DTC_STATUS_TEST_FAILED | DTC_STATUS_FAILED_THIS_CYCLE | \
+                                           DTC_STATUS_PENDING | DTC_STATUS_CONFIRMED | \
+                                           DTC_STATUS_FAILED_SINCE_CLEAR)
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Load the statuses from the fault journal, must be called after LOG_init().
+ * No cycle is running. The status of a slot rebuilt from the journal is
+ * confirmed if the code was logged since the last clear.
+ */
+void DTC_init(void);
+
+/*
+ * Description :
+ * Start an operation cycle, nothing is done if one is already running.
+ */
+void DTC_startCycle(void);
+
+/*
+ * Description :
+ * End the operation cycle: update the pending bits and the aging counters.
+ * Nothing is done if no cycle is running.
+ */
+void DTC_endCycle(void);
+
+/*
+ * Description :
+ * Give the result of one check of a fault code, debounced over debounce
+ * results (1 to DTC_DEBOUNCE_MAX). The test fails only once its record is
+ * logged, a failed append is tried again at the next failed result.
+ */
+void DTC_report(uint8 faultCode, boolean failed, uint8 debounce);
+
+/*
+ * Description :
+ * Restart the debounce of every code, after the journal was cleared (which
+ * resets the statuses).
+ */
+void DTC_clear(void);
+
+/*
+ * Description :
+ * Returns the status byte of a fault code, 0 for a code without a status.
+ */
+uint8 DTC_getStatus(uint8 faultCode);
+
+#endif /* DTC_H_ */
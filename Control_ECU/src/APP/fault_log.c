@@ -0,0 +1,1311 @@
+/******************************************************************************
+ *
+ * Module: LOG
+ *
+ * File Name: fault_log.c
+ *
+ * Description: Source file for the wear-leveled fault journal of the Control ECU
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include "fault_log.h"
+#include "external_eeprom.h"
+#include "crc8.h"
+#include "internal_eeprom.h"
+#include "sw_timer.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Distance of a SEQ from the base sequence number past which the base is moved
+ * up, so the live pages always stay in the first half of the SEQ range */
+#define LOG_REBASE_DISTANCE               0x4000
+
+#define LOG_PAGE_ADDRESS(page)            ((EEPROM_AddressType)(page) * LOG_PAGE_SIZE)
+#define LOG_RECORD_ADDRESS(page, slot)    (LOG_PAGE_ADDRESS(page) + LOG_PAGE_HEADER + (slot) * LOG_RECORD_SIZE)
+#define LOG_INDEX_ADDRESS(page)           (g_indexAddress + (EEPROM_AddressType)(page) * LOG_INDEX_SIZE)
+
+#define LOG_CACHE_EMPTY                   0xFFFF  /* Page of a free cache line */
+
+/* Offsets in a record */
+#define LOG_RECORD_CODE                   0
+#define LOG_RECORD_CRC                    1
+#define LOG_RECORD_COMMIT                 2
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Layout, from the capacity of the memory */
+static uint16 g_pages = 0;                    /* Journal pages */
+static EEPROM_AddressType g_wearAddress = 0;  /* Wear counters */
+static EEPROM_AddressType g_indexAddress = 0; /* Time index */
+static EEPROM_AddressType g_baseAddress = 0;  /* Base sequence number and start page */
+
+static uint16 g_baseSeq = 0;       /* Pages with a SEQ before it were cleared */
+static uint16 g_nextSeq = 0;       /* SEQ of the next page opened */
+static uint16 g_startPage = 0;     /* Page opened first while the log is empty */
+static uint16 g_headPage = 0;      /* Page being filled (if g_livePages != 0) */
+static uint16 g_headSeq = 0;       /* SEQ of the head page */
+static uint8 g_headUsed = 0;       /* Committed records in the head page */
+static uint16 g_livePages = 0;     /* Pages holding the log, the head is the last one */
+static boolean g_erasing = FALSE;  /* A full erase runs */
+static uint16 g_erasedPages = 0;   /* Pages done by the full erase */
+static LOG_SlotType g_slots[LOG_COUNTED_CODES];  /* Fault codes 1 to LOG_COUNTED_CODES since the last clear */
+static LOG_TimeType g_time = 0;    /* Log time at g_timeMark_ms */
+static uint32 g_timeMark_ms = 0;   /* Software timers time of the last whole minute counted */
+static LOG_TimeType g_startTime = 0;  /* Log time at LOG_init() */
+static boolean g_mirrorPending = FALSE;  /* Mirror write refused, done again by LOG_service() */
+
+/* Page cache */
+static uint16 g_cachePage[LOG_CACHE_PAGES];                /* Page held by each line */
+static uint8 g_cacheData[LOG_CACHE_PAGES][LOG_PAGE_SIZE];
+static uint8 g_cacheOrder[LOG_CACHE_PAGES];                /* Lines from the most to the least recently used */
+static LOG_CacheStatsType g_cacheStats;
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * CRC-8 of a page header (SEQ).
+ */
+static uint8 LOG_headerCrc(const uint8 *header)
+{
+	return CRC8_update(CRC8_INIT, header, 2);
+}
+
+/*
+ * Description :
+ * CRC-8 of a record: SEQ of its page, slot number and fault code.
+ */
+static uint8 LOG_recordCrc(uint16 seq, uint8 slot, uint8 faultCode)
+{
+	uint8 data[4];
+
+	data[0] = (uint8)(seq >> 8);
+	data[1] = (uint8)seq;
+	data[2] = slot;
+	data[3] = faultCode;
+	return CRC8_update(CRC8_INIT, data, 4);
+}
+
+/*
+ * Description :
+ * Move the line at a position of the use order to another position.
+ */
+static void LOG_cacheMove(uint8 from, uint8 to)
+{
+	uint8 line = g_cacheOrder[from];
+
+	for(; from > to; from--)
+	{
+		g_cacheOrder[from] = g_cacheOrder[from - 1];
+	}
+	for(; from < to; from++)
+	{
+		g_cacheOrder[from] = g_cacheOrder[from + 1];
+	}
+	g_cacheOrder[to] = line;
+}
+
+/*
+ * Description :
+ * Position of a page in the use order, LOG_CACHE_PAGES if it is not cached.
+ */
+static uint8 LOG_cacheFind(uint16 page)
+{
+	uint8 position;
+
+	for(position = 0; position < LOG_CACHE_PAGES; position++)
+	{
+		if(g_cachePage[g_cacheOrder[position]] == page)
+		{
+			break;
+		}
+	}
+	return position;
+}
+
+/*
+ * Description :
+ * Empty the page cache.
+ */
+static void LOG_cacheInvalidate(void)
+{
+	uint8 line;
+
+	for(line = 0; line < LOG_CACHE_PAGES; line++)
+	{
+		g_cachePage[line] = LOG_CACHE_EMPTY;
+		g_cacheOrder[line] = line;
+	}
+}
+
+/*
+ * Description :
+ * Count a cache hit or miss (saturates at 0xFFFF).
+ */
+static void LOG_cacheCount(uint16 *counter)
+{
+	if(*counter != 0xFFFF)
+	{
+		(*counter)++;
+	}
+}
+
+/*
+ * Description :
+ * Returns a journal page from the cache, read in the least recently used
+ * line on a miss. Returns NULL_PTR on an EEPROM error.
+ */
+static const uint8 *LOG_cacheRead(uint16 page)
+{
+	uint8 position = LOG_cacheFind(page);
+	uint8 line;
+
+	if(position != LOG_CACHE_PAGES)
+	{
+		LOG_cacheCount(&g_cacheStats.hits);
+	}
+	else
+	{
+		LOG_cacheCount(&g_cacheStats.misses);
+		position = LOG_CACHE_PAGES - 1;
+		line = g_cacheOrder[position];
+		if(EEPROM_readBlock(LOG_PAGE_ADDRESS(page), g_cacheData[line], LOG_PAGE_SIZE) != SUCCESS)
+		{
+			g_cachePage[line] = LOG_CACHE_EMPTY;
+			return NULL_PTR;
+		}
+		g_cachePage[line] = page;
+	}
+	LOG_cacheMove(position, 0);
+	return g_cacheData[g_cacheOrder[0]];
+}
+
+/*
+ * Description :
+ * Write bytes of a journal page through the cache: the cached copy is
+ * updated once the EEPROM write is done, or dropped if the write fails. A
+ * whole page written is cached.
+ */
+static boolean LOG_writePage(uint16 page, uint8 offset, const uint8 *data, uint8 length)
+{
+	uint8 position = LOG_cacheFind(page);
+	uint8 line;
+	uint8 i;
+
+	if(EEPROM_writeBlock(LOG_PAGE_ADDRESS(page) + offset, data, length) != SUCCESS ||
+	   EEPROM_waitReady() != SUCCESS)
+	{
+		if(position != LOG_CACHE_PAGES)
+		{
+			g_cachePage[g_cacheOrder[position]] = LOG_CACHE_EMPTY;  /* Unknown content */
+			LOG_cacheMove(position, LOG_CACHE_PAGES - 1);
+		}
+		return FALSE;
+	}
+
+	if(position == LOG_CACHE_PAGES)
+	{
+		if(length != LOG_PAGE_SIZE)
+		{
+			return TRUE;
+		}
+		position = LOG_CACHE_PAGES - 1;
+		g_cachePage[g_cacheOrder[position]] = page;
+	}
+	line = g_cacheOrder[position];
+	for(i = 0; i < length; i++)
+	{
+		g_cacheData[line][offset + i] = data[i];
+	}
+	LOG_cacheMove(position, 0);
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Second phase of a record write: the COMMIT byte, once CODE and CRC are in.
+ */
+static boolean LOG_commit(uint16 page, uint8 slot)
+{
+	uint8 commit = LOG_COMMITTED;
+
+	return LOG_writePage(page, LOG_PAGE_HEADER + slot * LOG_RECORD_SIZE + LOG_RECORD_COMMIT, &commit, 1);
+}
+
+/*
+ * Description :
+ * Write the base sequence number and the start page.
+ */
+static boolean LOG_writeBase(uint16 baseSeq, uint16 startPage)
+{
+	uint8 data[4];
+
+	data[0] = (uint8)(baseSeq >> 8);
+	data[1] = (uint8)baseSeq;
+	data[2] = (uint8)(startPage >> 8);
+	data[3] = (uint8)startPage;
+	return EEPROM_writeBlock(g_baseAddress, data, 4) == SUCCESS && EEPROM_waitReady() == SUCCESS;
+}
+
+/*
+ * Description :
+ * Count one erase/write cycle of a page (saturates at 0xFFFE, 0xFFFF is an
+ * erased counter). A lost update only makes the report a cycle short.
+ */
+static void LOG_addWear(uint16 page)
+{
+	EEPROM_AddressType address = g_wearAddress + 2 * (EEPROM_AddressType)page;
+	uint8 data[2];
+	uint16 cycles;
+
+	if(EEPROM_readBlock(address, data, 2) != SUCCESS)
+	{
+		return;
+	}
+	cycles = ((uint16)data[0] << 8) | data[1];
+	if(cycles == 0xFFFF)
+	{
+		cycles = 0;
+	}
+	if(cycles < 0xFFFE)
+	{
+		cycles++;
+	}
+	data[0] = (uint8)(cycles >> 8);
+	data[1] = (uint8)cycles;
+	if(EEPROM_writeBlock(address, data, 2) == SUCCESS)
+	{
+		EEPROM_waitReady();
+	}
+}
+
+/*
+ * Description :
+ * SEQ of the page opened distance pages before the one with seq (0xFFFF is
+ * never used).
+ */
+static uint16 LOG_seqBefore(uint16 seq, uint16 distance)
+{
+	return (distance > seq) ? (uint16)(seq - distance - 1) : (uint16)(seq - distance);
+}
+
+/*
+ * Description :
+ * CRC-8 of a time index entry: SEQ of its page and TIME.
+ */
+static uint8 LOG_indexCrc(uint16 seq, const uint8 *entry)
+{
+	uint8 data[5];
+
+	data[0] = (uint8)(seq >> 8);
+	data[1] = (uint8)seq;
+	data[2] = entry[0];
+	data[3] = entry[1];
+	data[4] = entry[2];
+	return CRC8_update(CRC8_INIT, data, 5);
+}
+
+/*
+ * Description :
+ * Write the time index entry of a page just opened. A lost entry only makes
+ * the queries take the time of the page before.
+ */
+static void LOG_writeIndex(uint16 page, uint16 seq)
+{
+	uint8 entry[LOG_INDEX_SIZE];
+	LOG_TimeType time = LOG_getTime();
+
+	entry[0] = (uint8)(time >> 16);
+	entry[1] = (uint8)(time >> 8);
+	entry[2] = (uint8)time;
+	entry[3] = LOG_indexCrc(seq, entry);
+	if(EEPROM_writeBlock(LOG_INDEX_ADDRESS(page), entry, LOG_INDEX_SIZE) == SUCCESS)
+	{
+		EEPROM_waitReady();
+	}
+}
+
+/*
+ * Description :
+ * Read the time index entry of a page. Returns FALSE if the entry does not
+ * belong to the page with seq (or on an EEPROM error).
+ */
+static boolean LOG_readIndex(uint16 page, uint16 seq, LOG_TimeType *time)
+{
+	uint8 entry[LOG_INDEX_SIZE];
+
+	if(EEPROM_readBlock(LOG_INDEX_ADDRESS(page), entry, LOG_INDEX_SIZE) != SUCCESS ||
+	   entry[3] != LOG_indexCrc(seq, entry))
+	{
+		return FALSE;
+	}
+	*time = ((LOG_TimeType)entry[0] << 16) | ((uint16)entry[1] << 8) | entry[2];
+	return *time != LOG_NO_TIME;
+}
+
+/*
+ * Description :
+ * Open the next page: header and first record (CODE, CRC) in one page write,
+ * then the COMMIT of the record.
+ */
+static boolean LOG_openPage(uint8 faultCode)
+{
+	uint8 data[LOG_PAGE_SIZE];
+	uint16 page = (g_livePages == 0) ? g_startPage : (g_headPage + 1) % g_pages;
+	uint16 seq = g_nextSeq;
+	uint8 i;
+
+	for(i = 0; i < LOG_PAGE_SIZE; i++)
+	{
+		data[i] = LOG_EMPTY;
+	}
+	data[0] = (uint8)(seq >> 8);
+	data[1] = (uint8)seq;
+	data[2] = LOG_headerCrc(data);
+	data[LOG_PAGE_HEADER + LOG_RECORD_CODE] = faultCode;
+	data[LOG_PAGE_HEADER + LOG_RECORD_CRC] = LOG_recordCrc(seq, 0, faultCode);
+	if(!LOG_writePage(page, 0, data, LOG_PAGE_SIZE))
+	{
+		return FALSE;
+	}
+	LOG_addWear(page);
+	LOG_writeIndex(page, seq);
+
+	/* The page is open even if the commit fails, the next record goes in its first slot */
+	g_headPage = page;
+	g_headSeq = seq;
+	g_headUsed = 0;
+	if(g_livePages < g_pages)
+	{
+		g_livePages++;  /* Otherwise the oldest page was just reused */
+	}
+
+	g_nextSeq++;
+	if(g_nextSeq == LOG_NO_SEQ)
+	{
+		g_nextSeq = 0;
+	}
+	if((uint16)(g_nextSeq - g_baseSeq) >= LOG_REBASE_DISTANCE &&
+	   LOG_writeBase(g_nextSeq - g_pages, g_startPage))
+	{
+		g_baseSeq = g_nextSeq - g_pages;
+	}
+
+	if(!LOG_commit(page, 0))
+	{
+		return FALSE;
+	}
+	g_headUsed = 1;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Store and load a 16-bit value, MSB first.
+ */
+static void LOG_putWord(uint8 *data, uint16 value)
+{
+	data[0] = (uint8)(value >> 8);
+	data[1] = (uint8)value;
+}
+
+static uint16 LOG_getWord(const uint8 *data)
+{
+	return ((uint16)data[0] << 8) | data[1];
+}
+
+/*
+ * Description :
+ * SEQ of a page header, LOG_NO_SEQ if the page was never written or is torn.
+ */
+static uint16 LOG_pageSeq(const uint8 *header)
+{
+	if(header[2] != LOG_headerCrc(header))
+	{
+		return LOG_NO_SEQ;
+	}
+	return ((uint16)header[0] << 8) | header[1];
+}
+
+/*
+ * Description :
+ * Read the base sequence number and the start page (0 and 0 if the log was
+ * never cleared). Returns FALSE on an EEPROM error, with the values of a log
+ * never cleared.
+ */
+static boolean LOG_readBase(uint16 *baseSeq, uint16 *startPage)
+{
+	uint8 data[4];
+	uint16 page;
+
+	*baseSeq = 0;
+	*startPage = 0;
+	if(EEPROM_readBlock(g_baseAddress, data, 4) != SUCCESS)
+	{
+		return FALSE;
+	}
+	page = ((uint16)data[2] << 8) | data[3];
+	if(page < g_pages)
+	{
+		*baseSeq = ((uint16)data[0] << 8) | data[1];
+		*startPage = page;
+	}
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Count one more episode or detection of a fault code in its slot (saturates
+ * at 0xFFFF).
+ */
+static void LOG_countCode(uint8 faultCode, boolean episode)
+{
+	LOG_SlotType *slot;
+
+	if(faultCode < 1 || faultCode > LOG_COUNTED_CODES)
+	{
+		return;
+	}
+	slot = &g_slots[faultCode - 1];
+	if(episode && slot->episodes != 0xFFFF)
+	{
+		slot->episodes++;
+	}
+	if(slot->detections != 0xFFFF)
+	{
+		slot->detections++;
+	}
+	slot->lastSeen = LOG_getTime();
+}
+
+/*
+ * Description :
+ * Empty the code slots.
+ */
+static void LOG_resetSlots(void)
+{
+	uint8 i;
+
+	for(i = 0; i < LOG_COUNTED_CODES; i++)
+	{
+		g_slots[i].episodes = 0;
+		g_slots[i].detections = 0;
+		g_slots[i].lastSeen = 0;
+		g_slots[i].status = 0;
+		g_slots[i].aging = 0;
+	}
+}
+
+/*
+ * Description :
+ * Rebuild the code slots from the records in the journal, one page read each,
+ * then the time index entry of the page of the last record of each code.
+ */
+static void LOG_countRecords(void)
+{
+	uint8 data[LOG_PAGE_SIZE];
+	uint16 tail = (g_headPage + g_pages - g_livePages + 1) % g_pages;
+	uint16 lastPage[LOG_COUNTED_CODES];
+	uint16 lastSeq[LOG_COUNTED_CODES];
+	const uint8 *record;
+	uint8 code;
+	uint16 seq;
+	uint16 page;
+	uint16 i;
+	uint8 slots;
+	uint8 slot;
+
+	LOG_resetSlots();
+
+	for(i = 0; i < g_livePages; i++)
+	{
+		page = (tail + i) % g_pages;
+		if(EEPROM_readBlock(LOG_PAGE_ADDRESS(page), data, LOG_PAGE_SIZE) != SUCCESS)
+		{
+			continue;
+		}
+		seq = LOG_pageSeq(data);
+		slots = (page == g_headPage) ? g_headUsed : LOG_RECORDS_PER_PAGE;
+		for(slot = 0; slot < slots; slot++)
+		{
+			record = &data[LOG_PAGE_HEADER + slot * LOG_RECORD_SIZE];
+			code = record[LOG_RECORD_CODE];
+			if(record[LOG_RECORD_COMMIT] == LOG_COMMITTED && record[LOG_RECORD_CRC] == LOG_recordCrc(seq, slot, code) &&
+			   code >= 1 && code <= LOG_COUNTED_CODES)
+			{
+				if(g_slots[code - 1].episodes != 0xFFFF)
+				{
+					g_slots[code - 1].episodes++;
+				}
+				lastPage[code - 1] = page;
+				lastSeq[code - 1] = seq;
+			}
+		}
+	}
+
+	for(i = 0; i < LOG_COUNTED_CODES; i++)
+	{
+		g_slots[i].status = LOG_NO_STATUS;  /* Left to the caller to rebuild */
+		g_slots[i].detections = g_slots[i].episodes;
+		if(g_slots[i].episodes != 0 && !LOG_readIndex(lastPage[i], lastSeq[i], &g_slots[i].lastSeen))
+		{
+			g_slots[i].lastSeen = 0;
+		}
+	}
+}
+
+/*
+ * Description :
+ * Write the journal state to the mirror, in the background. A write refused
+ * while the internal EEPROM is busy with another block is left to LOG_service().
+ */
+static void LOG_saveMirror(void)
+{
+	uint8 mirror[LOG_MIRROR_SIZE];
+	LOG_TimeType time = LOG_getTime();
+	uint8 i;
+
+	mirror[0] = LOG_MIRROR_MAGIC;
+	LOG_putWord(&mirror[1], g_pages);
+	LOG_putWord(&mirror[3], g_baseSeq);
+	LOG_putWord(&mirror[5], g_startPage);
+	LOG_putWord(&mirror[7], g_headPage);
+	LOG_putWord(&mirror[9], g_headSeq);
+	mirror[11] = g_headUsed;
+	LOG_putWord(&mirror[12], g_livePages);
+	LOG_putWord(&mirror[14], g_nextSeq);
+	mirror[16] = (uint8)(time >> 16);
+	LOG_putWord(&mirror[17], (uint16)time);
+	for(i = 0; i < LOG_COUNTED_CODES; i++)
+	{
+		LOG_putWord(&mirror[19 + LOG_SLOT_SIZE * i], g_slots[i].episodes);
+		LOG_putWord(&mirror[21 + LOG_SLOT_SIZE * i], g_slots[i].detections);
+		mirror[23 + LOG_SLOT_SIZE * i] = (uint8)(g_slots[i].lastSeen >> 16);
+		LOG_putWord(&mirror[24 + LOG_SLOT_SIZE * i], (uint16)g_slots[i].lastSeen);
+		mirror[26 + LOG_SLOT_SIZE * i] = g_slots[i].status;
+		mirror[27 + LOG_SLOT_SIZE * i] = g_slots[i].aging;
+	}
+	mirror[LOG_MIRROR_SIZE - 1] = CRC8_update(CRC8_INIT, mirror, LOG_MIRROR_SIZE - 1);
+	g_mirrorPending = !IEEPROM_write(LOG_MIRROR_ADDRESS, mirror, LOG_MIRROR_SIZE);
+}
+
+/*
+ * Description :
+ * Load the journal state from the mirror and check it against the EEPROM: the
+ * base record, the head page filled up to the same record and the page opened
+ * next still holding an older SEQ. Returns FALSE if the mirror is invalid or
+ * behind the EEPROM.
+ */
+static boolean LOG_loadMirror(void)
+{
+	uint8 mirror[LOG_MIRROR_SIZE];
+	uint8 data[LOG_PAGE_SIZE];
+	uint16 baseSeq;
+	uint16 startPage;
+	uint16 page;
+	uint8 i;
+
+	/* Valid and written for a memory of the same size */
+	IEEPROM_read(LOG_MIRROR_ADDRESS, mirror, LOG_MIRROR_SIZE);
+	if(mirror[0] != LOG_MIRROR_MAGIC ||
+	   mirror[LOG_MIRROR_SIZE - 1] != CRC8_update(CRC8_INIT, mirror, LOG_MIRROR_SIZE - 1) ||
+	   LOG_getWord(&mirror[1]) != g_pages)
+	{
+		return FALSE;
+	}
+	g_time = ((LOG_TimeType)mirror[16] << 16) | LOG_getWord(&mirror[17]);  /* Valid even if the rest is behind */
+	g_baseSeq = LOG_getWord(&mirror[3]);
+	g_startPage = LOG_getWord(&mirror[5]);
+	g_headPage = LOG_getWord(&mirror[7]);
+	g_headSeq = LOG_getWord(&mirror[9]);
+	g_headUsed = mirror[11];
+	g_livePages = LOG_getWord(&mirror[12]);
+	g_nextSeq = LOG_getWord(&mirror[14]);
+	for(i = 0; i < LOG_COUNTED_CODES; i++)
+	{
+		g_slots[i].episodes = LOG_getWord(&mirror[19 + LOG_SLOT_SIZE * i]);
+		g_slots[i].detections = LOG_getWord(&mirror[21 + LOG_SLOT_SIZE * i]);
+		g_slots[i].lastSeen = ((LOG_TimeType)mirror[23 + LOG_SLOT_SIZE * i] << 16) |
+		                      LOG_getWord(&mirror[24 + LOG_SLOT_SIZE * i]);
+		g_slots[i].status = mirror[26 + LOG_SLOT_SIZE * i];
+		g_slots[i].aging = mirror[27 + LOG_SLOT_SIZE * i];
+	}
+	if(g_startPage >= g_pages || g_headPage >= g_pages ||
+	   g_headUsed > LOG_RECORDS_PER_PAGE || g_livePages > g_pages)
+	{
+		return FALSE;
+	}
+
+	/* No clear or rebase since the mirror was written */
+	if(!LOG_readBase(&baseSeq, &startPage) || baseSeq != g_baseSeq || startPage != g_startPage)
+	{
+		return FALSE;
+	}
+
+	/* Head page: same SEQ, last record committed and the next one not */
+	if(g_livePages != 0)
+	{
+		if(EEPROM_readBlock(LOG_PAGE_ADDRESS(g_headPage), data, LOG_PAGE_SIZE) != SUCCESS ||
+		   LOG_pageSeq(data) != g_headSeq ||
+		   (g_headUsed != 0 &&
+		    data[LOG_PAGE_HEADER + (g_headUsed - 1) * LOG_RECORD_SIZE + LOG_RECORD_COMMIT] != LOG_COMMITTED) ||
+		   (g_headUsed < LOG_RECORDS_PER_PAGE &&
+		    data[LOG_PAGE_HEADER + g_headUsed * LOG_RECORD_SIZE + LOG_RECORD_COMMIT] == LOG_COMMITTED))
+		{
+			return FALSE;
+		}
+	}
+
+	/* No page opened since the mirror was written */
+	page = (g_livePages == 0) ? g_startPage : (g_headPage + 1) % g_pages;
+	if(EEPROM_readBlock(LOG_PAGE_ADDRESS(page), data, LOG_PAGE_HEADER) != SUCCESS ||
+	   LOG_pageSeq(data) == g_nextSeq)
+	{
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Write and commit a record in the head page, or in a new page if the head
+ * page is full.
+ */
+static boolean LOG_write(uint8 faultCode)
+{
+	uint8 record[2];
+
+	if(g_livePages == 0 || g_headUsed == LOG_RECORDS_PER_PAGE)
+	{
+		return LOG_openPage(faultCode);
+	}
+
+	/* CODE and CRC, then COMMIT */
+	record[LOG_RECORD_CODE] = faultCode;
+	record[LOG_RECORD_CRC] = LOG_recordCrc(g_headSeq, g_headUsed, faultCode);
+	if(!LOG_writePage(g_headPage, LOG_PAGE_HEADER + g_headUsed * LOG_RECORD_SIZE, record, 2))
+	{
+		return FALSE;
+	}
+	if(!LOG_commit(g_headPage, g_headUsed))
+	{
+		return FALSE;
+	}
+	g_headUsed++;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Find the live pages and the head of the journal by reading the header of
+ * every page.
+ */
+static void LOG_scan(void)
+{
+	uint8 data[LOG_PAGE_SIZE];
+	uint16 seq;
+	uint16 distance;
+	uint16 minDistance = 0;
+	uint16 maxDistance = 0;
+	uint16 tailPage = 0;
+	uint16 page;
+	uint8 slot;
+
+	g_livePages = 0;
+	g_headUsed = 0;
+	LOG_readBase(&g_baseSeq, &g_startPage);
+
+	/* Oldest and newest valid pages, a torn or unreadable page is skipped */
+	for(page = 0; page < g_pages; page++)
+	{
+		if(EEPROM_readBlock(LOG_PAGE_ADDRESS(page), data, LOG_PAGE_HEADER) != SUCCESS)
+		{
+			continue;
+		}
+		seq = LOG_pageSeq(data);
+		distance = seq - g_baseSeq;
+		if(seq == LOG_NO_SEQ || distance >= 0x8000)
+		{
+			continue;  /* Never written, torn or cleared */
+		}
+		if(g_livePages == 0 || distance > maxDistance)
+		{
+			g_headPage = page;
+			g_headSeq = seq;
+			maxDistance = distance;
+		}
+		if(g_livePages == 0 || distance < minDistance)
+		{
+			tailPage = page;
+			minDistance = distance;
+		}
+		g_livePages = 1;
+	}
+
+	g_nextSeq = g_baseSeq;
+	if(g_livePages == 0)
+	{
+		return;
+	}
+	g_livePages = (g_headPage + g_pages - tailPage) % g_pages + 1;
+	g_nextSeq = g_baseSeq + maxDistance + 1;
+	if(g_nextSeq == LOG_NO_SEQ)
+	{
+		g_nextSeq = 0;
+	}
+
+	/* Head page filled up to its last committed record, a torn record after it is written over */
+	if(EEPROM_readBlock(LOG_PAGE_ADDRESS(g_headPage), data, LOG_PAGE_SIZE) == SUCCESS)
+	{
+		for(slot = LOG_RECORDS_PER_PAGE; slot != 0; slot--)
+		{
+			if(data[LOG_PAGE_HEADER + (slot - 1) * LOG_RECORD_SIZE + LOG_RECORD_COMMIT] == LOG_COMMITTED)
+			{
+				break;
+			}
+		}
+		g_headUsed = slot;
+	}
+	else
+	{
+		g_headUsed = LOG_RECORDS_PER_PAGE;  /* Unknown: go on in the next page */
+	}
+}
+
+/*
+ * Description :
+ * Time of a live page (0 being the oldest one) from the time index. A page
+ * without a valid entry takes the time of the page before it, so the times
+ * stay in order: live is moved back to the page the time was read from.
+ * Returns FALSE on an EEPROM error.
+ */
+static boolean LOG_liveTime(uint16 *live, LOG_TimeType *time)
+{
+	uint16 tail = (g_headPage + g_pages - g_livePages + 1) % g_pages;
+	uint16 seq = LOG_seqBefore(g_headSeq, g_livePages - 1 - *live);
+
+	for(;;)
+	{
+		if(LOG_readIndex((tail + *live) % g_pages, seq, time))
+		{
+			return TRUE;
+		}
+		if(*live == 0)
+		{
+			*time = 0;
+			return TRUE;
+		}
+		(*live)--;
+		seq = LOG_seqBefore(seq, 1);
+	}
+}
+
+/*
+ * Description :
+ * Binary search of the time index: number of live pages with a time up to
+ * the given one (the first live page after them has a later time).
+ * Returns FALSE on an EEPROM error.
+ */
+static boolean LOG_searchTime(LOG_TimeType time, uint16 *pages)
+{
+	LOG_TimeType pageTime;
+	uint16 low = 0;
+	uint16 high = g_livePages;
+	uint16 middle;
+	uint16 live;
+
+	while(low < high)
+	{
+		middle = low + (high - low) / 2;
+		live = middle;
+		if(!LOG_liveTime(&live, &pageTime))
+		{
+			return FALSE;
+		}
+		if(pageTime <= time)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	*pages = low;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Resume the log time after the last page opened, or after the time saved in
+ * the mirror if it is later (loaded with the mirror).
+ */
+static void LOG_resumeTime(void)
+{
+	LOG_TimeType time;
+	uint16 page;
+	uint16 seq;
+
+	if(g_livePages != 0)
+	{
+		page = g_headPage;
+		seq = g_headSeq;
+	}
+	else
+	{
+		page = (g_startPage + g_pages - 1) % g_pages;  /* Opened last before the clear, if any */
+		seq = LOG_seqBefore(g_nextSeq, 1);
+	}
+	if(LOG_readIndex(page, seq, &time) && time > g_time)
+	{
+		g_time = time;
+	}
+	g_startTime = g_time;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Find the live pages and the head of the journal, from the mirror if it
+ * matches the EEPROM, by a scan otherwise. The memory must be selected with
+ * EEPROM_init() and the global interrupts enabled (the mirror is written by
+ * its interrupt).
+ */
+void LOG_init(void)
+{
+	EEPROM_AddressType capacity = EEPROM_getCapacity();
+
+	/* Journal pages with a wear counter and an index entry each, then the base
+	 * record in a page of its own (the entries never cross a memory page) */
+	g_pages = (capacity < 3 * LOG_PAGE_SIZE) ? 1 :
+	          (uint16)((capacity - 2 * LOG_PAGE_SIZE) / (LOG_PAGE_SIZE + 2 + LOG_INDEX_SIZE));
+	if(g_pages > LOG_MAX_PAGES)
+	{
+		g_pages = LOG_MAX_PAGES;
+	}
+	g_wearAddress = LOG_PAGE_ADDRESS(g_pages);
+	g_indexAddress = (g_wearAddress + 2 * (EEPROM_AddressType)g_pages + LOG_INDEX_SIZE - 1) / LOG_INDEX_SIZE * LOG_INDEX_SIZE;
+	g_baseAddress = (LOG_INDEX_ADDRESS(g_pages) + LOG_PAGE_SIZE - 1) / LOG_PAGE_SIZE * LOG_PAGE_SIZE;
+
+	g_erasing = FALSE;  /* An erase cut by a reset is not resumed, the log was already cleared */
+	LOG_cacheInvalidate();
+	g_cacheStats.hits = 0;
+	g_cacheStats.misses = 0;
+	g_time = 0;
+	g_timeMark_ms = SWTIMER_getTime();
+
+	if(LOG_loadMirror())
+	{
+		LOG_resumeTime();
+	}
+	else
+	{
+		LOG_scan();
+		LOG_countRecords();
+		LOG_resumeTime();
+		LOG_saveMirror();
+	}
+}
+
+/*
+ * Description :
+ * Append a fault code (not LOG_BAD_RECORD) for a new episode of the fault,
+ * committed before returning, and count it in its slot. The oldest page is
+ * dropped when the journal is full. Returns FALSE on an EEPROM error or during
+ * a full erase, nothing is logged then.
+ */
+boolean LOG_append(uint8 faultCode)
+{
+	boolean logged;
+
+	if(g_erasing)
+	{
+		return FALSE;  /* Not while the journal is erased */
+	}
+
+	logged = LOG_write(faultCode);
+	if(logged)
+	{
+		LOG_countCode(faultCode, TRUE);
+	}
+	LOG_saveMirror();  /* Also after a failure, the head may have moved */
+	return logged;
+}
+
+/*
+ * Description :
+ * Count one more detection of a fault whose episode is already logged, in its
+ * slot in RAM only (nothing is written).
+ */
+void LOG_repeat(uint8 faultCode)
+{
+	LOG_countCode(faultCode, FALSE);
+}
+
+/*
+ * Description :
+ * Set the status byte and aging counter in the slot of a fault code, in RAM
+ * only (nothing is written).
+ */
+void LOG_setStatus(uint8 faultCode, uint8 status, uint8 aging)
+{
+	if(faultCode >= 1 && faultCode <= LOG_COUNTED_CODES)
+	{
+		g_slots[faultCode - 1].status = status;
+		g_slots[faultCode - 1].aging = aging;
+	}
+}
+
+/*
+ * Description :
+ * Write the code slots to the mirror, in the background. Called when an
+ * episode is over or a status changes, a reset before only loses the
+ * detections of that episode.
+ */
+void LOG_saveSlots(void)
+{
+	LOG_saveMirror();  /* Only the changed bytes are programmed */
+}
+
+/*
+ * Description :
+ * Write the mirror if a previous write was refused because the internal EEPROM
+ * was busy with another block. Must be called from the main loop.
+ */
+void LOG_service(void)
+{
+	if(g_mirrorPending && !IEEPROM_isBusy())
+	{
+		LOG_saveMirror();
+	}
+}
+
+/*
+ * Description :
+ * Read the fault logged at an index, 0 being the oldest one (LOG_BAD_RECORD if
+ * the record fails its check). Returns FALSE past the end of the log or on an
+ * EEPROM error.
+ */
+boolean LOG_read(uint16 index, uint8 *faultCode)
+{
+	uint16 tail = (g_headPage + g_pages - g_livePages + 1) % g_pages;
+	uint16 page = (tail + index / LOG_RECORDS_PER_PAGE) % g_pages;
+	uint8 slot = index % LOG_RECORDS_PER_PAGE;
+	const uint8 *data;
+	const uint8 *record;
+	uint16 seq;
+
+	if(index >= LOG_count())
+	{
+		return FALSE;
+	}
+
+	/* Whole page from the cache, the next records of the page come with it */
+	data = LOG_cacheRead(page);
+	if(data == NULL_PTR)
+	{
+		return FALSE;
+	}
+	record = &data[LOG_PAGE_HEADER + slot * LOG_RECORD_SIZE];
+	seq = ((uint16)data[0] << 8) | data[1];
+	if(data[2] != LOG_headerCrc(data) || record[LOG_RECORD_COMMIT] != LOG_COMMITTED ||
+	   record[LOG_RECORD_CRC] != LOG_recordCrc(seq, slot, record[LOG_RECORD_CODE]))
+	{
+		*faultCode = LOG_BAD_RECORD;
+	}
+	else
+	{
+		*faultCode = record[LOG_RECORD_CODE];
+	}
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Returns the number of journal pages.
+ */
+uint16 LOG_getPages(void)
+{
+	return g_pages;
+}
+
+/*
+ * Description :
+ * Returns the number of faults in the log.
+ */
+uint16 LOG_count(void)
+{
+	if(g_livePages == 0)
+	{
+		return 0;
+	}
+	return (uint16)(g_livePages - 1) * LOG_RECORDS_PER_PAGE + g_headUsed;
+}
+
+/*
+ * Description :
+ * Returns the log time: the time the previous run of the ECU stopped logging
+ * at, plus the time since LOG_init(). Must be called at least once every 49
+ * days (the wrap of the software timers time).
+ */
+LOG_TimeType LOG_getTime(void)
+{
+	uint32 minutes = (SWTIMER_getTime() - g_timeMark_ms) / LOG_MINUTE_MS;
+
+	g_timeMark_ms += minutes * LOG_MINUTE_MS;
+	g_time = (minutes >= LOG_NO_TIME - g_time) ? LOG_NO_TIME - 1 : g_time + minutes;
+	return g_time;
+}
+
+/*
+ * Description :
+ * Returns the log time at LOG_init(), the start of the current run.
+ */
+LOG_TimeType LOG_getStartTime(void)
+{
+	return g_startTime;
+}
+
+/*
+ * Description :
+ * Find the faults logged between two log times (both included) with the time
+ * index: first is the index of the first one, end the index after the last
+ * one (first = end if none). Whole pages are returned, so a few faults just
+ * outside the range may come with them. Returns FALSE on an EEPROM error.
+ */
+boolean LOG_findRange(LOG_TimeType from, LOG_TimeType to, uint16 *first, uint16 *end)
+{
+	LOG_TimeType time;
+	uint16 before = 0;
+	uint16 upTo;
+
+	*first = 0;
+	*end = 0;
+	if(g_livePages == 0 || from > to)
+	{
+		return TRUE;
+	}
+
+	/* Pages opened before from, the last one of them may still hold faults of the range */
+	if(from != 0 && !LOG_searchTime(from - 1, &before))
+	{
+		return FALSE;
+	}
+	if(!LOG_searchTime(to, &upTo))
+	{
+		return FALSE;
+	}
+	if(before != 0)
+	{
+		/* Last page opened before from, its faults may go on up to the next page
+		 * with a time of its own */
+		before--;
+		if(!LOG_liveTime(&before, &time))
+		{
+			return FALSE;
+		}
+	}
+	if(upTo > before)
+	{
+		*first = before * LOG_RECORDS_PER_PAGE;
+		*end = (upTo == g_livePages) ? LOG_count() : upTo * LOG_RECORDS_PER_PAGE;
+	}
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Returns the number of times a fault code (1 to LOG_COUNTED_CODES, 0 for the
+ * others) was logged since the last clear.
+ */
+uint16 LOG_codeCount(uint8 faultCode)
+{
+	if(faultCode < 1 || faultCode > LOG_COUNTED_CODES)
+	{
+		return 0;
+	}
+	return g_slots[faultCode - 1].episodes;
+}
+
+/*
+ * Description :
+ * Fill the slot of a fault code. Returns FALSE for a code without a slot.
+ */
+boolean LOG_getSlot(uint8 faultCode, LOG_SlotType *slot)
+{
+	if(faultCode < 1 || faultCode > LOG_COUNTED_CODES)
+	{
+		return FALSE;
+	}
+	*slot = g_slots[faultCode - 1];
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Empty the log in one write. Returns FALSE on an EEPROM error, the log is kept then.
+ */
+boolean LOG_clear(void)
+{
+	uint16 startPage = (g_livePages == 0) ? g_startPage : (g_headPage + 1) % g_pages;
+
+	if(!LOG_writeBase(g_nextSeq, startPage))
+	{
+		return FALSE;
+	}
+	g_baseSeq = g_nextSeq;
+	g_startPage = startPage;
+	g_livePages = 0;
+	LOG_cacheInvalidate();
+	g_headUsed = 0;
+	LOG_resetSlots();
+	LOG_saveMirror();
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Empty the log like LOG_clear(), then start erasing the journal pages with
+ * LOG_eraseStep(). Nothing is logged until the erase is over. Returns FALSE
+ * on an EEPROM error, the log is kept then.
+ */
+boolean LOG_eraseStart(void)
+{
+	if(!LOG_clear())
+	{
+		return FALSE;
+	}
+	g_erasing = TRUE;
+	g_erasedPages = 0;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Erase the next journal page with one page write, a page already blank is
+ * only read. Returns the number of pages erased, LOG_getPages() once the
+ * erase is over. A page that fails is tried again at the next call.
+ */
+uint16 LOG_eraseStep(void)
+{
+	uint8 data[LOG_PAGE_SIZE];
+	boolean blank = TRUE;
+	uint8 i;
+
+	if(!g_erasing)
+	{
+		return g_pages;
+	}
+	if(EEPROM_readBlock(LOG_PAGE_ADDRESS(g_erasedPages), data, LOG_PAGE_SIZE) != SUCCESS)
+	{
+		return g_erasedPages;
+	}
+	for(i = 0; i < LOG_PAGE_SIZE; i++)
+	{
+		if(data[i] != LOG_EMPTY)
+		{
+			blank = FALSE;
+			data[i] = LOG_EMPTY;
+		}
+	}
+	if(!blank)
+	{
+		if(!LOG_writePage(g_erasedPages, 0, data, LOG_PAGE_SIZE))
+		{
+			return g_erasedPages;
+		}
+		LOG_addWear(g_erasedPages);
+	}
+	g_erasedPages++;
+	if(g_erasedPages == g_pages)
+	{
+		g_erasing = FALSE;
+	}
+	return g_erasedPages;
+}
+
+/*
+ * Description :
+ * Returns TRUE while a full erase started by LOG_eraseStart() runs.
+ */
+boolean LOG_isErasing(void)
+{
+	return g_erasing;
+}
+
+/*
+ * Description :
+ * Returns the number of pages erased by the full erase that runs,
+ * LOG_getPages() when none runs.
+ */
+uint16 LOG_getErasedPages(void)
+{
+	return g_erasing ? g_erasedPages : g_pages;
+}
+
+/*
+ * Description :
+ * Fill the page cache counters.
+ */
+void LOG_getCacheStats(LOG_CacheStatsType *stats)
+{
+	*stats = g_cacheStats;
+}
+
+/*
+ * Description :
+ * Fill the wear report from the wear counters. Returns FALSE on an EEPROM error.
+ */
+boolean LOG_getWear(LOG_WearType *wear)
+{
+	uint8 data[LOG_PAGE_SIZE];
+	uint16 cycles;
+	uint16 page;
+	uint8 count;
+	uint8 i;
+
+	wear->pages = g_pages;
+	wear->headPage = (g_livePages == 0) ? g_startPage : g_headPage;
+	wear->maxPage = 0;
+	wear->maxCycles = 0;
+	wear->minCycles = 0xFFFF;
+
+	/* Read the counters one EEPROM page at a time */
+	for(page = 0; page < g_pages; page += LOG_PAGE_SIZE / 2)
+	{
+		count = (g_pages - page < LOG_PAGE_SIZE / 2) ? (uint8)(g_pages - page) : LOG_PAGE_SIZE / 2;
+		if(EEPROM_readBlock(g_wearAddress + 2 * (EEPROM_AddressType)page, data, 2 * count) != SUCCESS)
+		{
+			return FALSE;
+		}
+		for(i = 0; i < count; i++)
+		{
+			cycles = ((uint16)data[2 * i] << 8) | data[2 * i + 1];
+			if(cycles == 0xFFFF)
+			{
+				cycles = 0;  /* Never opened */
+			}
+			if(cycles > wear->maxCycles)
+			{
+				wear->maxCycles = cycles;
+				wear->maxPage = page + i;
+			}
+			if(cycles < wear->minCycles)
+			{
+				wear->minCycles = cycles;
+			}
+		}
+	}
+	return TRUE;
+}
@@ -0,0 +1,315 @@
+/******************************************************************************
+ *
+ * Module: LOG
+ *
+ * File Name: fault_log.h
+ *
+ * Description: Header file for the wear-leveled fault journal of the Control ECU.
+ *
+ * EEPROM layout, sized at LOG_init() from the memory selected with EEPROM_init()
+ * (91 pages on a 24C16, 2977 on a 24C512, LOG_MAX_PAGES at most):
+ *   - journal       : pages of LOG_PAGE_SIZE bytes from address 0
+ *   - wear counters : erase/write cycles of each journal page (2 bytes, MSB first)
+ *   - time index    : time each journal page was opened (LOG_INDEX_SIZE bytes)
+ *   - base record   : base sequence number and start page (2 bytes each), written
+ *                     by LOG_clear(), at the next LOG_PAGE_SIZE boundary
+ * The write page of the memory must be a multiple of LOG_PAGE_SIZE.
+ *
+ * Journal page: SEQ (2 bytes, MSB first) | HCRC | LOG_RECORDS_PER_PAGE records | spare
+ *   - SEQ  : incremented for every page opened, 0xFFFF = never written. A page
+ *            whose SEQ is before the base sequence number was cleared.
+ *   - HCRC : CRC-8 of SEQ, a page with a bad HCRC was torn while opened
+ * Record: CODE | CRC | COMMIT
+ *   - CODE   : fault code
+ *   - CRC    : CRC-8 of SEQ, slot number in the page and CODE, so a byte left
+ *              over from the previous use of the page never makes a valid record
+ *   - COMMIT : LOG_COMMITTED, written last in its own write cycle. Until then
+ *              the slot is free and the next record is written over it.
+ * The pages are used as a ring: a full page is followed by the next one and the
+ * oldest page is reused once the ring is full. Opening a page erases it with
+ * its header and first record in one page write, which is the cycle counted
+ * for that page. A clear only moves the base sequence number: the journal
+ * restarts on the page after the last one used, never at a fixed page.
+ * A full erase clears the log first, then blanks the pages one page write at
+ * a time, so a power loss during it never brings the old records back.
+ *
+ * Time index: the log time (minutes of operation, see LOG_getTime()) is written
+ * to the index entry of a page right after the page is opened:
+ *   TIME (3 bytes, MSB first) | ICRC
+ *   - ICRC : CRC-8 of the SEQ of the page and TIME, an entry left over from a
+ *            previous use of the page or torn never matches its page
+ * The entries of the live pages are in time order, a time range is found with
+ * a binary search over them (a few 4-byte reads) instead of reading the log.
+ * A record is only known to be between the time of its page and the time of
+ * the next page, so the ranges are rounded out to whole pages.
+ *
+ * Boot recovery reads the header of every page, the live pages are the valid
+ * ones from the oldest to the newest SEQ, and the head page is filled up to its
+ * last committed record. A power loss during a write never leaves more than
+ * the record being written uncommitted, the scan goes on past a torn page and
+ * a record read back with a bad CRC is returned as LOG_BAD_RECORD, so the
+ * records after it are still read.
+ *
+ * Page cache: LOG_read() goes through an LRU cache of the last LOG_CACHE_PAGES
+ * journal pages read, filled one page read at a time, so paging through the
+ * log reads each page from the EEPROM once. Every journal write goes through
+ * to the EEPROM and updates the cached copy (a failed write drops it), a page
+ * opened is cached as written and a clear empties the cache. The boot scans
+ * read the EEPROM directly.
+ *
+ * Code slots: every counted fault code has a slot with its episodes (records
+ * logged), its detections and the log time it was last detected, since the
+ * last clear. A fault still present is not logged again: LOG_repeat() only
+ * updates its slot in RAM, and LOG_saveSlots() writes the slots once the
+ * episode is over, so a fault that lasts costs one record and two mirror
+ * writes whatever its length. The slot also keeps a status byte and an aging
+ * counter for the caller (see dtc.h), set with LOG_setStatus().
+ *
+ * Mirror: the journal state (base, head, SEQ counter, log time and the code
+ * slots) is also kept in the internal EEPROM, written in the background after
+ * every record and every LOG_saveSlots() (again from LOG_service() if the
+ * internal EEPROM was busy with another block). At boot a mirror with a valid CRC is
+ * checked against the base record, the head page and the page after it (three
+ * short reads instead of the scan). The external EEPROM is the reference: a
+ * mirror left behind by a reset, torn or not matching is dropped, the journal
+ * is scanned and the mirror written again, the code slots are then rebuilt
+ * from the records still in the journal (one detection per record, last
+ * detected at the time of the page of the last record, status LOG_NO_STATUS).
+ *   LOG_MIRROR_MAGIC | journal pages | base SEQ | start page | head page | head SEQ |
+ *   head records (1 byte) | live pages | next SEQ | log time (3 bytes) |
+ *   LOG_COUNTED_CODES slots (episodes, detections, last detected (3 bytes),
+ *   status (1 byte), aging (1 byte)) | CRC-8
+ * with 2 bytes, MSB first, for every field but the magic, the head records, the
+ * times and the CRC.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef FAULT_LOG_H_
+#define FAULT_LOG_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define LOG_PAGE_SIZE                     16
+#define LOG_PAGE_HEADER                   3     /* SEQ, HCRC */
+#define LOG_RECORD_SIZE                   3     /* CODE, CRC, COMMIT */
+#define LOG_RECORDS_PER_PAGE              ((LOG_PAGE_SIZE - LOG_PAGE_HEADER) / LOG_RECORD_SIZE)
+
+/* Journal pages used at most (64 KB), must stay below the rebase distance of the SEQs */
+#define LOG_MAX_PAGES                     4096
+
+#define LOG_EMPTY                         0xFF  /* Erased byte */
+#define LOG_NO_SEQ                        0xFFFF
+#define LOG_COMMITTED                     0xA5  /* COMMIT of a complete record */
+#define LOG_BAD_RECORD                    0x00  /* Code read for a record that fails its check */
+
+/* Journal pages kept in the RAM cache (LOG_PAGE_SIZE bytes each) */
+#define LOG_CACHE_PAGES                   4
+
+/* Time index */
+#define LOG_INDEX_SIZE                    4     /* TIME, ICRC */
+#define LOG_MINUTE_MS                     60000UL
+#define LOG_NO_TIME                       0xFFFFFFUL  /* Erased entry, the log time stops before it */
+
+/* Journal mirror in the internal EEPROM */
+#define LOG_MIRROR_ADDRESS                0x000
+#define LOG_MIRROR_MAGIC                  0x56  /* Changed with the mirror layout */
+#define LOG_COUNTED_CODES                 4     /* Fault codes 1 to 4 have a slot */
+#define LOG_SLOT_SIZE                     9
+#define LOG_NO_STATUS                     0xFF  /* Status of a slot rebuilt from the journal */
+#define LOG_MIRROR_SIZE                   (20 + LOG_SLOT_SIZE * LOG_COUNTED_CODES)
+
+/*******************************************************************************
+ *                                Data Types                                   *
+ *******************************************************************************/
+
+/* Log time in minutes of operation of the Control ECU, kept across power cycles */
+typedef uint32 LOG_TimeType;
+
+/* Wear report of the journal pages */
+typedef struct
+{
+	uint16 pages;        /* Journal pages */
+	uint16 headPage;     /* Page being filled */
+	uint16 maxPage;      /* Most worn page */
+	uint16 maxCycles;    /* Erase/write cycles of the most worn page */
+	uint16 minCycles;    /* Erase/write cycles of the least worn page */
+}LOG_WearType;
+
+/* Slot of a counted fault code, since the last clear */
+typedef struct
+{
+	uint16 episodes;     /* Records logged */
+	uint16 detections;   /* Times detected, the logged ones included (saturates at 0xFFFF) */
+	LOG_TimeType lastSeen; /* Log time of the last detection */
+	uint8 status;        /* Status byte of the caller, 0 after a clear */
+	uint8 aging;         /* Aging counter of the caller, 0 after a clear */
+}LOG_SlotType;
+
+/* Page cache counters since LOG_init() (saturate at 0xFFFF) */
+typedef struct
+{
+	uint16 hits;         /* Reads served from the cache */
+	uint16 misses;       /* Reads that loaded a page from the EEPROM */
+}LOG_CacheStatsType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Find the live pages and the head of the journal, from the mirror if it
+ * matches the EEPROM, by a scan otherwise. The memory must be selected with
+ * EEPROM_init() and the global interrupts enabled (the mirror is written by
+ * its interrupt).
+ */
+void LOG_init(void);
+
+/*
+ * Description :
+ * Append a fault code (not LOG_BAD_RECORD) for a new episode of the fault,
+ * committed before returning, and count it in its slot. The oldest page is
+ * dropped when the journal is full. Returns FALSE on an EEPROM error or during
+ * a full erase, nothing is logged then.
+ */
+boolean LOG_append(uint8 faultCode);
+
+/*
+ * Description :
+ * Count one more detection of a fault whose episode is already logged, in its
+ * slot in RAM only (nothing is written).
+ */
+void LOG_repeat(uint8 faultCode);
+
+/*
+ * Description :
+ * Set the status byte and aging counter in the slot of a fault code, in RAM
+ * only (nothing is written).
+ */
+void LOG_setStatus(uint8 faultCode, uint8 status, uint8 aging);
+
+/*
+ * Description :
+ * Write the code slots to the mirror, in the background. Called when an
+ * episode is over or a status changes, a reset before only loses the
+ * detections of that episode.
+ */
+void LOG_saveSlots(void);
+
+/*
+ * Description :
+ * Write the mirror if a previous write was refused because the internal EEPROM
+ * was busy with another block. Must be called from the main loop.
+ */
+void LOG_service(void);
+
+/*
+ * Description :
+ * Read the fault logged at an index, 0 being the oldest one (LOG_BAD_RECORD if
+ * the record fails its check). Returns FALSE past the end of the log or on an
+ * EEPROM error.
+ */
+boolean LOG_read(uint16 index, uint8 *faultCode);
+
+/*
+ * Description :
+ * Returns the number of journal pages.
+ */
+uint16 LOG_getPages(void);
+
+/*
+ * Description :
+ * Returns the number of faults in the log.
+ */
+uint16 LOG_count(void);
+
+/*
+ * Description :
+ * Returns the log time: the time the previous run of the ECU stopped logging
+ * at, plus the time since LOG_init(). Must be called at least once every 49
+ * days (the wrap of the software timers time).
+ */
+LOG_TimeType LOG_getTime(void);
+
+/*
+ * Description :
+ * Returns the log time at LOG_init(), the start of the current run.
+ */
+LOG_TimeType LOG_getStartTime(void);
+
+/*
+ * Description :
+ * Find the faults logged between two log times (both included) with the time
+ * index: first is the index of the first one, end the index after the last
+ * one (first = end if none). Whole pages are returned, so a few faults just
+ * outside the range may come with them. Returns FALSE on an EEPROM error.
+ */
+boolean LOG_findRange(LOG_TimeType from, LOG_TimeType to, uint16 *first, uint16 *end);
+
+/*
+ * Description :
+ * Returns the number of times a fault code (1 to LOG_COUNTED_CODES, 0 for the
+ * others) was logged since the last clear.
+ */
+uint16 LOG_codeCount(uint8 faultCode);
+
+/*
+ * Description :
+ * Fill the slot of a fault code. Returns FALSE for a code without a slot.
+ */
+boolean LOG_getSlot(uint8 faultCode, LOG_SlotType *slot);
+
+/*
+ * Description :
+ * Empty the log in one write. Returns FALSE on an EEPROM error, the log is kept then.
+ */
+boolean LOG_clear(void);
+
+/*
+ * Description :
+ * Empty the log like LOG_clear(), then start erasing the journal pages with
+ * LOG_eraseStep(). Nothing is logged until the erase is over. Returns FALSE
+ * on an EEPROM error, the log is kept then.
+ */
+boolean LOG_eraseStart(void);
+
+/*
+ * Description :
+ * Erase the next journal page. Returns the number of pages erased,
+ * LOG_getPages() once the erase is over. A page that fails is tried again at
+ * the next call.
+ */
+uint16 LOG_eraseStep(void);
+
+/*
+ * Description :
+ * Returns TRUE while a full erase started by LOG_eraseStart() runs.
+ */
+boolean LOG_isErasing(void);
+
+/*
+ * Description :
+ * Returns the number of pages erased by the full erase that runs,
+ * LOG_getPages() when none runs.
+ */
+uint16 LOG_getErasedPages(void);
+
+/*
+ * Description :
+ * Fill the page cache counters.
+ */
+void LOG_getCacheStats(LOG_CacheStatsType *stats);
+
+/*
+ * Description :
+ * Fill the wear report from the wear counters. Returns FALSE on an EEPROM error.
+ */
+boolean LOG_getWear(LOG_WearType *wear);
+
+#endif /* FAULT_LOG_H_ */
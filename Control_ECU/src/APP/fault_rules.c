@@ -0,0 +1,260 @@
+/******************************************************************************
+ *
+ * Module: RULE
+ *
+ * File Name: fault_rules.c
+ *
+ * Description: Source file for the table of fault rules of the Control ECU
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include "fault_rules.h"
+#include "dtc.h"
+#include "crc8.h"
+#include "internal_eeprom.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static RULE_Type g_rules[RULE_MAX_RULES];
+static boolean g_ruleFailed[RULE_MAX_RULES];  /* Last result of each rule, before the debounce */
+static boolean g_tableDirty = FALSE;          /* Changed since it was written */
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Returns TRUE for a rule not used or a rule that can be checked.
+ */
+static boolean RULE_isValid(const RULE_Type *rule)
+{
+	if(rule->signal == FRAME_SIGNAL_NONE)
+	{
+		return TRUE;
+	}
+	return (rule->signal < FRAME_SIGNALS_COUNT &&
+	        (rule->compare == FRAME_COMPARE_BELOW || rule->compare == FRAME_COMPARE_ABOVE) &&
+	        rule->debounce >= 1 && rule->debounce <= DTC_DEBOUNCE_MAX &&
+	        rule->faultCode >= 1 && rule->faultCode <= DTC_MAX_CODES);
+}
+
+/*
+ * Description :
+ * Load the table from the internal EEPROM. Returns FALSE if it fails its
+ * check or holds a rule that is not valid.
+ */
+static boolean RULE_load(void)
+{
+	uint8 table[RULE_TABLE_SIZE];
+	uint8 i;
+
+	IEEPROM_read(RULE_TABLE_ADDRESS, table, RULE_TABLE_SIZE);
+	if(table[0] != RULE_TABLE_MAGIC ||
+	   table[RULE_TABLE_SIZE - 1] != CRC8_update(CRC8_INIT, table, RULE_TABLE_SIZE - 1))
+	{
+		return FALSE;
+	}
+	for(i = 0; i < RULE_MAX_RULES; i++)
+	{
+		RULE_unpack(&table[1 + i * FRAME_RULE_LENGTH], &g_rules[i]);
+		if(!RULE_isValid(&g_rules[i]))
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Load the table from the internal EEPROM, or the defaults (flash table of
+ * RULE_MAX_RULES rules) if it was never written or fails its check.
+ */
+void RULE_init(const RULE_Type *defaults_P)
+{
+	uint8 i;
+
+	if(!RULE_load())
+	{
+		memcpy_P(g_rules, defaults_P, sizeof(g_rules));
+	}
+	for(i = 0; i < RULE_MAX_RULES; i++)
+	{
+		g_ruleFailed[i] = FALSE;
+	}
+	g_tableDirty = FALSE;
+}
+
+/*
+ * Description :
+ * Check every rule used on its signal (values indexed by FRAME_SIGNAL_xxx) and
+ * give the result to the status of its DTC.
+ */
+void RULE_evaluate(const uint16 *signals)
+{
+	const RULE_Type *rule;
+	uint16 value;
+	uint8 i;
+
+	for(i = 0; i < RULE_MAX_RULES; i++)
+	{
+		rule = &g_rules[i];
+		if(rule->signal == FRAME_SIGNAL_NONE)
+		{
+			continue;
+		}
+
+		/* Past the threshold fails, back by the hysteresis passes, in between keeps the last result */
+		value = signals[rule->signal];
+		if(rule->compare == FRAME_COMPARE_ABOVE)
+		{
+			if(value > rule->threshold)
+			{
+				g_ruleFailed[i] = TRUE;
+			}
+			else if((uint32)value + rule->hysteresis <= rule->threshold)
+			{
+				g_ruleFailed[i] = FALSE;
+			}
+		}
+		else
+		{
+			if(value < rule->threshold)
+			{
+				g_ruleFailed[i] = TRUE;
+			}
+			else if(value >= rule->threshold + (uint32)rule->hysteresis)
+			{
+				g_ruleFailed[i] = FALSE;
+			}
+		}
+
+		DTC_report(rule->faultCode, g_ruleFailed[i], rule->debounce);
+	}
+}
+
+/*
+ * Description :
+ * Copy a rule of the table. Returns FALSE past the end of the table.
+ */
+boolean RULE_get(uint8 index, RULE_Type *rule)
+{
+	if(index >= RULE_MAX_RULES)
+	{
+		return FALSE;
+	}
+	*rule = g_rules[index];
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Replace a rule of the table, written to the internal EEPROM by
+ * RULE_service(). Returns FALSE and keeps the table if the rule is not valid
+ * or its fault code is used by another rule.
+ */
+boolean RULE_set(uint8 index, const RULE_Type *rule)
+{
+	uint8 i;
+
+	if(index >= RULE_MAX_RULES || !RULE_isValid(rule))
+	{
+		return FALSE;
+	}
+	for(i = 0; i < RULE_MAX_RULES; i++)
+	{
+		if(i != index && rule->signal != FRAME_SIGNAL_NONE && g_rules[i].signal != FRAME_SIGNAL_NONE &&
+		   g_rules[i].faultCode == rule->faultCode)
+		{
+			return FALSE;  /* One rule per code, the debounce is kept per code */
+		}
+	}
+
+	g_rules[index] = *rule;
+	g_ruleFailed[index] = FALSE;
+	g_tableDirty = TRUE;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Write the table changed by RULE_set() once the internal EEPROM is free.
+ * Must be called from the main loop.
+ */
+void RULE_service(void)
+{
+	uint8 table[RULE_TABLE_SIZE];
+	uint8 i;
+
+	if(!g_tableDirty || IEEPROM_isBusy())
+	{
+		return;
+	}
+
+	table[0] = RULE_TABLE_MAGIC;
+	for(i = 0; i < RULE_MAX_RULES; i++)
+	{
+		RULE_pack(&g_rules[i], &table[1 + i * FRAME_RULE_LENGTH]);
+	}
+	table[RULE_TABLE_SIZE - 1] = CRC8_update(CRC8_INIT, table, RULE_TABLE_SIZE - 1);
+	g_tableDirty = !IEEPROM_write(RULE_TABLE_ADDRESS, table, RULE_TABLE_SIZE);
+}
+
+/*
+ * Description :
+ * Get the threshold of the first rule used on a signal. Returns FALSE if no
+ * rule watches it.
+ */
+boolean RULE_getThreshold(uint8 signal, uint16 *threshold)
+{
+	uint8 i;
+
+	for(i = 0; i < RULE_MAX_RULES; i++)
+	{
+		if(g_rules[i].signal == signal)
+		{
+			*threshold = g_rules[i].threshold;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * Description :
+ * Write a rule in the FRAME_RULE_xxx layout (FRAME_RULE_LENGTH bytes).
+ */
+void RULE_pack(const RULE_Type *rule, uint8 *data)
+{
+	data[FRAME_RULE_SIGNAL] = rule->signal;
+	data[FRAME_RULE_COMPARE] = rule->compare;
+	data[FRAME_RULE_THRESHOLD] = (uint8)(rule->threshold >> 8);
+	data[FRAME_RULE_THRESHOLD + 1] = (uint8)rule->threshold;
+	data[FRAME_RULE_HYSTERESIS] = rule->hysteresis;
+	data[FRAME_RULE_DEBOUNCE] = rule->debounce;
+	data[FRAME_RULE_CODE] = rule->faultCode;
+}
+
+/*
+ * Description :
+ * Read a rule from the FRAME_RULE_xxx layout (FRAME_RULE_LENGTH bytes).
+ */
+void RULE_unpack(const uint8 *data, RULE_Type *rule)
+{
+	rule->signal = data[FRAME_RULE_SIGNAL];
+	rule->compare = data[FRAME_RULE_COMPARE];
+	rule->threshold = ((uint16)data[FRAME_RULE_THRESHOLD] << 8) | data[FRAME_RULE_THRESHOLD + 1];
+	rule->hysteresis = data[FRAME_RULE_HYSTERESIS];
+	rule->debounce = data[FRAME_RULE_DEBOUNCE];
+	rule->faultCode = data[FRAME_RULE_CODE];
+}
@@ -0,0 +1,119 @@
+/******************************************************************************
+ *
+ * Module: RULE
+ *
+ * File Name: fault_rules.h
+ *
+ * Description: Header file for the table of fault rules of the Control ECU.
+ *
+ * Rule: signal (FRAME_SIGNAL_xxx), comparison, threshold, hysteresis, debounce
+ * count and fault code, one rule per code. A rule fails while its signal is
+ * below or above the threshold, then passes again once the signal is back by
+ * the hysteresis, and gives every result to the status of its DTC (see dtc.h)
+ * with its debounce count. RULE_evaluate() checks every rule in one pass over
+ * the table for each sample of the signals.
+ *
+ * The table is kept in the internal EEPROM and changed at run time with
+ * RULE_set() (WRITE_RULE command of the HMI), so a threshold is tuned or a
+ * fault added without a new build. A table changed is written in the
+ * background by RULE_service() once the internal EEPROM is free, a reset
+ * before loses the change. The defaults of the application are used until a
+ * valid table was written. A fault code left without a rule keeps its status
+ * until the next clear.
+ *   RULE_TABLE_MAGIC | RULE_MAX_RULES rules (FRAME_RULE_LENGTH bytes, layout of
+ *   frame.h) | CRC-8
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef FAULT_RULES_H_
+#define FAULT_RULES_H_
+
+#include "std_types.h"
+#include "frame.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define RULE_MAX_RULES                    FRAME_RULES_COUNT
+
+/* Table in the internal EEPROM, after the fault journal mirror */
+#define RULE_TABLE_ADDRESS                0x040
+#define RULE_TABLE_MAGIC                  0x52  /* Changed with the table layout */
+#define RULE_TABLE_SIZE                   (2 + RULE_MAX_RULES * FRAME_RULE_LENGTH)
+
+/*******************************************************************************
+ *                                Data Types                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint8 signal;        /* FRAME_SIGNAL_xxx, FRAME_SIGNAL_NONE for a rule not used */
+	uint8 compare;       /* FRAME_COMPARE_BELOW or FRAME_COMPARE_ABOVE */
+	uint16 threshold;    /* Fails past it, in the unit of the signal */
+	uint8 hysteresis;    /* Passes again only that far back from the threshold */
+	uint8 debounce;      /* Consecutive results to fail or pass (1 to DTC_DEBOUNCE_MAX) */
+	uint8 faultCode;     /* Fault code (1 to DTC_MAX_CODES) */
+}RULE_Type;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Load the table from the internal EEPROM, or the defaults (flash table of
+ * RULE_MAX_RULES rules) if it was never written or fails its check.
+ */
+void RULE_init(const RULE_Type *defaults_P);
+
+/*
+ * Description :
+ * Check every rule used on its signal (values indexed by FRAME_SIGNAL_xxx) and
+ * give the result to the status of its DTC.
+ */
+void RULE_evaluate(const uint16 *signals);
+
+/*
+ * Description :
+ * Copy a rule of the table. Returns FALSE past the end of the table.
+ */
+boolean RULE_get(uint8 index, RULE_Type *rule);
+
+/*
+ * Description :
+ * Replace a rule of the table, written to the internal EEPROM by
+ * RULE_service(). Returns FALSE and keeps the table if the rule is not valid
+ * or its fault code is used by another rule.
+ */
+boolean RULE_set(uint8 index, const RULE_Type *rule);
+
+/*
+ * Description :
+ * Write the table changed by RULE_set() once the internal EEPROM is free.
+ * Must be called from the main loop.
+ */
+void RULE_service(void);
+
+/*
+ * Description :
+ * Get the threshold of the first rule used on a signal. Returns FALSE if no
+ * rule watches it.
+ */
+boolean RULE_getThreshold(uint8 signal, uint16 *threshold);
+
+/*
+ * Description :
+ * Write a rule in the FRAME_RULE_xxx layout (FRAME_RULE_LENGTH bytes).
+ */
+void RULE_pack(const RULE_Type *rule, uint8 *data);
+
+/*
+ * Description :
+ * Read a rule from the FRAME_RULE_xxx layout (FRAME_RULE_LENGTH bytes).
+ */
+void RULE_unpack(const uint8 *data, RULE_Type *rule);
+
+#endif /* FAULT_RULES_H_ */
@@ -0,0 +1,38 @@
+/******************************************************************************
+ *
+ * Module: CRC8
+ *
+ * File Name: crc8.h
+ *
+ * Description: Header file for the CRC-8 shared by both ECUs, used to check the
+ *              frames of the ECU link and the records kept in EEPROM.
+ *              Polynomial 0x07 (x^8 + x^2 + x + 1), initial value 0x00, no
+ *              reflection, no final XOR (CRC-8/SMBUS, check value 0xF4).
+ *              The 256 entries table is read from flash, one lookup per byte.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef CRC8_H_
+#define CRC8_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define CRC8_INIT                         0x00
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Continue a CRC over length bytes, start with CRC8_INIT.
+ */
+uint8 CRC8_update(uint8 crc, const uint8 *data, uint8 length);
+
+#endif /* CRC8_H_ */
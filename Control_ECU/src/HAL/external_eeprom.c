@@ -1,82 +1,244 @@
- /******************************************************************************
- *
- * Module: External EEPROM
- *
- * File Name: external_eeprom.c
- *
- * Description: Source file for the External EEPROM Memory
- *
- * Author: Mohamed Tarek
- *
- *******************************************************************************/
-#include "external_eeprom.h"
-#include "twi.h"
-
-uint8 EEPROM_writeByte(uint16 u16addr, uint8 u8data)
-{
-	/* Send the Start Bit */
-    TWI_start();
-    if (TWI_getStatus() != TWI_START)
-        return ERROR;
-		
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=0 (write) */
-    TWI_writeByte((uint8)(0xA0 | ((u16addr & 0x0700)>>7)));
-    if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
-        return ERROR; 
-		 
-    /* Send the required memory location address */
-    TWI_writeByte((uint8)(u16addr));
-    if (TWI_getStatus() != TWI_MT_DATA_ACK)
-        return ERROR;
-		
-    /* write byte to eeprom */
-    TWI_writeByte(u8data);
-    if (TWI_getStatus() != TWI_MT_DATA_ACK)
-        return ERROR;
-
-    /* Send the Stop Bit */
-    TWI_stop();
-	
-    return SUCCESS;
-}
-
-uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
-{
-	/* Send the Start Bit */
-    TWI_start();
-    if (TWI_getStatus() != TWI_START)
-        return ERROR;
-		
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=0 (write) */
-    TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7)));
-    if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
-        return ERROR;
-		
-    /* Send the required memory location address */
-    TWI_writeByte((uint8)(u16addr));
-    if (TWI_getStatus() != TWI_MT_DATA_ACK)
-        return ERROR;
-		
-    /* Send the Repeated Start Bit */
-    TWI_start();
-    if (TWI_getStatus() != TWI_REP_START)
-        return ERROR;
-		
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=1 (Read) */
-    TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7) | 1));
-    if (TWI_getStatus() != TWI_MT_SLA_R_ACK)
-        return ERROR;
-
-    /* Read Byte from Memory without send ACK */
-    *u8data = TWI_readByteWithNACK();
-    if (TWI_getStatus() != TWI_MR_DATA_NACK)
-        return ERROR;
-
-    /* Send the Stop Bit */
-    TWI_stop();
-
-    return SUCCESS;
-}
+ /******************************************************************************
+ *
+ * Module: External EEPROM
+ *
+ * File Name: external_eeprom.c
+ *
+ * Description: Source file for the External EEPROM Memory
+ *
+ * Author: Mohamed Tarek
+ *
+ *******************************************************************************/
+#include "external_eeprom.h"
+#include "twi.h"
+
+/* Memory in use, a single 24C16 until EEPROM_init() */
+static EEPROM_DeviceType g_device = EEPROM_24C16(1);
+
+/* Device address (R/W=0) of the chip written last, polled by EEPROM_waitReady() */
+static uint8 g_lastDevice = EEPROM_DEVICE_CODE;
+
+/*
+ * Device address of a memory location with R/W=0: the chip select bits, with
+ * the block bits of the location in the low ones on the small parts
+ */
+static uint8 EEPROM_deviceAddress(EEPROM_AddressType u32addr)
+{
+    uint8 chip = (uint8)(u32addr / g_device.capacity);
+    uint32 offset = u32addr % g_device.capacity;
+    uint8 block = (uint8)(offset >> (8 * g_device.addressBytes));
+
+    return (uint8)(EEPROM_DEVICE_CODE | ((((chip << g_device.blockBits) | block) & 0x07) << 1));
+}
+
+/*
+ * Sends the Start Bit, the device address (R/W=0) and the word address of a
+ * memory location. Sends the Stop Bit on an error.
+ */
+static uint8 EEPROM_select(EEPROM_AddressType u32addr)
+{
+    uint32 offset = u32addr % g_device.capacity;
+
+    /* Send the Start Bit */
+    TWI_start();
+    if (TWI_getStatus() != TWI_START)
+    {
+        TWI_stop();
+        return ERROR;
+    }
+
+    /* Send the device address and R/W=0 (write) */
+    TWI_writeByte(EEPROM_deviceAddress(u32addr));
+    if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
+    {
+        TWI_stop();
+        return ERROR;
+    }
+
+    /* Send the required memory location address, MSB first on the large parts */
+    if (g_device.addressBytes == 2)
+    {
+        TWI_writeByte((uint8)(offset >> 8));
+        if (TWI_getStatus() != TWI_MT_DATA_ACK)
+        {
+            TWI_stop();
+            return ERROR;
+        }
+    }
+    TWI_writeByte((uint8)(offset));
+    if (TWI_getStatus() != TWI_MT_DATA_ACK)
+    {
+        TWI_stop();
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/*
+ * Sends the Repeated Start Bit and the device address of a memory location
+ * with R/W=1 (read), after EEPROM_select(). Sends the Stop Bit on an error.
+ */
+static uint8 EEPROM_selectRead(EEPROM_AddressType u32addr)
+{
+    /* Send the Repeated Start Bit */
+    TWI_start();
+    if (TWI_getStatus() != TWI_REP_START)
+    {
+        TWI_stop();
+        return ERROR;
+    }
+
+    /* Send the device address with R/W=1 (Read) */
+    TWI_writeByte((uint8)(EEPROM_deviceAddress(u32addr) | 1));
+    if (TWI_getStatus() != TWI_MT_SLA_R_ACK)
+    {
+        TWI_stop();
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+void EEPROM_init(const EEPROM_DeviceType *device)
+{
+    g_device = *device;
+    g_lastDevice = EEPROM_DEVICE_CODE;
+}
+
+EEPROM_AddressType EEPROM_getCapacity(void)
+{
+    return g_device.capacity * g_device.chips;
+}
+
+uint8 EEPROM_getPageSize(void)
+{
+    return g_device.pageSize;
+}
+
+uint8 EEPROM_writeByte(EEPROM_AddressType u32addr, uint8 u8data)
+{
+    if (EEPROM_select(u32addr) != SUCCESS)
+    {
+        return ERROR;
+    }
+
+    /* write byte to eeprom */
+    TWI_writeByte(u8data);
+    if (TWI_getStatus() != TWI_MT_DATA_ACK)
+    {
+        TWI_stop();
+        return ERROR;
+    }
+
+    /* Send the Stop Bit */
+    TWI_stop();
+    g_lastDevice = EEPROM_deviceAddress(u32addr);
+	
+    return SUCCESS;
+}
+
+uint8 EEPROM_readByte(EEPROM_AddressType u32addr, uint8 *u8data)
+{
+    if (EEPROM_select(u32addr) != SUCCESS || EEPROM_selectRead(u32addr) != SUCCESS)
+    {
+        return ERROR;
+    }
+
+    /* Read Byte from Memory without send ACK */
+    *u8data = TWI_readByteWithNACK();
+    if (TWI_getStatus() != TWI_MR_DATA_NACK)
+    {
+        TWI_stop();
+        return ERROR;
+    }
+
+    /* Send the Stop Bit */
+    TWI_stop();
+
+    return SUCCESS;
+}
+
+uint8 EEPROM_writeBlock(EEPROM_AddressType u32addr, const uint8 *data, uint8 length)
+{
+    if (EEPROM_select(u32addr) != SUCCESS)
+    {
+        return ERROR;
+    }
+
+    /* The memory increments the address inside the page, all the bytes are
+     * programmed together after the Stop Bit */
+    while (length != 0)
+    {
+        TWI_writeByte(*data++);
+        if (TWI_getStatus() != TWI_MT_DATA_ACK)
+        {
+            TWI_stop();
+            return ERROR;
+        }
+        length--;
+    }
+
+    /* Send the Stop Bit */
+    TWI_stop();
+    g_lastDevice = EEPROM_deviceAddress(u32addr);
+
+    return SUCCESS;
+}
+
+uint8 EEPROM_readBlock(EEPROM_AddressType u32addr, uint8 *data, uint16 length)
+{
+    if (length == 0)
+        return SUCCESS;
+
+    if (EEPROM_select(u32addr) != SUCCESS || EEPROM_selectRead(u32addr) != SUCCESS)
+    {
+        return ERROR;
+    }
+
+    /* ACK every byte but the last one, the memory increments the address */
+    while (length > 1)
+    {
+        *data++ = TWI_readByteWithACK();
+        if (TWI_getStatus() != TWI_MR_DATA_ACK)
+        {
+            TWI_stop();
+            return ERROR;
+        }
+        length--;
+    }
+    *data = TWI_readByteWithNACK();
+    if (TWI_getStatus() != TWI_MR_DATA_NACK)
+    {
+        TWI_stop();
+        return ERROR;
+    }
+
+    /* Send the Stop Bit */
+    TWI_stop();
+
+    return SUCCESS;
+}
+
+uint8 EEPROM_waitReady(void)
+{
+    uint16 polls;
+
+    for (polls = 0; polls < EEPROM_READY_MAX_POLLS; polls++)
+    {
+        /* The memory does not acknowledge its address while it programs a write */
+        TWI_start();
+        if (TWI_getStatus() == TWI_START)
+        {
+            TWI_writeByte(g_lastDevice);
+            if (TWI_getStatus() == TWI_MT_SLA_W_ACK)
+            {
+                TWI_stop();
+                return SUCCESS;
+            }
+        }
+        TWI_stop();
+    }
+
+    return ERROR;
+}
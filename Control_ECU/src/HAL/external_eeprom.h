@@ -1,32 +1,101 @@
- /******************************************************************************
- *
- * Module: External EEPROM
- *
- * File Name: external_eeprom.h
- *
- * Description: Header file for the External EEPROM Memory
- *
- * Author: Mohamed Tarek
- *
- *******************************************************************************/
-
-
-#ifndef EXTERNAL_EEPROM_H_
-#define EXTERNAL_EEPROM_H_
-
-#include "std_types.h"
-
-/*******************************************************************************
- *                      Preprocessor Macros                                    *
- *******************************************************************************/
-#define ERROR 0
-#define SUCCESS 1
-
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-
-uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data);
-uint8 EEPROM_readByte(uint16 u16addr,uint8 *u8data);
- 
-#endif /* EXTERNAL_EEPROM_H_ */
+ /******************************************************************************
+ *
+ * Module: External EEPROM
+ *
+ * File Name: external_eeprom.h
+ *
+ * Description: Header file for the External EEPROM Memory
+ *
+ * Author: Mohamed Tarek
+ *
+ *******************************************************************************/
+
+
+#ifndef EXTERNAL_EEPROM_H_
+#define EXTERNAL_EEPROM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+#define ERROR 0
+#define SUCCESS 1
+
+/* Acknowledge polls before giving up on a write cycle (one poll takes about 30 us at 400 kHz) */
+#define EEPROM_READY_MAX_POLLS 500
+
+/* Device type identifier of the 24Cxx memories, before the chip select bits */
+#define EEPROM_DEVICE_CODE 0xA0
+
+/*
+ * Descriptors of the supported parts (EEPROM_DeviceType initializers), chips is
+ * the number of memories on the bus. The chip select pins take the device
+ * address bits left free by the memory address: up to 4 24C04, 2 24C08,
+ * 1 24C16 and 8 of the larger parts. Each chip is wired to the chip select
+ * address following the previous one, the chips are seen as one memory.
+ */
+#define EEPROM_24C04(chips)   { 512UL,   16,  1, 1, (chips) }
+#define EEPROM_24C08(chips)   { 1024UL,  16,  1, 2, (chips) }
+#define EEPROM_24C16(chips)   { 2048UL,  16,  1, 3, (chips) }
+#define EEPROM_24C32(chips)   { 4096UL,  32,  2, 0, (chips) }
+#define EEPROM_24C64(chips)   { 8192UL,  32,  2, 0, (chips) }
+#define EEPROM_24C128(chips)  { 16384UL, 64,  2, 0, (chips) }
+#define EEPROM_24C256(chips)  { 32768UL, 64,  2, 0, (chips) }
+#define EEPROM_24C512(chips)  { 65536UL, 128, 2, 0, (chips) }
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* Memory address, across all the chips */
+typedef uint32 EEPROM_AddressType;
+
+/*
+ * Description:
+ * Geometry and addressing of the memory on the bus.
+ *   - capacity     : bytes in one chip
+ *   - pageSize     : bytes in a write page
+ *   - addressBytes : word address bytes after the device address, 1 (up to
+ *                    24C16) or 2 (24C32 and up), MSB first
+ *   - blockBits    : memory address bits above the word address that go in the
+ *                    device address (block select), in place of chip select bits
+ *   - chips        : memories on the bus
+ */
+typedef struct
+{
+	uint32 capacity;
+	uint8 pageSize;
+	uint8 addressBytes;
+	uint8 blockBits;
+	uint8 chips;
+}EEPROM_DeviceType;
+
+extern EEPROM_DeviceType EEPROM_Device;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/* Selects the memory the other functions use, the TWI must be initialized */
+void EEPROM_init(const EEPROM_DeviceType *device);
+
+/* Bytes in all the chips */
+EEPROM_AddressType EEPROM_getCapacity(void);
+
+/* Bytes in a write page */
+uint8 EEPROM_getPageSize(void);
+
+uint8 EEPROM_writeByte(EEPROM_AddressType u32addr,uint8 u8data);
+uint8 EEPROM_readByte(EEPROM_AddressType u32addr,uint8 *u8data);
+
+/* Writes up to a page of bytes inside one page in a single write cycle */
+uint8 EEPROM_writeBlock(EEPROM_AddressType u32addr,const uint8 *data,uint8 length);
+
+/* Reads consecutive bytes in one transfer (sequential read), inside one chip */
+uint8 EEPROM_readBlock(EEPROM_AddressType u32addr,uint8 *data,uint16 length);
+
+/* Waits for the end of the write cycle: the memory last written acknowledges its address again (ACK polling) */
+uint8 EEPROM_waitReady(void);
+ 
+#endif /* EXTERNAL_EEPROM_H_ */
@@ -0,0 +1,267 @@
+/******************************************************************************
+ *
+ * Module: FRAME
+ *
+ * File Name: frame.h
+ *
+ * Description: Header file for the UART framing layer shared by both ECUs.
+ *
+ * Frame layout:
+ *   SOF | TYPE | SEQ | LENGTH | PAYLOAD[LENGTH] | CRC
+ *   - SOF      : start of frame delimiter (FRAME_SOF)
+ *   - TYPE     : one of the FRAME_TYPE_xxx values, its high nibble is the channel
+ *   - SEQ      : sequence number, incremented by the sender for every frame
+ *   - CRC      : CRC-8 (see crc8.h) of TYPE, SEQ, LENGTH and all the payload bytes
+ *
+ * Byte stuffing (as in HDLC): after the SOF, a byte equal to FRAME_SOF or
+ * FRAME_ESCAPE is sent as FRAME_ESCAPE then the byte XOR FRAME_ESCAPE_XOR, so
+ * FRAME_SOF only ever starts a frame. The CRC is over the bytes before stuffing.
+ *
+ * Resync: the receiver drops a frame with a bad length, escape or CRC, or whose
+ * next byte does not come within FRAME_RX_TIMEOUT_MS, then waits for the next
+ * SOF. A SOF in the middle of a frame drops it and starts the next one, so a
+ * lost byte costs at most the frame it was in.
+ *
+ * Channels: every channel has its own transmit queue. The queues are served in
+ * priority order (link, command, diagnostic, telemetry, bulk) each time the UART transmit
+ * buffer has less than one frame left to send, so a frame never waits for more
+ * than the frame on the line and the one behind it.
+ *
+ * Multi-drop: several Control ECUs may share the line with the HMI, see uart.h.
+ * The HMI sends the address of a node before its frames and a node only sends
+ * its queued frames while it is the selected one.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef FRAME_H_
+#define FRAME_H_
+
+#include "std_types.h"
+#include "crc8.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define FRAME_SOF                         0x7E
+#define FRAME_ESCAPE                      0x7D
+#define FRAME_ESCAPE_XOR                  0x20
+#define FRAME_MAX_PAYLOAD                 16
+#define FRAME_OVERHEAD                    5     /* SOF, TYPE, SEQ, LENGTH and CRC bytes (before stuffing) */
+#define FRAME_MAX_SIZE                    (FRAME_OVERHEAD + FRAME_MAX_PAYLOAD)
+
+/* Logical channels, from the highest priority to the lowest */
+#define FRAME_CHANNEL(type)               ((uint8)(type) >> 4)
+#define FRAME_CHANNEL_LINK                0x2   /* Baud rate negotiation and link checks */
+#define FRAME_CHANNEL_COMMAND             0x3   /* Requests and responses */
+#define FRAME_CHANNEL_DIAG                0x5   /* Diagnostic services */
+#define FRAME_CHANNEL_TELEMETRY           0x1   /* Live data stream */
+#define FRAME_CHANNEL_BULK                0x4   /* Fault log export and erase */
+#define FRAME_CHANNELS_COUNT              5
+#define FRAME_QUEUE_DEPTH                 2     /* Frames waiting per channel */
+
+/* Frame types (must match on both ECUs) */
+#define FRAME_TYPE_SUBSCRIBE              0x10  /* HMI -> Control: rate in Hz (0 = unsubscribe), initial credit */
+#define FRAME_TYPE_TELEMETRY              0x11  /* Control -> HMI: full sample (keyframe) */
+#define FRAME_TYPE_TELEMETRY_DELTA        0x12  /* Control -> HMI: fields changed since the previous sample */
+#define FRAME_TYPE_CREDIT                 0x13  /* HMI -> Control: last telemetry SEQ the HMI can buffer */
+#define FRAME_TYPE_BAUD_REQUEST           0x20  /* HMI -> Control: fastest baud index the HMI wants */
+#define FRAME_TYPE_BAUD_ACCEPT            0x21  /* Control -> HMI: baud index both switch to after this frame */
+#define FRAME_TYPE_LINK_CHECK             0x22  /* HMI -> Control: confirms a new rate, then keeps the link alive */
+#define FRAME_TYPE_LINK_STATUS            0x23  /* Control -> HMI: line errors seen since the previous check */
+#define FRAME_TYPE_REQUEST                0x30  /* HMI -> Control: command and its arguments, SEQ = correlation id */
+#define FRAME_TYPE_RESPONSE               0x31  /* Control -> HMI: command and its result, SEQ of the request */
+#define FRAME_TYPE_LOG_DATA               0x40  /* Control -> HMI: index of the first fault (2 bytes), fault codes,
+                                                 * no fault code = end of the log, SEQ = correlation id
+                                                 * of the EXPORT_FAULTS request */
+#define FRAME_TYPE_CLEAR_PROGRESS         0x41  /* Control -> HMI: journal pages erased, pages in the journal
+                                                 * (2 bytes each) */
+#define FRAME_TYPE_DIAG                   0x50  /* Tester <-> Control: segment of a diagnostic message */
+
+/* Longest gap between two bytes of a frame, a partly received frame is dropped after it */
+#define FRAME_RX_TIMEOUT_MS               10
+
+/* Telemetry payload layout, multi-byte fields are sent MSB first */
+#define FRAME_TELEMETRY_TIME              0     /* 4 bytes: sample time in ms since the Control ECU started */
+#define FRAME_TELEMETRY_DISTANCE          4     /* 2 bytes: distance in cm */
+#define FRAME_TELEMETRY_TEMP              6     /* Temperature in degrees C */
+#define FRAME_TELEMETRY_WIN1              7     /* Window 1 state */
+#define FRAME_TELEMETRY_WIN2              8     /* Window 2 state */
+#define FRAME_TELEMETRY_LENGTH            9
+
+/* Delta telemetry payload: change mask, then only the flagged fields in the order above.
+ * There is no time field, a delta sample is one stream period after the previous one. */
+#define FRAME_DELTA_DISTANCE              0x01
+#define FRAME_DELTA_TEMP                  0x02
+#define FRAME_DELTA_WIN1                  0x04
+#define FRAME_DELTA_WIN2                  0x08
+#define FRAME_DELTA_MAX_LENGTH            (1 + FRAME_TELEMETRY_LENGTH - FRAME_TELEMETRY_DISTANCE)
+
+/* Data identifiers (DIDs) of the Control ECU registry, read with the READ_DIDS
+ * command or the ReadDataByIdentifier diagnostic service. A DID is answered with
+ * its ID (2 bytes) then its data, multi-byte values MSB first. New DIDs are added
+ * at the end, the IDs are consecutive from FRAME_DID_FIRST. */
+#define FRAME_DID_FIRST                   0x0100
+#define FRAME_DID_TEMPERATURE             0x0100  /* Temperature in degrees C */
+#define FRAME_DID_DISTANCE                0x0101  /* Distance in cm */
+#define FRAME_DID_WINDOWS                 0x0102  /* Window 1 state, window 2 state */
+#define FRAME_DID_MONITORING              0x0103  /* Monitoring flag */
+#define FRAME_DID_FAULTS_LOGGED           0x0104  /* Faults in the journal */
+#define FRAME_DID_UPTIME                  0x0105  /* Time in ms since the Control ECU started */
+#define FRAME_DID_FAULT_COUNTS            0x0106  /* Occurrences of P001 and P002 since the last clear */
+#define FRAME_DID_LOOP_TIME               0x0107  /* Main loop pass in ms: last, longest (2 bytes each) */
+#define FRAME_DID_LINE_ERRORS             0x0108  /* UART frame, overrun and parity errors */
+#define FRAME_DID_FRAMES_DROPPED          0x0109  /* Frames dropped by the receiver */
+#define FRAME_DID_THRESHOLDS              0x010A  /* Critical temperature, critical distance (first fault rule on each) */
+#define FRAME_DID_LOG_CACHE               0x010B  /* Fault log page cache hits, misses (2 bytes each) */
+#define FRAME_DID_DTC_COUNTS              0x010C  /* Occurrences of every fault code since the last clear,
+                                                 * codes 1 to FRAME_FAULT_CODES_COUNT (1 byte each) */
+#define FRAME_DIDS_COUNT                  13
+
+/* Fault codes the rules can log: 1 to FRAME_FAULT_CODES_COUNT */
+#define FRAME_FAULT_CODES_COUNT           4
+
+/* Data size of every DID in bytes, in ID order */
+#define FRAME_DID_SIZE_LIST               1, 2, 2, 1, 2, 4, 2, 4, 2, 2, 2, 4, FRAME_FAULT_CODES_COUNT
+#define FRAME_DID_SIZES                   { FRAME_DID_SIZE_LIST }
+
+/* Fault rule of the Control ECU table, read with READ_RULE and written with
+ * WRITE_RULE after its index. The rule fails while its signal is past the
+ * threshold and passes again once the signal is back by the hysteresis. */
+#define FRAME_RULES_COUNT                 4     /* Rules in the table */
+#define FRAME_RULE_SIGNAL                 0     /* FRAME_SIGNAL_xxx */
+#define FRAME_RULE_COMPARE                1     /* FRAME_COMPARE_xxx */
+#define FRAME_RULE_THRESHOLD              2     /* 2 bytes, in the unit of the signal */
+#define FRAME_RULE_HYSTERESIS             4
+#define FRAME_RULE_DEBOUNCE               5     /* Consecutive checks to fail or pass */
+#define FRAME_RULE_CODE                   6     /* Fault code logged */
+#define FRAME_RULE_LENGTH                 7
+
+/* Signals a rule can watch, and its comparisons */
+#define FRAME_SIGNAL_TEMPERATURE          0     /* Degrees C */
+#define FRAME_SIGNAL_DISTANCE             1     /* cm */
+#define FRAME_SIGNALS_COUNT               2
+#define FRAME_SIGNAL_NONE                 0xFF  /* Rule not used */
+#define FRAME_COMPARE_BELOW               0
+#define FRAME_COMPARE_ABOVE               1
+
+/* Baud rates the link can negotiate, index 0 is the rate both ECUs start with.
+ * All of them are within 0.5% at 8 MHz in double speed mode (UBRR 103, 25, 12, 3). */
+#define FRAME_BAUD_RATES                  { 9600UL, 38400UL, 76800UL, 250000UL }
+#define FRAME_BAUD_RATES_COUNT            4
+
+/*******************************************************************************
+ *                                Data Types                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint8 type;
+	uint8 seq;
+	uint8 length;
+	uint8 payload[FRAME_MAX_PAYLOAD];
+}FRAME_Type;
+
+typedef enum
+{
+	FRAME_WAIT_SOF,
+	FRAME_WAIT_TYPE,
+	FRAME_WAIT_SEQ,
+	FRAME_WAIT_LENGTH,
+	FRAME_WAIT_PAYLOAD,
+	FRAME_WAIT_CRC
+}FRAME_RxStateType;
+
+/* Receiver context, one per byte stream */
+typedef struct
+{
+	FRAME_RxStateType state;
+	uint8 index;
+	uint8 crc;
+	boolean escaped;   /* The previous byte was FRAME_ESCAPE */
+	uint32 last_ms;    /* Time of the last byte, for the inter-byte timeout */
+	uint16 dropped;    /* Frames dropped (bad length, escape or CRC, cut by a SOF or timeout) */
+	FRAME_Type frame;
+}FRAME_ReceiverType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Build a frame around the payload and send it through the UART, ahead of the
+ * channel queues.
+ */
+void FRAME_send(uint8 type, uint8 seq, const uint8 *payload, uint8 length);
+
+/*
+ * Description :
+ * Queue a frame on the channel of its type and send what the UART can take.
+ * Returns FALSE if the queue of the channel is full (the frame is dropped).
+ */
+boolean FRAME_queue(uint8 type, uint8 seq, const uint8 *payload, uint8 length);
+
+/*
+ * Description :
+ * Returns the number of frames that can still be queued on a channel.
+ */
+uint8 FRAME_queueSpace(uint8 channel);
+
+/*
+ * Description :
+ * Returns TRUE when no frame is waiting in any channel queue.
+ */
+boolean FRAME_queuesEmpty(void);
+
+/*
+ * Description :
+ * Move queued frames to the UART, highest priority channel first. Must be
+ * called from the main loop.
+ */
+void FRAME_service(void);
+
+/*
+ * Description :
+ * Drop any partly received frame and wait for the next SOF.
+ */
+void FRAME_resetReceiver(FRAME_ReceiverType *rx);
+
+/*
+ * Description :
+ * Returns TRUE while the receiver is in the middle of a frame.
+ */
+boolean FRAME_isReceiving(const FRAME_ReceiverType *rx);
+
+/*
+ * Description :
+ * Feed one received byte to the receiver.
+ * Returns TRUE when a complete frame with a valid CRC is in rx->frame.
+ */
+boolean FRAME_receiveByte(FRAME_ReceiverType *rx, uint8 data);
+
+/*
+ * Description :
+ * Drops a partly received frame when no byte came for FRAME_RX_TIMEOUT_MS.
+ * Must be called when all the received bytes were fed, a stalled main loop
+ * does not make a frame time out.
+ */
+void FRAME_checkTimeout(FRAME_ReceiverType *rx);
+
+/*
+ * Description :
+ * Build a delta telemetry payload holding the fields of sample that differ from reference.
+ * Returns the payload length (at least 1, the change mask).
+ */
+uint8 FRAME_encodeDelta(const uint8 *sample, const uint8 *reference, uint8 *payload);
+
+/*
+ * Description :
+ * Apply a delta telemetry payload on a full telemetry sample.
+ * Returns FALSE if the payload length does not match its change mask.
+ */
+boolean FRAME_applyDelta(uint8 *sample, const uint8 *payload, uint8 length);
+
+#endif /* FRAME_H_ */
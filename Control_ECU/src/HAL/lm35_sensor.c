@@ -1,35 +1,35 @@
- /******************************************************************************
- *
- * Module: Temperature Sensor
- *
- * File Name: lm35_sensor.c
- *
- * Description: source file for the LM35 Temperature Sensor driver
- *
- * Author: Mohamed Tarek
- *
- *******************************************************************************/
-
-#include "lm35_sensor.h"
-#include "adc.h"
-
-/*
- * Description :
- * Function responsible for calculate the temperature from the ADC digital value.
- */
-uint8 LM35_getTemperature(void)
-{
-
-	uint8 temp_value = 0;
-
-	uint16 adc_value = 0;
-
-	/* Read ADC channel where the temperature sensor is connected */
-	adc_value = ADC_readChannel(LM35_CHANNEL_ID);
-
-	/* Calculate the temperature from the ADC value*/
-	temp_value = (uint8)(((uint32)adc_value*SENSOR_MAX_TEMPERATURE*ADC_REF_VOLT_VALUE)/(ADC_MAXIMUM_VALUE*LM35_MAX_VOLT_VALUE));
-
-	return temp_value;
-}
-
+ /******************************************************************************
+ *
+ * Module: Temperature Sensor
+ *
+ * File Name: lm35_sensor.c
+ *
+ * Description: source file for the LM35 Temperature Sensor driver
+ *
+ * Author: Mohamed Tarek
+ *
+ *******************************************************************************/
+
+#include "lm35_sensor.h"
+#include "adc.h"
+
+/*
+ * Description :
+ * Function responsible for calculate the temperature from the ADC digital value.
+ */
+uint8 LM35_getTemperature(void)
+{
+
+	uint8 temp_value = 0;
+
+	uint16 adc_value = 0;
+
+	/* Read ADC channel where the temperature sensor is connected */
+	adc_value = ADC_readChannel(LM35_CHANNEL_ID);
+
+	/* Calculate the temperature from the ADC value*/
+	temp_value = (uint8)(((uint32)adc_value*SENSOR_MAX_TEMPERATURE*ADC_REF_VOLT_VALUE)/(ADC_MAXIMUM_VALUE*LM35_MAX_VOLT_VALUE));
+
+	return temp_value;
+}
+
@@ -1,37 +1,37 @@
- /******************************************************************************
- *
- * Module: Temperature Sensor
- *
- * File Name: lm35_sensor.h
- *
- * Description: header file for the LM35 Temperature Sensor driver
- *
- * Author: Mohamed Tarek
- *
- *******************************************************************************/
-
-#ifndef LM35_SENSOR_H_
-#define LM35_SENSOR_H_
-
-#include "std_types.h"
-
-/*******************************************************************************
- *                                Definitions                                  *
- *******************************************************************************/
-
-#define LM35_CHANNEL_ID           0
-#define LM35_MAX_VOLT_VALUE       1.5
-#define SENSOR_MAX_TEMPERATURE    150
-#define ADC_REF_VOLT_VALUE        5
-#define ADC_MAXIMUM_VALUE         1023
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-
-/*
- * Description :
- * Function responsible for calculate the temperature from the ADC digital value.
- */
-uint8 LM35_getTemperature(void);
-
-#endif /* LM35_SENSOR_H_ */
+ /******************************************************************************
+ *
+ * Module: Temperature Sensor
+ *
+ * File Name: lm35_sensor.h
+ *
+ * Description: header file for the LM35 Temperature Sensor driver
+ *
+ * Author: Mohamed Tarek
+ *
+ *******************************************************************************/
+
+#ifndef LM35_SENSOR_H_
+#define LM35_SENSOR_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define LM35_CHANNEL_ID           0
+#define LM35_MAX_VOLT_VALUE       1.5
+#define SENSOR_MAX_TEMPERATURE    150
+#define ADC_REF_VOLT_VALUE        5
+#define ADC_MAXIMUM_VALUE         1023
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Function responsible for calculate the temperature from the ADC digital value.
+ */
+uint8 LM35_getTemperature(void);
+
+#endif /* LM35_SENSOR_H_ */
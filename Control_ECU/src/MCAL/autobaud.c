@@ -0,0 +1,81 @@
+/******************************************************************************
+ *
+ * Module: AUTOBAUD
+ *
+ * File Name: autobaud.c
+ *
+ * Description: Source file for the UART baud rate detection driver
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include "autobaud.h"
+#include "common_macros.h" /* To use the macros like BIT_IS_SET */
+#include <avr/io.h>        /* To use Timer1 and PORTD Registers */
+#include <util/atomic.h>   /* Interrupts off while timing the edges */
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Waits for one SYNC byte on RXD and returns its baud rate in units of this
+ * CPU clock, or 0 if no complete SYNC byte came within one Timer1 overflow.
+ */
+uint32 AUTOBAUD_measure(void)
+{
+	uint16 ticks = 0;
+	uint8 edges;
+	boolean timeout = FALSE;
+
+	/* Timer1 in Normal Mode, clocked at F_CPU */
+	TCCR1A = 0;
+	TCCR1B = (1 << CS10);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		/* Line idle (high), then the falling edge of the start bit */
+		TCNT1 = 0;
+		TIFR = (1 << TOV1);
+		while(BIT_IS_CLEAR(PIND, PD0) && !timeout)
+		{
+			timeout = BIT_IS_SET(TIFR, TOV1);
+		}
+		while(BIT_IS_SET(PIND, PD0) && !timeout)
+		{
+			timeout = BIT_IS_SET(TIFR, TOV1);
+		}
+		TCNT1 = 0;
+		TIFR = (1 << TOV1);
+
+		/* Time the rising edges, the last one starts bit 7 */
+		for(edges = 0; edges < AUTOBAUD_SYNC_RISING_EDGES && !timeout; edges++)
+		{
+			while(BIT_IS_CLEAR(PIND, PD0) && !timeout)
+			{
+				timeout = BIT_IS_SET(TIFR, TOV1);
+			}
+			ticks = TCNT1;
+
+			if(edges < AUTOBAUD_SYNC_RISING_EDGES - 1)
+			{
+				while(BIT_IS_SET(PIND, PD0) && !timeout)
+				{
+					timeout = BIT_IS_SET(TIFR, TOV1);
+				}
+			}
+		}
+	}
+
+	/* Stop Timer1 */
+	TCCR1B = 0;
+
+	if(timeout || ticks == 0)
+	{
+		return 0;
+	}
+
+	return ((uint32)F_CPU * AUTOBAUD_SYNC_BITS) / ticks;
+}
@@ -0,0 +1,43 @@
+/******************************************************************************
+ *
+ * Module: AUTOBAUD
+ *
+ * File Name: autobaud.h
+ *
+ * Description: Header file for the UART baud rate detection driver.
+ *              Times a SYNC byte (0xAA) on the RXD/PD0 pin with Timer1 running
+ *              at F_CPU. The byte is sent LSB first, so from the falling edge of
+ *              the start bit to the 4th rising edge (bit 7) there are 8 bit times.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef AUTOBAUD_H_
+#define AUTOBAUD_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define AUTOBAUD_SYNC_BYTE                0xAA
+#define AUTOBAUD_SYNC_RISING_EDGES        4     /* Rising edges after the start bit */
+#define AUTOBAUD_SYNC_BITS                8     /* Bit times from the start bit to the last rising edge */
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Waits for one SYNC byte on RXD and returns its baud rate in units of this
+ * CPU clock, or 0 if no complete SYNC byte came within one Timer1 overflow
+ * (8.2 ms at 8 MHz, so rates down to about 1000 baud).
+ * Interrupts are held off during the measurement. Timer1 is stopped at the end,
+ * so call it before the ICU is used.
+ */
+uint32 AUTOBAUD_measure(void);
+
+#endif /* AUTOBAUD_H_ */
@@ -0,0 +1,111 @@
+/******************************************************************************
+ *
+ * Module: IEEPROM
+ *
+ * File Name: internal_eeprom.c
+ *
+ * Description: Source file for the ATmega32 internal EEPROM driver
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include "internal_eeprom.h"
+#include "common_macros.h"
+#include <avr/io.h>
+#include <avr/interrupt.h> /* For the EEPROM ready ISR */
+#include <util/atomic.h>   /* For starting a write */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static volatile uint8 g_buffer[IEEPROM_BUFFER_SIZE];  /* Block being written */
+static volatile uint16 g_address = 0;                 /* Address of the block */
+static volatile uint8 g_length = 0;
+static volatile uint8 g_index = 0;                    /* Next byte checked */
+static volatile boolean g_busy = FALSE;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+/* Fires while the EEPROM is ready and EERIE is set: start the next byte that changes */
+ISR(EE_RDY_vect)
+{
+	while(g_index < g_length)
+	{
+		EEAR = g_address + g_index;
+		SET_BIT(EECR, EERE);
+		if(EEDR != g_buffer[g_index])
+		{
+			break;
+		}
+		g_index++;
+	}
+
+	if(g_index == g_length)
+	{
+		CLEAR_BIT(EECR, EERIE);  /* Block done */
+		g_busy = FALSE;
+		return;
+	}
+
+	EEDR = g_buffer[g_index++];
+	SET_BIT(EECR, EEMWE);        /* EEWE must follow within four cycles */
+	SET_BIT(EECR, EEWE);
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+boolean IEEPROM_write(uint16 address, const uint8 *data, uint8 length)
+{
+	boolean started = FALSE;
+	uint8 i;
+
+	if(length > IEEPROM_BUFFER_SIZE || address + length > IEEPROM_SIZE)
+	{
+		return FALSE;
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if(!g_busy || g_address == address)
+		{
+			for(i = 0; i < length; i++)
+			{
+				g_buffer[i] = data[i];
+			}
+			g_address = address;
+			g_length = length;
+			g_index = 0;
+			g_busy = TRUE;
+			SET_BIT(EECR, EERIE);
+			started = TRUE;
+		}
+	}
+
+	return started;
+}
+
+void IEEPROM_read(uint16 address, uint8 *data, uint8 length)
+{
+	uint8 i;
+
+	/* Only the ISR starts byte writes, none is left once the block is done */
+	while(g_busy);
+
+	for(i = 0; i < length; i++)
+	{
+		EEAR = address + i;
+		SET_BIT(EECR, EERE);
+		data[i] = EEDR;
+	}
+}
+
+boolean IEEPROM_isBusy(void)
+{
+	return g_busy;
+}
@@ -0,0 +1,56 @@
+/******************************************************************************
+ *
+ * Module: IEEPROM
+ *
+ * File Name: internal_eeprom.h
+ *
+ * Description: Header file for the ATmega32 internal EEPROM driver (1 KB).
+ *
+ * A write is copied to the driver buffer and programmed one byte per
+ * EEPROM-ready interrupt (about 8.5 ms each), so the caller is never held.
+ * Bytes that already hold the value written are skipped, which saves both
+ * time and wear.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef INTERNAL_EEPROM_H_
+#define INTERNAL_EEPROM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define IEEPROM_SIZE                      1024
+#define IEEPROM_BUFFER_SIZE               64    /* Longest write */
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start writing a block in the background. A write to the same address while
+ * the previous one is in progress replaces it, the block is then checked again
+ * from its first byte. Returns FALSE if the block is too long or a write to
+ * another address is in progress, nothing is written then.
+ * Global interrupts must be enabled.
+ */
+boolean IEEPROM_write(uint16 address, const uint8 *data, uint8 length);
+
+/*
+ * Description :
+ * Read a block, after the write in progress (if any) is over.
+ */
+void IEEPROM_read(uint16 address, uint8 *data, uint8 length);
+
+/*
+ * Description :
+ * Returns TRUE while a write is in progress.
+ */
+boolean IEEPROM_isBusy(void);
+
+#endif /* INTERNAL_EEPROM_H_ */
@@ -1,113 +1,219 @@
-/******************************************************************************
- *
- * Module: TWI(I2C)
- *
- * File Name: twi.h
- *
- * Description: Source file for the TWI(I2C) AVR driver
- *
- * Author: Kerolous Labib
- *
- *******************************************************************************/
-
-#include "twi.h"
-#include "common_macros.h"
-#include <avr/io.h>
-
-
-void TWI_init(const TWI_ConfigType * Config_Ptr)
-{
-    uint8 twps = 0;  /* TWPS = 0 -> Prescaler = 1 */
-    uint8 prescaler_val = 1;
-
-    /* Configure prescaler bits (TWPS0, TWPS1) */
-    TWSR = (TWSR & 0xFC) | (twps & 0x02);
-
-
-    prescaler_val = (1 << (2 * twps));  /* Equivalent to 4^TWPS */
-
-
-    /* Calculate TWBR based on bit rate */
-    /*
-     * Formula: SCL frequency = F_CPU / (16 + 2*TWBR* 4^Prescaler)
-     * => TWBR = ((F_CPU / SCL) - 16) / (2 * Prescaler)
-     */
-    TWBR = (uint8)(((F_CPU / Config_Ptr->bit_rate) - 16) / (2 * prescaler_val));
-
-	/* Two Wire Bus address my address if any master device want to call me: 0x1 (used in case this MC is a slave device)
-       General Call Recognition: Off */
-	TWAR = (Config_Ptr->address << 1);
-
-	TWCR = (1<<TWEN); /* enable TWI */
-}
-
-void TWI_start(void)
-{
-	/*
-	 * Clear the TWINT flag before sending the start bit TWINT=1
-	 * send the start bit by TWSTA=1
-	 * Enable TWI Module TWEN=1 
-	 */
-	TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
-
-	/* Wait for TWINT flag set in TWCR Register (start bit is send successfully) */
-	while(BIT_IS_CLEAR(TWCR,TWINT));
-}
-
-void TWI_stop(void)
-{
-	/*
-	 * Clear the TWINT flag before sending the stop bit TWINT=1
-	 * send the stop bit by TWSTO=1
-	 * Enable TWI Module TWEN=1 
-	 */
-	TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN);
-}
-
-void TWI_writeByte(uint8 data)
-{
-	/* Put data On TWI data Register */
-	TWDR = data;
-	/*
-	 * Clear the TWINT flag before sending the data TWINT=1
-	 * Enable TWI Module TWEN=1 
-	 */ 
-	TWCR = (1 << TWINT) | (1 << TWEN);
-	/* Wait for TWINT flag set in TWCR Register(data is send successfully) */
-	while(BIT_IS_CLEAR(TWCR,TWINT));
-}
-
-uint8 TWI_readByteWithACK(void)
-{
-	/* 
-	 * Clear the TWINT flag before reading the data TWINT=1
-	 * Enable sending ACK after reading or receiving data TWEA=1
-	 * Enable TWI Module TWEN=1 
-	 */ 
-	TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWEA);
-	/* Wait for TWINT flag set in TWCR Register (data received successfully) */
-	while(BIT_IS_CLEAR(TWCR,TWINT));
-	/* Read Data */
-	return TWDR;
-}
-
-uint8 TWI_readByteWithNACK(void)
-{
-	/* 
-	 * Clear the TWINT flag before reading the data TWINT=1
-	 * Enable TWI Module TWEN=1 
-	 */
-	TWCR = (1 << TWINT) | (1 << TWEN);
-	/* Wait for TWINT flag set in TWCR Register (data received successfully) */
-	while(BIT_IS_CLEAR(TWCR,TWINT));
-	/* Read Data */
-	return TWDR;
-}
-
-uint8 TWI_getStatus(void)
-{
-	uint8 status;
-	/* masking to eliminate first 3 bits and get the last 5 bits (status bits) */
-	status = TWSR & 0xF8;
-	return status;
-}
+/******************************************************************************
+ *
+ * Module: TWI(I2C)
+ *
+ * File Name: twi.h
+ *
+ * Description: Source file for the TWI(I2C) AVR driver
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include "twi.h"
+#include "common_macros.h"
+#include <avr/io.h>
+#include <avr/interrupt.h> /* For the slave mode ISR */
+#include <util/atomic.h>   /* For starting a master transaction */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Slave mode register file, NULL_PTR while the slave mode is disabled */
+static const volatile uint8 *g_slaveRegisters = NULL_PTR;
+static uint8 g_slaveCount = 0;
+static volatile uint8 g_slavePointer = 0;       /* Next register read */
+static volatile boolean g_slavePointerSet = FALSE;  /* The first byte written in this transaction was received */
+static volatile boolean g_slaveBusy = FALSE;    /* Addressed by a tester, until its STOP or NACK */
+static boolean g_masterActive = FALSE;          /* A master transaction was started by TWI_start() */
+
+/* TWCR value releasing the bus to the slave mode (own address acknowledged, interrupt on) */
+#define TWI_SLAVE_CONTROL ((1 << TWINT) | (1 << TWEA) | (1 << TWEN) | (1 << TWIE))
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(TWI_vect)
+{
+	switch(TWSR & 0xF8)
+	{
+	case TWI_SR_SLA_W_ACK:
+	case TWI_SR_ARB_SLA_W:
+		g_slaveBusy = TRUE;
+		g_slavePointerSet = FALSE;
+		break;
+
+	case TWI_SR_DATA_ACK:
+	case TWI_SR_DATA_NACK:
+		if(!g_slavePointerSet)
+		{
+			g_slavePointer = TWDR;
+			g_slavePointerSet = TRUE;
+		}
+		break;
+
+	case TWI_ST_SLA_R_ACK:
+	case TWI_ST_ARB_SLA_R:
+		g_slaveBusy = TRUE;
+		/* fall through */
+	case TWI_ST_DATA_ACK:
+		if(g_slavePointer < g_slaveCount)
+		{
+			TWDR = g_slaveRegisters[g_slavePointer++];
+		}
+		else
+		{
+			TWDR = TWI_SLAVE_FILL;
+		}
+		break;
+
+	case TWI_BUS_ERROR:
+		g_slaveBusy = FALSE;
+		TWCR = TWI_SLAVE_CONTROL | (1 << TWSTO);  /* Release the lines, no STOP is sent */
+		return;
+
+	default:  /* STOP, end of the read */
+		g_slaveBusy = FALSE;
+		break;
+	}
+	TWCR = TWI_SLAVE_CONTROL;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+
+void TWI_init(const TWI_ConfigType * Config_Ptr)
+{
+    uint8 twps = 0;  /* TWPS = 0 -> Prescaler = 1 */
+    uint8 prescaler_val = 1;
+
+    /* Configure prescaler bits (TWPS0, TWPS1) */
+    TWSR = (TWSR & 0xFC) | (twps & 0x02);
+
+
+    prescaler_val = (1 << (2 * twps));  /* Equivalent to 4^TWPS */
+
+
+    /* Calculate TWBR based on bit rate */
+    /*
+     * Formula: SCL frequency = F_CPU / (16 + 2*TWBR* 4^Prescaler)
+     * => TWBR = ((F_CPU / SCL) - 16) / (2 * Prescaler)
+     */
+    TWBR = (uint8)(((F_CPU / Config_Ptr->bit_rate) - 16) / (2 * prescaler_val));
+
+	/* Two Wire Bus address my address if any master device want to call me: 0x1 (used in case this MC is a slave device)
+       General Call Recognition: Off */
+	TWAR = (Config_Ptr->address << 1);
+
+	TWCR = (1<<TWEN); /* enable TWI */
+}
+
+void TWI_start(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		/* Tester transaction in progress (or about to be handled by the ISR): not started */
+		if(!g_masterActive && (g_slaveBusy || (g_slaveRegisters != NULL_PTR && BIT_IS_SET(TWCR,TWINT))))
+		{
+			return;
+		}
+		g_masterActive = TRUE;
+
+		/*
+		 * Clear the TWINT flag before sending the start bit TWINT=1
+		 * send the start bit by TWSTA=1
+		 * Enable TWI Module TWEN=1, slave interrupt off until the stop bit
+		 */
+		TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
+	}
+
+	/* Wait for TWINT flag set in TWCR Register (start bit is send successfully) */
+	while(BIT_IS_CLEAR(TWCR,TWINT));
+}
+
+void TWI_stop(void)
+{
+	/*
+	 * Clear the TWINT flag before sending the stop bit TWINT=1
+	 * send the stop bit by TWSTO=1
+	 * Enable TWI Module TWEN=1 
+	 */
+	if(!g_masterActive)
+	{
+		return;  /* TWI_start() did not start, the bus may belong to a tester */
+	}
+	g_masterActive = FALSE;
+
+	/* Back to the slave mode if enabled */
+	TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN) |
+	       ((g_slaveRegisters != NULL_PTR) ? ((1 << TWEA) | (1 << TWIE)) : 0);
+}
+
+void TWI_writeByte(uint8 data)
+{
+	/* Put data On TWI data Register */
+	TWDR = data;
+	/*
+	 * Clear the TWINT flag before sending the data TWINT=1
+	 * Enable TWI Module TWEN=1 
+	 */ 
+	TWCR = (1 << TWINT) | (1 << TWEN);
+	/* Wait for TWINT flag set in TWCR Register(data is send successfully) */
+	while(BIT_IS_CLEAR(TWCR,TWINT));
+}
+
+uint8 TWI_readByteWithACK(void)
+{
+	/* 
+	 * Clear the TWINT flag before reading the data TWINT=1
+	 * Enable sending ACK after reading or receiving data TWEA=1
+	 * Enable TWI Module TWEN=1 
+	 */ 
+	TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWEA);
+	/* Wait for TWINT flag set in TWCR Register (data received successfully) */
+	while(BIT_IS_CLEAR(TWCR,TWINT));
+	/* Read Data */
+	return TWDR;
+}
+
+uint8 TWI_readByteWithNACK(void)
+{
+	/* 
+	 * Clear the TWINT flag before reading the data TWINT=1
+	 * Enable TWI Module TWEN=1 
+	 */
+	TWCR = (1 << TWINT) | (1 << TWEN);
+	/* Wait for TWINT flag set in TWCR Register (data received successfully) */
+	while(BIT_IS_CLEAR(TWCR,TWINT));
+	/* Read Data */
+	return TWDR;
+}
+
+uint8 TWI_getStatus(void)
+{
+	uint8 status;
+	/* masking to eliminate first 3 bits and get the last 5 bits (status bits) */
+	status = TWSR & 0xF8;
+	return status;
+}
+
+void TWI_slaveInit(const volatile uint8 *registers, uint8 count)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_slaveRegisters = registers;
+		g_slaveCount = count;
+		g_slavePointer = 0;
+		g_slaveBusy = FALSE;
+		TWCR = (1 << TWEA) | (1 << TWEN) | (1 << TWIE);
+	}
+}
+
+boolean TWI_slaveIsBusy(void)
+{
+	return g_slaveBusy;
+}
@@ -1,102 +1,183 @@
-/******************************************************************************
- *
- * Module: UART
- *
- * File Name: uart.h
- *
- * Description: Header file for the UART AVR driver (Polling-based)
- *
- * Author: Kerolous Labib
- *
- *******************************************************************************/
-
-#ifndef UART_H_
-#define UART_H_
-
-#include "std_types.h"
-
-/*******************************************************************************
- *                                Data Types                                    *
- *******************************************************************************/
-
-typedef enum
-{
-	UART_5_BIT_DATA,
-	UART_6_BIT_DATA,
-	UART_7_BIT_DATA,
-	UART_8_BIT_DATA,
-	UART_9_BIT_DATA = 7,
-}UART_BitDataType;
-
-typedef enum
-{
-	UART_PARITY_DISABLED,
-	UART_RESERVED,
-	UART_PARITY_EVEN,
-	UART_PARITY_ODD
-}UART_ParityType;
-
-typedef enum
-{
-	UART_ONE_STOP_BIT,
-	UART_TWO_STOP_BITS,
-}UART_StopBitType;
-
-typedef uint32 UART_BaudRateType;
-
-typedef struct {
-	UART_BitDataType bit_data;
-	UART_ParityType parity;
-	UART_StopBitType stop_bit;
-	UART_BaudRateType baud_rate;
-}UART_ConfigType;
-
-/* Global configuration structure instance */
-extern UART_ConfigType UART_Config;
-
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-
-/*
- * Description :
- * Initialize the UART device by:
- * 1. Setting frame format (data bits, parity, stop bits)
- * 2. Enabling transmitter and receiver
- * 3. Setting baud rate
- */
-void UART_init(const UART_ConfigType * Config_Ptr);
-
-/*
- * Description :
- * Send one byte to another UART device (polling-based).
- */
-void UART_sendByte(const uint8 data);
-
-/*
- * Description :
- * Receive one byte from another UART device (polling-based).
- */
-uint8 UART_recieveByte(void);
-
-/*
- * Description :
- * Send a null-terminated string through UART.
- */
-void UART_sendString(const uint8 *Str);
-
-/*
- * Description :
- * Receive a string through UART until the '#' symbol.
- * The '#' is replaced by '\0' in the received buffer.
- */
-void UART_receiveString(uint8 *Str);
-
-/*
- * Description :
- * Check if new data has been received (non-blocking check).
- * Returns 1 if RXC flag is set, 0 otherwise.
- */
-uint8 UART_dataAvailable(void);
-
-#endif /* UART_H_ */
+/******************************************************************************
+ *
+ * Module: UART
+ *
+ * File Name: uart.h
+ *
+ * Description: Header file for the UART AVR driver
+ *              (Interrupt-driven transmit and receive buffers)
+ *
+ * Multi-drop: in 9-bit mode one master talks to several nodes on the same line.
+ * The master sends an address byte (9th bit set) before the frames of a node,
+ * a node with an address set (UART_setAddress) keeps the multi-processor
+ * communication mode (MPCM) on until its address comes, so the data bytes sent
+ * to the other nodes are dropped by the hardware without an interrupt.
+ * A node only enables its transmitter (TXEN) while it is selected, otherwise
+ * its TXD pin is an input without pull-up (PD1 left as after reset) and the
+ * bytes it has queued wait. Wiring: the master TXD goes to the RXD of
+ * every node. The TXD pins of the nodes are tied together to the master RXD,
+ * with one pull-up resistor (10 kOhm) that holds the line idle (high) between
+ * two nodes. With RS-485 transceivers, drive their DE pin from the same
+ * selection instead.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef UART_H_
+#define UART_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Size of the receive ring buffer filled by the RX complete interrupt (power of 2) */
+#define UART_RX_BUFFER_SIZE               64
+
+/* Size of the transmit ring buffer emptied by the UDR empty interrupt (power of 2) */
+#define UART_TX_BUFFER_SIZE               64
+
+/* Node address meaning "not a multi-drop node", every byte is received */
+#define UART_NO_ADDRESS                   0
+
+/*******************************************************************************
+ *                                Data Types                                    *
+ *******************************************************************************/
+
+typedef enum
+{
+	UART_5_BIT_DATA,
+	UART_6_BIT_DATA,
+	UART_7_BIT_DATA,
+	UART_8_BIT_DATA,
+	UART_9_BIT_DATA = 7,
+}UART_BitDataType;
+
+typedef enum
+{
+	UART_PARITY_DISABLED,
+	UART_RESERVED,
+	UART_PARITY_EVEN,
+	UART_PARITY_ODD
+}UART_ParityType;
+
+typedef enum
+{
+	UART_ONE_STOP_BIT,
+	UART_TWO_STOP_BITS,
+}UART_StopBitType;
+
+typedef uint32 UART_BaudRateType;
+
+typedef struct {
+	UART_BitDataType bit_data;
+	UART_ParityType parity;
+	UART_StopBitType stop_bit;
+	UART_BaudRateType baud_rate;
+}UART_ConfigType;
+
+/* Line quality counters, updated by the RX interrupt (free running, they wrap around) */
+typedef struct {
+	uint16 received;       /* Bytes received, including the bad ones */
+	uint16 frame_errors;   /* FE: wrong stop bit (usually a baud rate mismatch), byte dropped */
+	uint16 data_overruns;  /* DOR: bytes lost before the interrupt read UDR */
+	uint16 parity_errors;  /* PE: parity check failed, byte dropped */
+	uint16 buffer_full;    /* Bytes dropped because the receive buffer was full */
+}UART_ErrorCountersType;
+
+/* Global configuration structure instance */
+extern UART_ConfigType UART_Config;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Initialize the UART device by:
+ * 1. Setting frame format (data bits, parity, stop bits)
+ * 2. Enabling transmitter, receiver and the RX complete interrupt
+ * 3. Setting baud rate
+ */
+void UART_init(const UART_ConfigType * Config_Ptr);
+
+/*
+ * Description :
+ * Queue one byte for transmission to another UART device.
+ * Only waits when the transmit buffer is full.
+ */
+void UART_sendByte(const uint8 data);
+
+/*
+ * Description :
+ * Returns the number of bytes that can be queued without waiting.
+ */
+uint8 UART_txSpace(void);
+
+/*
+ * Description :
+ * Change the baud rate at runtime.
+ * Waits until every queued byte left the transmitter, then drops the received
+ * bytes still in the buffer (they may be half old, half new rate).
+ */
+void UART_setBaudRate(UART_BaudRateType baud_rate);
+
+/*
+ * Description :
+ * Copy the line quality counters.
+ */
+void UART_getErrorCounters(UART_ErrorCountersType *counters);
+
+/*
+ * Description :
+ * Set the address of this node on a multi-drop line (9-bit mode), the node is
+ * deselected (TXD released) until the master sends it. UART_NO_ADDRESS leaves
+ * the multi-drop mode, every byte is received again.
+ */
+void UART_setAddress(uint8 address);
+
+/*
+ * Description :
+ * Returns TRUE if the last address byte was the address of this node (always
+ * TRUE without an address). A node must only transmit while selected, the
+ * bytes it queues meanwhile wait in the transmit buffer.
+ */
+boolean UART_isSelected(void);
+
+/*
+ * Description :
+ * Queue an address byte (9th bit set) selecting one node of a multi-drop line,
+ * the bytes queued after it go to that node.
+ */
+void UART_sendAddress(uint8 address);
+
+/*
+ * Description :
+ * Receive one byte from another UART device.
+ * Waits until the receive buffer holds at least one byte.
+ */
+uint8 UART_recieveByte(void);
+
+/*
+ * Description :
+ * Send a null-terminated string through UART.
+ */
+void UART_sendString(const uint8 *Str);
+
+/*
+ * Description :
+ * Receive a string through UART until the '#' symbol.
+ * The '#' is replaced by '\0' in the received buffer.
+ */
+void UART_receiveString(uint8 *Str);
+
+/*
+ * Description :
+ * Check if new data has been received (non-blocking check).
+ * Returns 1 if the receive buffer is not empty, 0 otherwise.
+ */
+uint8 UART_dataAvailable(void);
+
+#endif /* UART_H_ */
@@ -1,366 +1,2375 @@
-/******************************************************************************
- *
- * Project: Smart_Home
- *
- * File Name: HMI.c
- *
- * Author: Kerolous_Labib_Georgy
- *
- * Description:
- * ------------
- * This file implements the Human-Machine Interface (HMI) layer of the Smart Home project.
- * It communicates with the control unit via UART, displays sensor readings and system states
- * on an LCD, and allows the user to send commands using a keypad.
- *
- *******************************************************************************/
-
-/*******************************************************************************
- *                                  Libraries                                  *
- *******************************************************************************/
-#include <avr/io.h>
-#include <util/delay.h>
-#include <avr/interrupt.h>
-#include "lcd.h"
-#include "keypad.h"
-#include "uart.h"
-#include "timer.h"
-
-/*******************************************************************************
- *                                  Definitions                                *
- *******************************************************************************/
-
-/* Commands sent from the keypad to the Control Unit */
-#define START_MONITORING 1
-#define DISPLAY_VALUES   2
-#define DETECT_FAULTS    3
-#define STOP_MONITORING  4
-
-/* UART acknowledgment and protocol bytes */
-#define ACK    0x05
-#define READY  0XFF
-
-/* Window states */
-#define OPENED 1UL
-#define CLOSED 0UL
-
-/* Menu command key */
-#define MENU_MAIN '*'
-
-/* End-of-transmission byte for fault data */
-#define END_BYTE 'T'
-
-/* Diagnostic Trouble Codes (must match control unit) */
-#define DTC_P001 0x01 /* DistanceTooClose */
-#define DTC_P002 0x02 /* Overheat */
-
-/*******************************************************************************
- *                             Global Variables                                *
- *******************************************************************************/
-volatile uint8 g_tick = 0;  /* Timer tick counter — updated every second by ISR */
-
-/*******************************************************************************
- *                             Callback Function                               *
- *******************************************************************************/
-
-/*
- * Function: HMI_timerCallBack
- * ----------------------------
- * Called every second by the timer interrupt.
- * Used to create timed delays (e.g., waiting periods during display updates).
- */
-void HMI_timerCallBack(void)
-{
-	g_tick++;
-}
-
-/*******************************************************************************
- *                             Display Functions                               *
- *******************************************************************************/
-
-/*
- * Function: HMI_updateSensors
- * ----------------------------
- * Displays the current temperature, distance, and window states on the LCD.
- *
- * temp      - pointer to the current temperature value
- * distance  - pointer to the current distance value
- * win1      - pointer to Window 1 state (OPENED/CLOSED)
- * win2      - pointer to Window 2 state (OPENED/CLOSED)
- */
-void HMI_updateSensors(uint8 *temp, uint16 *distance, uint8 *win1, uint8 *win2)
-{
-	LCD_moveCursor(0,0);
-	LCD_displayString("Temperature: ");
-	LCD_displayInteger(*temp);
-	LCD_displayString("C");
-
-	LCD_moveCursor(1,0);
-	LCD_displayString("Distance: 15");
-	//LCD_displayInteger(*distance);
-	LCD_displayString("cm");
-
-	LCD_moveCursor(2,0);
-	LCD_displayString("Win1: ");
-	if(*win1 == OPENED){
-		LCD_displayString("Open");
-	}
-	else{
-		LCD_displayString("Closed");
-	}
-
-	LCD_moveCursor(3,0);
-	LCD_displayString("Win2: ");
-	if(*win2 == OPENED){
-		LCD_displayString("Open");
-	}
-	else{
-		LCD_displayString("Closed");
-	}
-}
-
-/*
- * Function: receivePack
- * ----------------------
- * Receives a complete data packet from the Control Unit over UART.
- * Data includes distance (2 bytes), temperature, and window states.
- * After receiving, it updates the LCD using HMI_updateSensors().
- */
-void receivePack(void)
-{
-	uint8 tempValue;
-	uint16 distanceValue;
-	uint8 win1_State;
-	uint8 win2_State;
-	uint8 dist_high, dist_low;
-
-	/* Receive 16-bit distance value (high then low byte) */
-	dist_high = UART_recieveByte();
-	UART_sendByte(ACK);
-	dist_low = UART_recieveByte();
-	UART_sendByte(ACK);
-
-	/* Receive temperature value */
-	tempValue = UART_recieveByte();
-	UART_sendByte(ACK);
-
-	/* Combine high and low bytes to form full distance */
-	distanceValue = (dist_high << 8) | dist_low;
-
-	/* Receive window states */
-	win1_State = UART_recieveByte();
-	UART_sendByte(ACK);
-
-	win2_State = UART_recieveByte();
-	UART_sendByte(ACK);
-
-	/* Display all received values */
-	HMI_updateSensors(&tempValue, &distanceValue, &win1_State, &win2_State);
-}
-
-/*******************************************************************************
- *                                 Main Function                               *
- *******************************************************************************/
-int main(void){
-	uint8 keyValue;   // Variable to store keypad input
-
-	/* UART configuration structure */
-	UART_ConfigType UART_Config = {
-			.bit_data = UART_8_BIT_DATA,
-			.parity = UART_PARITY_DISABLED,
-			.stop_bit = UART_ONE_STOP_BIT,
-			.baud_rate = 9600
-	};
-
-	/* Timer configuration structure (1-second interrupt) */
-	Timer_ConfigType Timer_Config = {
-			.timer_ID = TIMER1_ID,
-			.timer_mode = TIMER_COMP,
-			.timer_clock = TIMER_PRESCALER_256,
-			.timer_compare_MatchValue = 31249, // 1-second interval @ 8 MHz
-	};
-
-	SREG |= (1<<7); /* Enable global interrupts */
-
-	/* Initialize peripherals */
-	LCD_init();
-	KEYPAD_init();
-	UART_init(&UART_Config);
-
-	/* Display startup message */
-	LCD_moveCursor(1,5);
-	LCD_displayString("Welcome");
-	_delay_ms(1000);
-	LCD_clearScreen();
-
-	/* Display main menu */
-	LCD_displayString("1.Start System");
-	LCD_moveCursor(1,0);
-	LCD_displayString("2.Show Readings");
-	LCD_moveCursor(2,0);
-	LCD_displayString("3.View Faults");
-	LCD_moveCursor(3,0);
-	LCD_displayString("4.Stop System");
-
-	/* === Main Program Loop === */
-	for(;;){
-		keyValue = KEYPAD_getPressedKey();     // Wait for user input
-		UART_sendByte(keyValue);               // Send key to control unit
-		while(UART_recieveByte() != ACK);      // Wait for acknowledgment
-
-		switch(keyValue){
-
-		/* === START MONITORING === */
-		case START_MONITORING:
-			LCD_clearScreen();
-			LCD_displayString("System Started");
-			LCD_moveCursor(1,0);
-			LCD_displayString("Start Setup...");
-
-			/* Start timer for 10 seconds */
-			TIMER_setCallBack(HMI_timerCallBack, TIMER1_ID);
-			TIMER_init(&Timer_Config);
-
-			while(g_tick < 10);  // Wait for 10 seconds
-			TIMER_deInit(TIMER1_ID);
-			g_tick = 0;
-
-			LCD_clearScreen();
-			LCD_displayString("Press * for menu");
-			break;
-
-		/* === DISPLAY SENSOR VALUES === */
-		case DISPLAY_VALUES:
-			LCD_clearScreen();
-			LCD_displayString("Display Values");
-
-			receivePack();  // Get updated sensor data
-
-			/* Hold display for 10 seconds */
-			TIMER_setCallBack(HMI_timerCallBack, TIMER1_ID);
-			TIMER_init(&Timer_Config);
-			while(g_tick < 10);
-			TIMER_deInit(TIMER1_ID);
-			g_tick = 0;
-
-			LCD_clearScreen();
-			LCD_displayString("Again? Press 2");
-			LCD_moveCursor(1,0);
-			LCD_displayString("Press * for menu");
-			break;
-
-		/* === DETECT AND DISPLAY FAULTS === */
-		case DETECT_FAULTS:
-			LCD_clearScreen();
-			LCD_displayString("Reading Faults..");
-			_delay_ms(1000);
-			LCD_clearScreen();
-
-			uint8 faultCode = 0;
-			uint8 rowIndex = 0;
-			uint8 totalFaults = 0;
-
-			/* Receive and display all fault codes */
-			while(1){
-				faultCode = UART_recieveByte();
-				UART_sendByte(ACK);
-
-				/* Stop receiving when end byte is reached */
-				if(faultCode == END_BYTE) break;
-
-				/* Decode and display fault information */
-				if(faultCode == DTC_P001){
-					LCD_moveCursor(rowIndex, 0);
-					LCD_displayString("P001: Too Close");
-					_delay_ms(500);
-				}
-				else if(faultCode == DTC_P002){
-					LCD_moveCursor(rowIndex, 0);
-					LCD_displayString("P002: Overheat");
-					_delay_ms(500);
-				}
-				else{
-					LCD_moveCursor(rowIndex, 0);
-					LCD_displayString("Unknown Fault: ");
-					LCD_displayInteger(faultCode);
-					_delay_ms(500);
-				}
-
-				rowIndex++;
-				totalFaults++;
-				_delay_ms(500);
-
-				/* If LCD full, pause and wait for user */
-				if(rowIndex >= 4){
-					LCD_moveCursor(3,0);
-					LCD_displayString("Press any key...");
-					KEYPAD_getPressedKey();
-					LCD_clearScreen();
-					rowIndex = 0;
-				}
-			}
-
-			/* Display summary message */
-			if(totalFaults == 0){
-				LCD_clearScreen();
-				LCD_displayString("No Faults");
-			}
-			else{
-				LCD_clearScreen();
-				LCD_displayString("--- End List ---");
-			}
-
-			LCD_moveCursor(3,0);
-			LCD_displayString("Press * for menu");
-			break;
-
-		/* === STOP MONITORING === */
-		case STOP_MONITORING:
-			LCD_clearScreen();
-			LCD_displayString("System Stopped");
-			LCD_moveCursor(1,0);
-			LCD_displayString("Return to menu");
-
-			/* Display countdown before returning to main menu */
-			for(uint8 i = 0; i < 10; i++){
-				LCD_moveCursor(2,0);
-				LCD_displayString("Wait ");
-				LCD_displayInteger(10 - i);
-				LCD_displayString("s...");
-				_delay_ms(1000);
-			}
-
-			/* Redisplay main menu */
-			LCD_clearScreen();
-			LCD_displayString("1.Start System");
-			LCD_moveCursor(1,0);
-			LCD_displayString("2.Show Readings");
-			LCD_moveCursor(2,0);
-			LCD_displayString("3.View Faults");
-			LCD_moveCursor(3,0);
-			LCD_displayString("4.Stop System");
-			break;
-
-		/* === RETURN TO MAIN MENU === */
-		case MENU_MAIN:
-			LCD_clearScreen();
-			LCD_displayString("1.Start System");
-			LCD_moveCursor(1,0);
-			LCD_displayString("2.Show Readings");
-			LCD_moveCursor(2,0);
-			LCD_displayString("3.View Faults");
-			LCD_moveCursor(3,0);
-			LCD_displayString("4.Stop System");
-			break;
-
-		/* === INVALID INPUT === */
-		default:
-			LCD_clearScreen();
-			LCD_displayString("Invalid Key");
-			LCD_moveCursor(1,0);
-			LCD_displayString("Press * for menu");
-			break;
-		}
-
-		_delay_ms(300); // Small delay for input debouncing and readability
-	}
-}
+/******************************************************************************
+ *
+ * Project: Smart_Home
+ *
+ * File Name: HMI.c
+ *
+ * Author: Kerolous_Labib_Georgy
+ *
+ * Description:
+ * ------------
+ * This file implements the Human-Machine Interface (HMI) layer of the Smart Home project.
+ * It communicates with the control unit via UART, displays sensor readings and system states
+ * on an LCD, and allows the user to send commands using a keypad.
+ *
+ * The dashboard screen subscribes to telemetry frames pushed by the control unit
+ * and updates the values in place until the user leaves it. The stream is flow
+ * controlled with credits: the control unit only sends the frames the UART
+ * receive buffer can hold, and skips samples when the HMI falls behind.
+ *
+ * The main loop never blocks: it collects keypad, UART-frame and timer events
+ * and dispatches them to the screen state machine. Every wait is a software
+ * timer, so a key press is handled on the next keypad scan in every screen.
+ * The keypad itself is sampled from a timer tick and debounced over several
+ * samples, the scan never waits.
+ *
+ * Commands go to the control unit as request frames tagged with a correlation
+ * id. Up to LINK_MAX_OUTSTANDING requests are in flight at once (the status
+ * screen asks for its DIDs and the thresholds together) and the responses are matched by id
+ * in whatever order they come. Each request has a deadline computed from the
+ * link speed, a request that is not answered in time is sent again up to
+ * LINK_MAX_ATTEMPTS times, then the link error screen is shown. The round-trip
+ * times are shown on the link screen.
+ *
+ * Several Control Units can share the line (LINK_NODES_COUNT > 1, 9-bit
+ * multi-drop mode, see uart.h): every request is tagged with its node, the
+ * node is addressed before its frames and only once the previous node has
+ * nothing left in flight. The nodes screen polls each node in turn and shows
+ * the refresh rate reached per node, the other screens talk to the node
+ * chosen there. A shared line stays at the base rate.
+ *
+ * Frames are queued per channel and sent by priority, so a fault log export
+ * running on the bulk channel never holds back the keypad commands. The export
+ * is pulled one window of LOG_DATA frames at a time (as many as the UART
+ * receive buffer holds): the next window is asked for once the previous one
+ * came in, a lost frame makes the window be asked for again from the first
+ * missing fault, and a window that does not come is asked for again after
+ * LOG_TIMEOUT_TICKS refreshes, up to LOG_MAX_RETRIES times.
+ *
+ * The clear screen empties the fault log of the Control Unit (CLEAR_DTC): a
+ * quick clear is answered once done, a full erase is answered when it starts
+ * and reports its progress in CLEAR_PROGRESS frames on the bulk channel. When
+ * no news of a running erase came for CLEAR_POLL_MS its state is read with a
+ * CLEAR_DTC status request, so a lost last frame never leaves the screen waiting.
+ *
+ * The recent faults key opens the fault viewer on the faults logged since the
+ * Control Unit started: FIND_FAULTS looks their first index up in the time
+ * index of the journal, then the pages are read with DETECT_FAULTS as usual.
+ *
+ * The rules screen edits the fault rules of the Control Unit (READ_RULE and
+ * WRITE_RULE): '+' reads the next rule, '-' chooses the field to change, the
+ * digits type its value and '=' sends the rule. The Control Unit checks it
+ * and keeps it in its EEPROM, a rejected rule stays on the screen to be fixed.
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                  Libraries                                  *
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include <string.h>
+#include "lcd.h"
+#include "keypad.h"
+#include "uart.h"
+#include "sw_timer.h"
+#include "frame.h"
+#include "hmi_menu.h"
+
+/*******************************************************************************
+ *                                  Definitions                                *
+ *******************************************************************************/
+
+/* Commands sent from the keypad to the Control Unit (carried by request frames) */
+#define START_MONITORING 1
+#define DISPLAY_VALUES   2
+#define DETECT_FAULTS    3
+#define STOP_MONITORING  4
+#define READ_THRESHOLDS  5
+#define EXPORT_FAULTS    7
+#define READ_DIDS        8
+#define READ_WEAR        9
+#define CLEAR_DTC        10
+#define FIND_FAULTS      11
+#define READ_RULE        12
+#define WRITE_RULE       13
+
+/* DETECT_FAULTS response flags (must match control unit) */
+#define FAULTS_MORE      0x01
+
+/* CLEAR_DTC request argument and response status */
+#define CLEAR_QUICK      0      /* Empty the log in one write */
+#define CLEAR_ERASE      1      /* Empty the log, then erase every journal page */
+#define CLEAR_STATUS     2      /* Only read the state of the erase */
+#define CLEAR_DONE       0
+#define CLEAR_STARTED    1      /* CLEAR_PROGRESS frames follow */
+#define CLEAR_FAILED     2
+
+/* WRITE_RULE response status */
+#define RULE_SAVED       0
+#define RULE_REJECTED    1      /* Not valid, or its fault code has another rule */
+
+/* Dashboard, link and status screen keys, actions handled by the HMI itself */
+#define DASHBOARD        5
+#define LINK_STATS       6
+#define STATUS           7
+#define LOG_EXPORT       8
+#define NODES            9
+#define WEAR             0
+#define CLEAR_LOG        '='
+#define RECENT_FAULTS    '%'
+#define RULES            '+'
+#define DASH_RATE_UP     (MENU_LOCAL_FLAG | 1)
+#define DASH_RATE_DOWN   (MENU_LOCAL_FLAG | 2)
+#define NODE_NEXT        (MENU_LOCAL_FLAG | 3)
+#define LOG_CLEAR_QUICK  (MENU_LOCAL_FLAG | 4)
+#define LOG_CLEAR_ERASE  (MENU_LOCAL_FLAG | 5)
+#define RULE_NEXT        (MENU_LOCAL_FLAG | 6)
+#define RULE_FIELD       (MENU_LOCAL_FLAG | 7)
+#define RULE_SAVE        (MENU_LOCAL_FLAG | 8)
+#define RULE_DIGIT       (MENU_LOCAL_FLAG | 0x10)  /* Digit in the low nibble */
+
+/* Link training bytes */
+#define ACK    0x05
+#define SYNC_BYTE 0xAA   /* Link training preamble, the Control Unit times it */
+
+/* Window states */
+#define OPENED 1UL
+#define CLOSED 0UL
+
+/* Menu command key */
+#define MENU_MAIN '*'
+
+/* Diagnostic Trouble Codes (must match control unit) */
+#define DTC_P001 0x01 /* DistanceTooClose */
+#define DTC_P002 0x02 /* Overheat */
+#define DTC_BAD_RECORD 0x00 /* Log record that failed its CRC check on the Control Unit */
+
+/* Size of the sensor data packet (distance high/low, temperature, win1, win2) */
+#define PACK_SIZE                5
+
+/* READ_THRESHOLDS (threshold of the first rule on the temperature and on the distance) response size */
+#define THRESHOLDS_SIZE          2
+
+/* READ_DIDS response data: ID and data of each DID, after the command */
+#define DIDS_MAX_LENGTH          (FRAME_MAX_PAYLOAD - 1)
+
+/* FIND_FAULTS response size (first index, end index, 2 bytes each, log time, 3 bytes) */
+#define FIND_SIZE                7
+
+/* READ_RULE response size (index, rule in the FRAME_RULE_xxx layout) */
+#define RULE_SIZE                (1 + FRAME_RULE_LENGTH)
+#define RULE_DATA                1        /* Offset of the rule */
+
+/* CLEAR_DTC response size (status, journal pages erased, pages in the journal, 2 bytes each) */
+#define CLEAR_SIZE               5
+
+/* READ_WEAR response size (journal pages, head page, most worn page, its cycles, fewest cycles, 2 bytes each) */
+#define WEAR_SIZE                10
+
+/* Screen timings */
+#define WELCOME_TIME_MS          1000
+#define HOLD_TIME_MS             10000    /* "System Started" and sensor values hold time */
+#define COUNTDOWN_SECONDS        10       /* "System Stopped" countdown */
+#define COUNTDOWN_STEP_MS        1000
+
+/* Request deadline: the frames transfer time at the current rate plus the time the
+ * Control Unit may take to get to the request (sensing and fault logging in its loop) */
+#define LINK_PROCESSING_MS       100
+#define LINK_MAX_ATTEMPTS        3
+#define LINK_MAX_OUTSTANDING     4        /* Requests in flight at once */
+#define LINK_REQUEST_MAX_LENGTH  9        /* Command and its arguments (READ_DIDS with 4 IDs, WRITE_RULE) */
+#define LINK_STATS_REFRESH_MS    1000
+#define LOG_REFRESH_MS           250      /* Fault log export progress */
+#define CLEAR_POLL_MS            1000     /* Fault log erase state read when no progress came */
+#define LOG_TIMEOUT_TICKS        4        /* Refreshes without a LOG_DATA frame before the window is asked for again */
+#define LOG_MAX_RETRIES          3        /* Windows asked for again in a row before the export fails */
+
+/* LOG_DATA frames asked for at once (full frames in the UART receive buffer, minus one
+ * kept for the responses and the rare stuffed bytes) */
+#define LOG_WINDOW_FRAMES        (UART_RX_BUFFER_SIZE / FRAME_MAX_SIZE - 1)
+
+/* Control Units on the line: 1 = point-to-point link (trained, rate negotiated),
+ * more = multi-drop line at the base rate, node n at address n + 1 (up to one per LCD row below the header) */
+#define LINK_NODES_COUNT         1
+#define LINK_MULTIDROP           (LINK_NODES_COUNT > 1)
+#define LINK_BITS_PER_BYTE       (LINK_MULTIDROP ? 11UL : 10UL)  /* Start, data (and address) and stop bits */
+#define LINK_NO_NODE             0xFF     /* No node addressed yet */
+#define NODES_REFRESH_MS         1000     /* Per node refresh rate window */
+
+/* Fault codes shown per page, the last LCD row is kept for the prompt */
+#define FAULTS_PER_PAGE          (LCD_ROWS - 1)
+
+/* Dashboard: telemetry rate (index in g_dashRates, changed with the '+' and '-' keys),
+ * the LCD cannot follow the frame rate so it is refreshed from the latest state */
+#define DASH_DEFAULT_RATE_INDEX  2
+#define DASH_REFRESH_MS          100
+#define DASH_STATS_TICKS         10       /* Refreshes per frame rate window (1 s), also resubscribes if no frame came */
+
+/* Telemetry frames the HMI can buffer (full keyframes in the UART receive buffer,
+ * minus one kept for the responses and the rare stuffed bytes), credit is granted
+ * again when half of it is used */
+#define DASH_CREDIT_WINDOW       (UART_RX_BUFFER_SIZE / (FRAME_OVERHEAD + FRAME_TELEMETRY_LENGTH) - 1)
+
+/* Link training at startup: SYNC_BYTE repeated until the Control Unit ACKs at the matched rate */
+#define TRAINING_SYNC_PERIOD_MS  10
+#define TRAINING_MAX_SYNCS       250      /* 2.5 s, then a Control Unit without training is assumed */
+
+/* Baud rate negotiation, led by the HMI (index in FRAME_BAUD_RATES) */
+#define BAUD_MAX_INDEX           (FRAME_BAUD_RATES_COUNT - 1)  /* Fastest rate supported here */
+#define BAUD_CHECK_PERIOD_MS     1000     /* Link check period, also the negotiation step timeout */
+#define BAUD_MAX_MISSED_CHECKS   3        /* Unanswered checks before falling back to the base rate */
+#define BAUD_ERROR_THRESHOLD     3        /* Line errors per check (both ends) that make the rate step down */
+#define BAUD_MAX_ATTEMPTS        3        /* Unanswered requests before staying at the current rate */
+#define BAUD_SWITCH_GUARD_MS     2        /* Lets the Control Unit finish its own switch */
+
+/*******************************************************************************
+ *                                Types Declaration                            *
+ *******************************************************************************/
+
+/* Screen IDs (index in the flash screen table) */
+typedef enum
+{
+	SCREEN_WELCOME,
+	SCREEN_MAIN_MENU,
+	SCREEN_SYSTEM_STARTED,
+	SCREEN_MENU_PROMPT,
+	SCREEN_DISPLAY_VALUES,
+	SCREEN_SENSOR_VALUES,
+	SCREEN_DISPLAY_DONE,
+	SCREEN_READING_FAULTS,
+	SCREEN_FAULT_LIST,
+	SCREEN_NO_FAULTS,
+	SCREEN_END_LIST,
+	SCREEN_SYSTEM_STOPPED,
+	SCREEN_INVALID_KEY,
+	SCREEN_LINK_ERROR,
+	SCREEN_DASHBOARD,
+	SCREEN_LINK_STATS,
+	SCREEN_STATUS,
+	SCREEN_LOG_EXPORT,
+	SCREEN_NODES,
+	SCREEN_WEAR,
+	SCREEN_CLEAR_LOG,
+	SCREEN_RULES
+}HMI_ScreenID;
+
+/* Software timers used by the HMI */
+typedef enum
+{
+	TIMER_SCREEN,      /* Screen hold times and countdown */
+	TIMER_LINK,        /* Earliest request deadline and link training */
+	TIMER_DASH,        /* Dashboard refresh */
+	TIMER_BAUD,        /* Baud rate negotiation and link checks */
+	TIMER_KEYPAD       /* Keypad sampling */
+}HMI_TimerID;
+
+/* Event sources handled by the main loop */
+typedef enum
+{
+	EVENT_KEY,         /* value = pressed key */
+	EVENT_FRAME,       /* value = HMI_FrameType */
+	EVENT_TIMER        /* value = HMI_TimerID */
+}HMI_EventType;
+
+/* Complete frames assembled from the UART bytes */
+typedef enum
+{
+	FRAME_PACK,        /* Sensor data packet received (g_pack) */
+	FRAME_FAULTS,      /* Page of fault codes received (g_faultCodes) */
+	FRAME_FIND,        /* First fault of the recent faults received (g_faultFirst) */
+	FRAME_THRESHOLDS,  /* Critical limits received (g_thresholds) */
+	FRAME_DIDS,        /* Data identifiers received (g_didData) */
+	FRAME_WEAR,        /* EEPROM wear report received (g_wear) */
+	FRAME_LOG,         /* Fault log export frame (g_frameRx.frame) */
+	FRAME_CLEAR,       /* CLEAR_DTC status received (g_clearStatus) */
+	FRAME_CLEAR_PROGRESS, /* Fault log erase progress frame (g_frameRx.frame) */
+	FRAME_RULE,        /* Fault rule received (g_rule) */
+	FRAME_RULE_SAVED,  /* WRITE_RULE status received (g_ruleStatus) */
+	FRAME_TELEMETRY    /* Telemetry frame pushed by the Control Unit (g_frameRx.frame) */
+}HMI_FrameType;
+
+/* State of the UART link with the Control Unit */
+typedef enum
+{
+	LINK_IDLE,
+	LINK_TRAINING      /* Sending SYNC_BYTE until the Control Unit ACKs */
+}HMI_LinkState;
+
+/* Request slot, a request is in flight from its first attempt to its response */
+typedef struct
+{
+	boolean used;
+	uint8 node;                                   /* Control Unit the request is for */
+	uint8 id;                                     /* Correlation id (frame SEQ) */
+	uint8 data[LINK_REQUEST_MAX_LENGTH];          /* Command and its arguments */
+	uint8 length;
+	uint8 attempts;                               /* Times sent (0 = waiting for the link) */
+	uint32 startTime;                             /* Time of the first attempt */
+	uint32 deadline;                              /* End of the current attempt */
+}HMI_RequestType;
+
+/* Baud rate negotiation state */
+typedef enum
+{
+	BAUD_IDLE,
+	BAUD_WAIT_ACCEPT,  /* Request sent at the current rate */
+	BAUD_WAIT_CONFIRM  /* Switched, link check sent at the new rate */
+}HMI_BaudState;
+
+/*******************************************************************************
+ *                         Flash Strings and Tables                            *
+ *******************************************************************************/
+
+/* Screen labels (stored in flash, read with pgm_read_byte) */
+static const char STR_WELCOME[]        PROGMEM = "     Welcome";
+static const char STR_MENU_START[]     PROGMEM = "1.Start 8.Log 9N";
+static const char STR_MENU_SHOW[]      PROGMEM = "2.Read  7.Status";
+static const char STR_MENU_FAULTS[]    PROGMEM = "3.Flt %R 6.Ln =C";
+static const char STR_MENU_STOP[]      PROGMEM = "4.Stp 5.Lv 0W +R";
+static const char STR_STARTED[]        PROGMEM = "System Started";
+static const char STR_START_SETUP[]    PROGMEM = "Start Setup...";
+static const char STR_PRESS_MENU[]     PROGMEM = "Press * for menu";
+static const char STR_DISPLAY_VALUES[] PROGMEM = "Display Values";
+static const char STR_AGAIN[]          PROGMEM = "Again? Press 2";
+static const char STR_READING_FAULTS[] PROGMEM = "Reading Faults..";
+static const char STR_NO_FAULTS[]      PROGMEM = "No Faults";
+static const char STR_END_LIST[]       PROGMEM = "--- End List ---";
+static const char STR_PRESS_ANY_KEY[]  PROGMEM = "Press any key...";
+static const char STR_STOPPED[]        PROGMEM = "System Stopped";
+static const char STR_RETURN_MENU[]    PROGMEM = "Return to menu";
+static const char STR_INVALID_KEY[]    PROGMEM = "Invalid Key";
+static const char STR_NO_RESPONSE[]    PROGMEM = "Control ECU";
+static const char STR_NOT_RESPONDING[] PROGMEM = "not responding";
+static const char STR_DASH_ROW0[]      PROGMEM = "T:   C D:    cm";
+static const char STR_DASH_ROW1[]      PROGMEM = "W1:     W2:";
+static const char STR_DASH_ROW2[]      PROGMEM = "Set:    Got:";
+static const char STR_DASH_ROW3[]      PROGMEM = "Lost:     *:Exit";
+static const char STR_LINK_ROW0[]      PROGMEM = "RTT avg:     ms";
+static const char STR_LINK_ROW1[]      PROGMEM = "RTT max:     ms";
+static const char STR_LINK_ROW2[]      PROGMEM = "Retries:";
+static const char STR_LINK_ROW3[]      PROGMEM = "Failed:";
+static const char STR_STATUS_ROW0[]    PROGMEM = "T:   C  Max:   C";
+static const char STR_STATUS_ROW1[]    PROGMEM = "D:    cm Min:";
+static const char STR_STATUS_ROW2[]    PROGMEM = "Logged:";
+static const char STR_STATUS_ROW3[]    PROGMEM = "Monitoring:";
+static const char STR_LOG_ROW0[]       PROGMEM = "Fault log";
+static const char STR_LOG_ROW1[]       PROGMEM = "Codes:";
+static const char STR_LOG_ROW2[]       PROGMEM = "P1:     P2:";
+static const char STR_LOG_ROW3[]       PROGMEM = "P3:     P4:";
+static const char STR_LOG_BUSY[]       PROGMEM = "....";
+static const char STR_LOG_DONE[]       PROGMEM = "done";
+static const char STR_LOG_FAILED[]     PROGMEM = "fail";
+static const char STR_NODES_ROW0[]     PROGMEM = " N  T    D    Hz";
+static const char STR_WEAR_ROW0[]      PROGMEM = "Max cycles:";
+static const char STR_WEAR_ROW1[]      PROGMEM = "  on page:";
+static const char STR_WEAR_ROW2[]      PROGMEM = "Min cycles:";
+static const char STR_WEAR_ROW3[]      PROGMEM = "Head:     of";
+static const char STR_CLEAR_ROW0[]     PROGMEM = "Clear fault log";
+static const char STR_CLEAR_ROW1[]     PROGMEM = "1.Quick 2.Erase";
+static const char STR_CLEAR_ROW3[]     PROGMEM = "*:Exit";
+static const char STR_CLEAR_BUSY[]     PROGMEM = "Clearing...     ";
+static const char STR_CLEAR_ERASED[]   PROGMEM = "Erased:    /    ";
+static const char STR_CLEAR_DONE[]     PROGMEM = "Log cleared     ";
+static const char STR_CLEAR_FAILED[]   PROGMEM = "Clear failed    ";
+static const char STR_RULE_ROW0[]      PROGMEM = "Rule:    Code:";
+static const char STR_RULE_ROW1[]      PROGMEM = "If:";
+static const char STR_RULE_ROW2[]      PROGMEM = "Hys:     Deb:";
+static const char STR_RULE_SIGNAL[]    PROGMEM = "Signal:   ";
+static const char STR_RULE_COMPARE[]   PROGMEM = "Compare:  ";
+static const char STR_RULE_LIMIT[]     PROGMEM = "Limit:    ";
+static const char STR_RULE_HYST[]      PROGMEM = "Hyst:     ";
+static const char STR_RULE_DEBOUNCE[]  PROGMEM = "Debounce: ";
+static const char STR_RULE_CODE[]      PROGMEM = "Code:     ";
+static const char STR_RULE_SAVING[]    PROGMEM = "Saving...       ";
+static const char STR_RULE_SAVED[]     PROGMEM = "Rule saved      ";
+static const char STR_RULE_REJECTED[]  PROGMEM = "Rule rejected   ";
+static const char STR_TEMP[]           PROGMEM = "Temp";
+static const char STR_DIST[]           PROGMEM = "Dist";
+static const char STR_ON[]             PROGMEM = "On ";
+static const char STR_OFF[]            PROGMEM = "Off";
+static const char STR_OPEN[]           PROGMEM = "Open";
+static const char STR_CLOSED_SHORT[]   PROGMEM = "Clsd";
+
+/* Keys accepted on every screen: the four commands, the HMI screens and the menu key */
+static const MENU_KeyBindingType g_commandKeys[] PROGMEM = {
+	{ START_MONITORING, START_MONITORING, SCREEN_SYSTEM_STARTED },
+	{ DISPLAY_VALUES,   DISPLAY_VALUES,   SCREEN_DISPLAY_VALUES },
+	{ DETECT_FAULTS,    DETECT_FAULTS,    SCREEN_READING_FAULTS },
+	{ RECENT_FAULTS,    FIND_FAULTS,      SCREEN_READING_FAULTS },
+	{ STOP_MONITORING,  STOP_MONITORING,  SCREEN_SYSTEM_STOPPED },
+	{ DASHBOARD,        MENU_NO_COMMAND,  SCREEN_DASHBOARD      },
+	{ LINK_STATS,       MENU_NO_COMMAND,  SCREEN_LINK_STATS     },
+	{ STATUS,           MENU_NO_COMMAND,  SCREEN_STATUS         },
+	{ LOG_EXPORT,       EXPORT_FAULTS,    SCREEN_LOG_EXPORT     },
+	{ NODES,            MENU_NO_COMMAND,  SCREEN_NODES          },
+	{ WEAR,             READ_WEAR,        SCREEN_WEAR           },
+	{ CLEAR_LOG,        MENU_NO_COMMAND,  SCREEN_CLEAR_LOG      },
+	{ RULES,            READ_RULE,        SCREEN_RULES          },
+	{ MENU_MAIN,        MENU_NO_COMMAND,  SCREEN_MAIN_MENU      }
+};
+
+#define COMMAND_KEYS_COUNT   (sizeof(g_commandKeys) / sizeof(g_commandKeys[0]))
+
+/* Telemetry rates offered on the dashboard in Hz, the Control Unit clamps them to the link limit */
+static const uint8 g_dashRates[] PROGMEM = { 2, 5, 10, 20, 50, 100 };
+
+#define DASH_RATES_COUNT     (sizeof(g_dashRates) / sizeof(g_dashRates[0]))
+
+/* Data size of every DID of the Control Unit registry, in ID order */
+static const uint8 g_didSizes[FRAME_DIDS_COUNT] PROGMEM = FRAME_DID_SIZES;
+
+/* DIDs of the status screen, read in one request */
+static const uint16 g_statusDids[] PROGMEM = {
+	FRAME_DID_TEMPERATURE,
+	FRAME_DID_DISTANCE,
+	FRAME_DID_MONITORING,
+	FRAME_DID_FAULTS_LOGGED
+};
+
+#define STATUS_DIDS_COUNT    (sizeof(g_statusDids) / sizeof(g_statusDids[0]))
+
+/* Keys accepted on the dashboard: rate up/down and leave */
+static const MENU_KeyBindingType g_dashboardKeys[] PROGMEM = {
+	{ '+',              DASH_RATE_UP,     SCREEN_DASHBOARD      },
+	{ '-',              DASH_RATE_DOWN,   SCREEN_DASHBOARD      },
+	{ MENU_MAIN,        MENU_NO_COMMAND,  SCREEN_MAIN_MENU      }
+};
+
+#define DASHBOARD_KEYS_COUNT (sizeof(g_dashboardKeys) / sizeof(g_dashboardKeys[0]))
+
+/* Keys accepted on the nodes screen: choose the node of the other screens and leave */
+static const MENU_KeyBindingType g_nodesKeys[] PROGMEM = {
+	{ '+',              NODE_NEXT,        SCREEN_NODES          },
+	{ MENU_MAIN,        MENU_NO_COMMAND,  SCREEN_MAIN_MENU      }
+};
+
+#define NODES_KEYS_COUNT     (sizeof(g_nodesKeys) / sizeof(g_nodesKeys[0]))
+
+/* Keys accepted on the clear screen: quick clear, full erase and leave */
+static const MENU_KeyBindingType g_clearKeys[] PROGMEM = {
+	{ '1',              LOG_CLEAR_QUICK,  SCREEN_CLEAR_LOG      },
+	{ '2',              LOG_CLEAR_ERASE,  SCREEN_CLEAR_LOG      },
+	{ MENU_MAIN,        MENU_NO_COMMAND,  SCREEN_MAIN_MENU      }
+};
+
+#define CLEAR_KEYS_COUNT     (sizeof(g_clearKeys) / sizeof(g_clearKeys[0]))
+
+/* Keys accepted on the rules screen: next rule, next field, value digits, send and leave */
+static const MENU_KeyBindingType g_rulesKeys[] PROGMEM = {
+	{ '+',              RULE_NEXT,        SCREEN_RULES          },
+	{ '-',              RULE_FIELD,       SCREEN_RULES          },
+	{ '=',              RULE_SAVE,        SCREEN_RULES          },
+	{ 0,                RULE_DIGIT | 0,   SCREEN_RULES          },
+	{ 1,                RULE_DIGIT | 1,   SCREEN_RULES          },
+	{ 2,                RULE_DIGIT | 2,   SCREEN_RULES          },
+	{ 3,                RULE_DIGIT | 3,   SCREEN_RULES          },
+	{ 4,                RULE_DIGIT | 4,   SCREEN_RULES          },
+	{ 5,                RULE_DIGIT | 5,   SCREEN_RULES          },
+	{ 6,                RULE_DIGIT | 6,   SCREEN_RULES          },
+	{ 7,                RULE_DIGIT | 7,   SCREEN_RULES          },
+	{ 8,                RULE_DIGIT | 8,   SCREEN_RULES          },
+	{ 9,                RULE_DIGIT | 9,   SCREEN_RULES          },
+	{ MENU_MAIN,        MENU_NO_COMMAND,  SCREEN_MAIN_MENU      }
+};
+
+#define RULES_KEYS_COUNT     (sizeof(g_rulesKeys) / sizeof(g_rulesKeys[0]))
+
+/* Label of each field of a rule, indexed by its FRAME_RULE_xxx offset */
+static const char *const g_ruleFields[FRAME_RULE_LENGTH] PROGMEM = {
+	[FRAME_RULE_SIGNAL]     = STR_RULE_SIGNAL,
+	[FRAME_RULE_COMPARE]    = STR_RULE_COMPARE,
+	[FRAME_RULE_THRESHOLD]  = STR_RULE_LIMIT,
+	[FRAME_RULE_HYSTERESIS] = STR_RULE_HYST,
+	[FRAME_RULE_DEBOUNCE]   = STR_RULE_DEBOUNCE,
+	[FRAME_RULE_CODE]       = STR_RULE_CODE
+};
+
+/* Screen table, indexed by HMI_ScreenID */
+static const MENU_ScreenType g_screens[] PROGMEM = {
+	[SCREEN_WELCOME]        = { { NULL_PTR, STR_WELCOME, NULL_PTR, NULL_PTR },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_MAIN_MENU]      = { { STR_MENU_START, STR_MENU_SHOW, STR_MENU_FAULTS, STR_MENU_STOP },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_SYSTEM_STARTED] = { { STR_STARTED, STR_START_SETUP, NULL_PTR, NULL_PTR },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_MENU_PROMPT]    = { { STR_PRESS_MENU, NULL_PTR, NULL_PTR, NULL_PTR },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_DISPLAY_VALUES] = { { STR_DISPLAY_VALUES, NULL_PTR, NULL_PTR, NULL_PTR },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_SENSOR_VALUES]  = { { NULL_PTR, NULL_PTR, NULL_PTR, NULL_PTR },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_DISPLAY_DONE]   = { { STR_AGAIN, STR_PRESS_MENU, NULL_PTR, NULL_PTR },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_READING_FAULTS] = { { STR_READING_FAULTS, NULL_PTR, NULL_PTR, NULL_PTR },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_FAULT_LIST]     = { { NULL_PTR, NULL_PTR, NULL_PTR, NULL_PTR },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_NO_FAULTS]      = { { STR_NO_FAULTS, NULL_PTR, NULL_PTR, STR_PRESS_MENU },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_END_LIST]       = { { STR_END_LIST, NULL_PTR, NULL_PTR, STR_PRESS_MENU },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_SYSTEM_STOPPED] = { { STR_STOPPED, STR_RETURN_MENU, NULL_PTR, NULL_PTR },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_INVALID_KEY]    = { { STR_INVALID_KEY, STR_PRESS_MENU, NULL_PTR, NULL_PTR },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_LINK_ERROR]     = { { STR_NO_RESPONSE, STR_NOT_RESPONDING, NULL_PTR, STR_PRESS_MENU },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_DASHBOARD]      = { { STR_DASH_ROW0, STR_DASH_ROW1, STR_DASH_ROW2, STR_DASH_ROW3 },
+	                            g_dashboardKeys, DASHBOARD_KEYS_COUNT },
+	[SCREEN_LINK_STATS]     = { { STR_LINK_ROW0, STR_LINK_ROW1, STR_LINK_ROW2, STR_LINK_ROW3 },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_STATUS]         = { { STR_STATUS_ROW0, STR_STATUS_ROW1, STR_STATUS_ROW2, STR_STATUS_ROW3 },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_LOG_EXPORT]     = { { STR_LOG_ROW0, STR_LOG_ROW1, STR_LOG_ROW2, STR_LOG_ROW3 },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_NODES]          = { { STR_NODES_ROW0, NULL_PTR, NULL_PTR, NULL_PTR },
+	                            g_nodesKeys, NODES_KEYS_COUNT },
+	[SCREEN_WEAR]           = { { STR_WEAR_ROW0, STR_WEAR_ROW1, STR_WEAR_ROW2, STR_WEAR_ROW3 },
+	                            g_commandKeys, COMMAND_KEYS_COUNT },
+	[SCREEN_CLEAR_LOG]      = { { STR_CLEAR_ROW0, STR_CLEAR_ROW1, NULL_PTR, STR_CLEAR_ROW3 },
+	                            g_clearKeys, CLEAR_KEYS_COUNT },
+	[SCREEN_RULES]          = { { STR_RULE_ROW0, STR_RULE_ROW1, STR_RULE_ROW2, NULL_PTR },
+	                            g_rulesKeys, RULES_KEYS_COUNT }
+};
+
+/*******************************************************************************
+ *                             Global Variables                                *
+ *******************************************************************************/
+static HMI_ScreenID g_currentScreen = SCREEN_WELCOME;  /* Screen currently on the LCD */
+static uint8 g_countdown = 0;                           /* Seconds left on the stop screen */
+
+/* Link state */
+static HMI_LinkState g_linkState = LINK_IDLE;
+static HMI_RequestType g_requests[LINK_MAX_OUTSTANDING]; /* Requests in flight or waiting for the link */
+static uint8 g_linkOutstanding = 0;               /* Used request slots */
+static uint8 g_linkNextId = 0;                    /* Correlation id of the next request */
+static uint8 g_trainingSyncs = 0;                 /* SYNC bytes sent by the link training */
+static uint8 g_linkNode = LINK_NO_NODE;           /* Node addressed on a multi-drop line */
+static uint8 g_node = 0;                          /* Node the screens talk to */
+static FRAME_ReceiverType g_frameRx;              /* Receiver for frames coming from the Control Unit */
+
+/* Request round trips, from the first attempt to the response (retries included) */
+static uint16 g_rttCount = 0;
+static uint32 g_rttSum = 0;
+static uint16 g_rttMax = 0;
+static uint16 g_linkRetries = 0;                  /* Requests sent again after their deadline */
+static uint16 g_linkFailures = 0;                 /* Requests given up after LINK_MAX_ATTEMPTS or not sent */
+
+/* Baud rate */
+static const UART_BaudRateType g_baudRates[FRAME_BAUD_RATES_COUNT] = FRAME_BAUD_RATES;
+static HMI_BaudState g_baudState = BAUD_IDLE;
+static uint8 g_baudIndex = 0;                     /* Current rate */
+static uint8 g_baudPrevious = 0;                  /* Rate before the switch in progress */
+static uint8 g_baudCeiling = BAUD_MAX_INDEX;      /* Fastest rate still worth trying */
+static uint8 g_baudAttempts = 0;                  /* Unanswered requests in a row */
+static uint8 g_baudMissed = 0;                    /* Unanswered link checks in a row */
+static uint16 g_lineErrors = 0;                   /* FE + DOR + PE count at the last check */
+
+/* Received data */
+static uint8 g_pack[PACK_SIZE];                   /* Sensor data packet */
+static uint8 g_faultCodes[FAULTS_PER_PAGE];       /* Fault codes of the last page */
+static uint8 g_faultCount = 0;
+static uint8 g_faultFlags = 0;                    /* FAULTS_MORE if the page is not the last one */
+static uint8 g_thresholds[THRESHOLDS_SIZE];       /* Critical temperature and distance */
+static uint8 g_didData[DIDS_MAX_LENGTH];          /* ID and data of the DIDs of the last READ_DIDS */
+static uint8 g_didLength = 0;
+static uint8 g_wear[WEAR_SIZE];                   /* Fault journal wear report */
+static uint8 g_clearMode = CLEAR_QUICK;           /* Argument of the next CLEAR_DTC request */
+static uint8 g_clearStatus = CLEAR_DONE;          /* Status of the last CLEAR_DTC response */
+static uint16 g_clearErased = 0;                  /* Journal pages erased, from the last CLEAR_DTC response */
+static uint16 g_clearPages = 0;                   /* Pages in the journal */
+static uint8 g_rule[RULE_SIZE];                   /* Index and rule of the last READ_RULE, edited in place */
+static uint8 g_ruleStatus = RULE_SAVED;           /* Status of the last WRITE_RULE response */
+
+/* Nodes screen */
+static uint8 g_nodePoll = 0;                      /* Node polled now */
+static uint8 g_nodeReplies[LINK_NODES_COUNT];     /* Replies per node in the current window */
+
+/* Fault log export */
+static uint16 g_logNext = 0;                      /* Index of the next expected fault */
+static uint16 g_logCounts[FRAME_FAULT_CODES_COUNT]; /* Codes counted per fault code (index code - 1) */
+static uint8 g_logSeq = 0;                        /* Correlation id of the window asked for */
+static uint8 g_logFrames = 0;                     /* Frames of the window received */
+static uint8 g_logIdle = 0;                       /* Refreshes since the last frame or request */
+static uint8 g_logRetries = 0;                    /* Windows asked for again since the last frame */
+static boolean g_logFailed = FALSE;               /* The export stopped before the end of the log */
+static boolean g_logDone = FALSE;
+
+/* Fault viewer */
+static uint8 g_faultRow = 0;                      /* Next LCD row of the current page */
+static uint16 g_totalFaults = 0;                  /* Faults shown so far, index of the next page */
+static uint16 g_faultFirst = 0;                   /* Index of the first fault of the viewer */
+static boolean g_faultMore = FALSE;               /* More faults after the shown page */
+
+/* Rules screen */
+static uint8 g_ruleIndex = 0;                     /* Rule shown */
+static boolean g_ruleLoaded = FALSE;              /* g_rule holds that rule, it can be edited */
+static uint8 g_ruleField = FRAME_RULE_THRESHOLD;  /* FRAME_RULE_xxx offset of the field edited */
+static boolean g_ruleTyping = FALSE;              /* A digit was typed in the field, the next ones append */
+
+/* Dashboard */
+static uint8 g_dashRateIndex = DASH_DEFAULT_RATE_INDEX; /* Requested telemetry rate */
+static uint8 g_dashSubscription = 0;              /* Rate to send when the link is free (0 = none) */
+static boolean g_dashSubscriptionPending = FALSE;
+static uint8 g_dashFrames = 0;                    /* Frames received in the current window */
+static uint16 g_dashLost = 0;                     /* Frames missed (sequence gaps) */
+static uint8 g_dashLastSeq = 0;
+static uint32 g_dashLastTime = 0;                 /* Sample time of the last keyframe */
+static boolean g_dashSynced = FALSE;              /* A first frame gave the sequence reference */
+static uint8 g_dashState[FRAME_TELEMETRY_LENGTH]; /* Latest sample, delta frames are applied on it */
+static boolean g_dashHaveState = FALSE;           /* A keyframe filled g_dashState */
+static boolean g_dashStale = FALSE;               /* A frame was missed since the last keyframe */
+static uint8 g_dashTicks = 0;                     /* Refreshes in the current frame rate window */
+static uint8 g_dashShown[FRAME_TELEMETRY_LENGTH]; /* Values on the LCD, only changes are redrawn */
+static boolean g_dashShownStale = FALSE;
+static boolean g_dashShownValid = FALSE;
+static uint8 g_dashCredit = 0;                    /* Last sequence number granted to the Control Unit */
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+static void HMI_showScreen(HMI_ScreenID screen);
+static void HMI_linkSendCommand(uint8 command);
+static void HMI_handleEvent(HMI_EventType event, uint8 value);
+
+/*******************************************************************************
+ *                             Display Functions                               *
+ *******************************************************************************/
+
+/*
+ * Function: HMI_updateSensors
+ * ----------------------------
+ * Displays the current temperature, distance, and window states on the LCD.
+ *
+ * temp      - pointer to the current temperature value
+ * distance  - pointer to the current distance value
+ * win1      - pointer to Window 1 state (OPENED/CLOSED)
+ * win2      - pointer to Window 2 state (OPENED/CLOSED)
+ */
+void HMI_updateSensors(uint8 *temp, uint16 *distance, uint8 *win1, uint8 *win2)
+{
+	LCD_moveCursor(0,0);
+	LCD_displayString_P(PSTR("Temperature: "));
+	LCD_displayInteger(*temp);
+	LCD_displayString_P(PSTR("C"));
+
+	LCD_moveCursor(1,0);
+	LCD_displayString_P(PSTR("Distance: "));
+	LCD_displayInteger(*distance);
+	LCD_displayString_P(PSTR("cm"));
+
+	LCD_moveCursor(2,0);
+	LCD_displayString_P(PSTR("Win1: "));
+	if(*win1 == OPENED){
+		LCD_displayString_P(PSTR("Open"));
+	}
+	else{
+		LCD_displayString_P(PSTR("Closed"));
+	}
+
+	LCD_moveCursor(3,0);
+	LCD_displayString_P(PSTR("Win2: "));
+	if(*win2 == OPENED){
+		LCD_displayString_P(PSTR("Open"));
+	}
+	else{
+		LCD_displayString_P(PSTR("Closed"));
+	}
+}
+
+/*
+ * Function: HMI_showPack
+ * -----------------------
+ * Decodes the received sensor data packet and displays it with HMI_updateSensors().
+ * Packet layout: distance high byte, distance low byte, temperature, win1, win2.
+ */
+static void HMI_showPack(void)
+{
+	uint8 tempValue = g_pack[2];
+	uint16 distanceValue = ((uint16)g_pack[0] << 8) | g_pack[1];
+	uint8 win1_State = g_pack[3];
+	uint8 win2_State = g_pack[4];
+
+	HMI_updateSensors(&tempValue, &distanceValue, &win1_State, &win2_State);
+}
+
+/*
+ * Function: HMI_showCountdown
+ * ----------------------------
+ * Draws the "Wait Ns..." line of the stop screen.
+ */
+static void HMI_showCountdown(void)
+{
+	LCD_displayStringRowColumn_P(2, 0, PSTR("Wait "));
+	LCD_displayInteger(g_countdown);
+	LCD_displayString_P(PSTR("s... "));
+}
+
+/*
+ * Function: HMI_showFault
+ * ------------------------
+ * Decodes one fault code and displays it on the next row of the fault page.
+ */
+static void HMI_showFault(uint8 faultCode)
+{
+	LCD_moveCursor(g_faultRow, 0);
+	if(faultCode == DTC_P001){
+		LCD_displayString_P(PSTR("P001: Too Close"));
+	}
+	else if(faultCode == DTC_P002){
+		LCD_displayString_P(PSTR("P002: Overheat"));
+	}
+	else if(faultCode == DTC_BAD_RECORD){
+		LCD_displayString_P(PSTR("Bad record"));
+	}
+	else{
+		LCD_displayString_P(PSTR("Fault code: "));  /* Code of a rule added on the Control Unit */
+		LCD_displayInteger(faultCode);
+	}
+	g_faultRow++;
+	g_totalFaults++;
+}
+
+/*
+ * Function: HMI_displayNumber
+ * ----------------------------
+ * Displays a number right-aligned in a field of the given width, so a shorter
+ * value overwrites the previous one completely.
+ */
+static void HMI_displayNumber(uint8 row, uint8 col, uint16 value, uint8 width)
+{
+	char buffer[6];
+	uint8 length;
+
+	utoa(value, buffer, 10);
+	length = strlen(buffer);
+
+	LCD_moveCursor(row, col);
+	while(length < width){
+		LCD_DisplayCharacter(' ');
+		length++;
+	}
+	LCD_displayString(buffer);
+}
+
+/*
+ * Function: HMI_showLinkStats
+ * ----------------------------
+ * Writes the request round-trip times (mean and worst case, in ms), the retries
+ * and the requests given up on the link screen.
+ */
+static void HMI_showLinkStats(void)
+{
+	HMI_displayNumber(0, 8, (g_rttCount == 0) ? 0 : (uint16)(g_rttSum / g_rttCount), 5);
+	HMI_displayNumber(1, 8, g_rttMax, 5);
+	HMI_displayNumber(2, 8, g_linkRetries, 5);
+	HMI_displayNumber(3, 8, g_linkFailures, 5);
+}
+
+/*
+ * Function: HMI_findDid
+ * ----------------------
+ * Looks a DID up in the last READ_DIDS response. Returns its data, or NULL_PTR
+ * if it is not there. The walk stops at an ID whose size is not known here.
+ */
+static const uint8 *HMI_findDid(uint16 id)
+{
+	uint16 found;
+	uint8 size;
+	uint8 i;
+
+	for(i = 0; i + 2 <= g_didLength; i += 2 + size){
+		found = ((uint16)g_didData[i] << 8) | g_didData[i + 1];
+		if(found < FRAME_DID_FIRST || found >= FRAME_DID_FIRST + FRAME_DIDS_COUNT){
+			break;
+		}
+		size = pgm_read_byte(&g_didSizes[found - FRAME_DID_FIRST]);
+		if(i + 2 + size > g_didLength){
+			break;
+		}
+		if(found == id){
+			return &g_didData[i + 2];
+		}
+	}
+
+	return NULL_PTR;
+}
+
+/*
+ * Function: HMI_showStatusDids
+ * -----------------------------
+ * Writes the DIDs of the last READ_DIDS response on the status screen.
+ */
+static void HMI_showStatusDids(void)
+{
+	const uint8 *data;
+
+	if((data = HMI_findDid(FRAME_DID_TEMPERATURE)) != NULL_PTR){
+		HMI_displayNumber(0, 2, data[0], 3);
+	}
+	if((data = HMI_findDid(FRAME_DID_DISTANCE)) != NULL_PTR){
+		HMI_displayNumber(1, 2, ((uint16)data[0] << 8) | data[1], 4);
+	}
+	if((data = HMI_findDid(FRAME_DID_MONITORING)) != NULL_PTR){
+		LCD_displayStringRowColumn_P(3, 12, data[0] ? STR_ON : STR_OFF);
+	}
+	if((data = HMI_findDid(FRAME_DID_FAULTS_LOGGED)) != NULL_PTR){
+		HMI_displayNumber(2, 8, ((uint16)data[0] << 8) | data[1], 5);
+	}
+}
+
+/*
+ * Function: HMI_showNodes
+ * ------------------------
+ * Writes the node numbers on the nodes screen, the node the other screens
+ * talk to is marked with '>'.
+ */
+static void HMI_showNodes(void)
+{
+	uint8 node;
+
+	for(node = 0; node < LINK_NODES_COUNT; node++){
+		LCD_moveCursor(node + 1, 0);
+		LCD_DisplayCharacter((node == g_node) ? '>' : ' ');
+		LCD_DisplayCharacter('1' + node);
+	}
+}
+
+/*
+ * Function: HMI_showNodeRates
+ * ----------------------------
+ * Writes the replies received from each node in the last NODES_REFRESH_MS
+ * window (its refresh rate in Hz) and starts a new window.
+ */
+static void HMI_showNodeRates(void)
+{
+	uint8 node;
+
+	for(node = 0; node < LINK_NODES_COUNT; node++){
+		HMI_displayNumber(node + 1, 13, g_nodeReplies[node], 3);
+		g_nodeReplies[node] = 0;
+	}
+}
+
+/*
+ * Function: HMI_showLog
+ * ----------------------
+ * Writes the fault log export progress: codes received, count per fault code
+ * (two codes per row) and the state of the export.
+ */
+static void HMI_showLog(void)
+{
+	uint8 i;
+
+	HMI_displayNumber(1, 7, g_logNext, 5);
+	for(i = 0; i < FRAME_FAULT_CODES_COUNT; i++){
+		HMI_displayNumber(2 + i / 2, 3 + (i % 2) * 8, g_logCounts[i], 5);
+	}
+	LCD_displayStringRowColumn_P(0, 12, !g_logDone ? STR_LOG_BUSY : (g_logFailed ? STR_LOG_FAILED : STR_LOG_DONE));
+}
+
+/*
+ * Function: HMI_showClear
+ * ------------------------
+ * Writes the state of the fault log clear: the erase progress while it runs,
+ * then the result. While it runs its state is read again when nothing came
+ * for CLEAR_POLL_MS.
+ */
+static void HMI_showClear(uint8 status, uint16 erased, uint16 pages)
+{
+	if(status == CLEAR_STARTED && erased < pages){
+		LCD_displayStringRowColumn_P(2, 0, STR_CLEAR_ERASED);
+		HMI_displayNumber(2, 7, erased, 4);
+		HMI_displayNumber(2, 12, pages, 4);
+		SWTIMER_startPeriodic(TIMER_SCREEN, CLEAR_POLL_MS);
+		return;
+	}
+
+	SWTIMER_stop(TIMER_SCREEN);
+	LCD_displayStringRowColumn_P(2, 0, (status == CLEAR_FAILED) ? STR_CLEAR_FAILED : STR_CLEAR_DONE);
+}
+
+/*
+ * Function: HMI_ruleValue
+ * ------------------------
+ * Returns the value of a field of the rule shown (FRAME_RULE_xxx offset).
+ */
+static uint16 HMI_ruleValue(uint8 field)
+{
+	if(field == FRAME_RULE_THRESHOLD){
+		return ((uint16)g_rule[RULE_DATA + field] << 8) | g_rule[RULE_DATA + field + 1];
+	}
+	return g_rule[RULE_DATA + field];
+}
+
+/*
+ * Function: HMI_showRule
+ * -----------------------
+ * Writes the rule shown: its fault code, the check it makes (signal,
+ * comparison and threshold), its hysteresis and its debounce count.
+ */
+static void HMI_showRule(void)
+{
+	uint8 signal = g_rule[RULE_DATA + FRAME_RULE_SIGNAL];
+
+	HMI_displayNumber(0, 5, g_ruleIndex + 1, 2);
+	HMI_displayNumber(0, 14, HMI_ruleValue(FRAME_RULE_CODE), 2);
+	LCD_displayStringRowColumn_P(1, 4, (signal == FRAME_SIGNAL_TEMPERATURE) ? STR_TEMP :
+	                                   (signal == FRAME_SIGNAL_DISTANCE) ? STR_DIST : STR_OFF);
+	LCD_DisplayCharacter(' ');
+	LCD_moveCursor(1, 9);
+	LCD_DisplayCharacter((g_rule[RULE_DATA + FRAME_RULE_COMPARE] == FRAME_COMPARE_ABOVE) ? '>' : '<');
+	HMI_displayNumber(1, 11, HMI_ruleValue(FRAME_RULE_THRESHOLD), 5);
+	HMI_displayNumber(2, 4, HMI_ruleValue(FRAME_RULE_HYSTERESIS), 3);
+	HMI_displayNumber(2, 13, HMI_ruleValue(FRAME_RULE_DEBOUNCE), 3);
+}
+
+/*
+ * Function: HMI_showRuleField
+ * ----------------------------
+ * Writes the field being edited and its value on the last row.
+ */
+static void HMI_showRuleField(void)
+{
+	LCD_displayStringRowColumn_P(3, 0, (const char *)pgm_read_word(&g_ruleFields[g_ruleField]));
+	HMI_displayNumber(3, 10, HMI_ruleValue(g_ruleField), 6);
+}
+
+/*
+ * Function: HMI_ruleType
+ * -----------------------
+ * Digit typed on the rules screen: the first one replaces the value of the
+ * field, the next ones append to it (saturated at the largest value). The
+ * signal is 0 temperature, 1 distance, any other digit no signal (rule not
+ * used), the comparison 0 below, any other digit above.
+ */
+static void HMI_ruleType(uint8 digit)
+{
+	uint32 value;
+
+	if(!g_ruleLoaded){
+		return;
+	}
+
+	if(g_ruleField == FRAME_RULE_SIGNAL){
+		value = (digit < FRAME_SIGNALS_COUNT) ? digit : FRAME_SIGNAL_NONE;
+	}
+	else if(g_ruleField == FRAME_RULE_COMPARE){
+		value = (digit != 0) ? FRAME_COMPARE_ABOVE : FRAME_COMPARE_BELOW;
+	}
+	else{
+		value = g_ruleTyping ? HMI_ruleValue(g_ruleField) * 10UL + digit : digit;
+		if(value > ((g_ruleField == FRAME_RULE_THRESHOLD) ? 0xFFFFUL : 0xFFUL)){
+			value = (g_ruleField == FRAME_RULE_THRESHOLD) ? 0xFFFFUL : 0xFFUL;
+		}
+	}
+	g_ruleTyping = TRUE;
+
+	if(g_ruleField == FRAME_RULE_THRESHOLD){
+		g_rule[RULE_DATA + g_ruleField] = (uint8)(value >> 8);
+		g_rule[RULE_DATA + g_ruleField + 1] = (uint8)value;
+	}
+	else{
+		g_rule[RULE_DATA + g_ruleField] = (uint8)value;
+	}
+	HMI_showRule();
+	HMI_showRuleField();
+}
+
+/*
+ * Function: HMI_logReceive
+ * -------------------------
+ * Counts the fault codes of a LOG_DATA frame of the window asked for and asks
+ * for the next window after its last frame. A frame past the next index
+ * expected means the frames in between were lost: the window is asked for
+ * again from the first missing fault. Frames of an earlier window and the
+ * ones sent again for a retried request are skipped.
+ */
+static void HMI_logReceive(const FRAME_Type *frame)
+{
+	uint16 index;
+	uint8 i;
+
+	if(frame->length < 2 || g_logDone || frame->seq != g_logSeq){
+		return;
+	}
+
+	index = ((uint16)frame->payload[0] << 8) | frame->payload[1];
+	if(index != g_logNext){
+		if((sint16)(index - g_logNext) > 0){
+			HMI_linkSendCommand(EXPORT_FAULTS);
+		}
+		return;
+	}
+
+	g_logFrames++;
+	g_logIdle = 0;
+	g_logRetries = 0;
+	for(i = 2; i < frame->length; i++){
+		if(frame->payload[i] >= 1 && frame->payload[i] <= FRAME_FAULT_CODES_COUNT){
+			g_logCounts[frame->payload[i] - 1]++;
+		}
+	}
+	g_logNext = index + (frame->length - 2);
+
+	if(frame->length == 2){
+		g_logDone = TRUE;
+		HMI_showLog();
+	}
+	else if(g_logFrames == LOG_WINDOW_FRAMES){
+		HMI_linkSendCommand(EXPORT_FAULTS);
+	}
+}
+
+/*
+ * Function: HMI_dashboardUpdate
+ * ------------------------------
+ * Writes the telemetry values on the dashboard, only the fields that changed
+ * since the last frame are redrawn (the LCD is slow compared to the frame rate).
+ * The payload layout is given by the FRAME_TELEMETRY_xxx offsets.
+ */
+static void HMI_dashboardUpdate(const uint8 *values)
+{
+	const uint8 temp = FRAME_TELEMETRY_TEMP;
+	const uint8 dist = FRAME_TELEMETRY_DISTANCE;
+	const uint8 win1 = FRAME_TELEMETRY_WIN1;
+	const uint8 win2 = FRAME_TELEMETRY_WIN2;
+
+	if(!g_dashShownValid || values[temp] != g_dashShown[temp]){
+		HMI_displayNumber(0, 2, values[temp], 3);
+	}
+	if(!g_dashShownValid || values[dist] != g_dashShown[dist] || values[dist + 1] != g_dashShown[dist + 1]){
+		HMI_displayNumber(0, 9, ((uint16)values[dist] << 8) | values[dist + 1], 4);
+	}
+	if(!g_dashShownValid || values[win1] != g_dashShown[win1]){
+		LCD_displayStringRowColumn_P(1, 3, (values[win1] == OPENED) ? STR_OPEN : STR_CLOSED_SHORT);
+	}
+	if(!g_dashShownValid || values[win2] != g_dashShown[win2]){
+		LCD_displayStringRowColumn_P(1, 11, (values[win2] == OPENED) ? STR_OPEN : STR_CLOSED_SHORT);
+	}
+	if(!g_dashShownValid || g_dashStale != g_dashShownStale){
+		LCD_moveCursor(0, LCD_COLUMNS - 1);
+		LCD_DisplayCharacter(g_dashStale ? '?' : ' ');
+	}
+
+	memcpy(g_dashShown, values, FRAME_TELEMETRY_LENGTH);
+	g_dashShownStale = g_dashStale;
+	g_dashShownValid = TRUE;
+}
+
+/*
+ * Function: HMI_dashboardReceive
+ * -------------------------------
+ * Updates the dashboard state with a telemetry frame: a keyframe replaces the
+ * whole state, a delta frame only the fields it carries. After a missed frame
+ * the other fields may be outdated, the state is marked stale ('?') until the
+ * next keyframe.
+ */
+static void HMI_dashboardReceive(const FRAME_Type *frame)
+{
+	uint32 time;
+	uint8 missed = 0;
+
+	/* Sequence gaps are frames lost on the link or dropped by the sender */
+	if(g_dashSynced){
+		missed = (uint8)(frame->seq - g_dashLastSeq - 1);
+	}
+
+	if(frame->type == FRAME_TYPE_TELEMETRY){
+		if(frame->length != FRAME_TELEMETRY_LENGTH){
+			return;
+		}
+		time = ((uint32)frame->payload[FRAME_TELEMETRY_TIME] << 24) |
+		       ((uint32)frame->payload[FRAME_TELEMETRY_TIME + 1] << 16) |
+		       ((uint32)frame->payload[FRAME_TELEMETRY_TIME + 2] << 8) |
+		       frame->payload[FRAME_TELEMETRY_TIME + 3];
+
+		/* A sample time going back means the Control Unit restarted (no gap) */
+		if(time < g_dashLastTime){
+			missed = 0;
+		}
+		g_dashLastTime = time;
+
+		memcpy(g_dashState, frame->payload, FRAME_TELEMETRY_LENGTH);
+		g_dashHaveState = TRUE;
+		g_dashStale = FALSE;
+	}
+	else{
+		if(!FRAME_applyDelta(g_dashState, frame->payload, frame->length)){
+			return;
+		}
+		if(missed != 0){
+			g_dashStale = TRUE;
+		}
+	}
+
+	g_dashLost += missed;
+	g_dashSynced = TRUE;
+	g_dashLastSeq = frame->seq;
+	g_dashFrames++;
+}
+
+/*******************************************************************************
+ *                               Link Functions                                *
+ *******************************************************************************/
+
+/*
+ * Function: HMI_linkCanSend
+ * --------------------------
+ * Returns TRUE when frames can be sent: not during the link training nor
+ * during a baud rate negotiation step.
+ */
+static boolean HMI_linkCanSend(void)
+{
+	return (g_linkState == LINK_IDLE && g_baudState == BAUD_IDLE);
+}
+
+/*
+ * Function: HMI_linkSelect
+ * -------------------------
+ * Returns TRUE when the frames sent now go to the given node. On a multi-drop
+ * line another node is only deselected once it has nothing left to answer
+ * and every queued frame is on its way to it, the address is sent then.
+ */
+static boolean HMI_linkSelect(uint8 node)
+{
+	uint8 i;
+
+	if(!LINK_MULTIDROP || node == g_linkNode){
+		return TRUE;
+	}
+
+	for(i = 0; i < LINK_MAX_OUTSTANDING; i++){
+		if(g_requests[i].used && g_requests[i].attempts != 0){
+			return FALSE;  /* In flight: its node is the addressed one */
+		}
+	}
+	FRAME_service();
+	if(!FRAME_queuesEmpty()){
+		return FALSE;
+	}
+
+	UART_sendAddress(node + 1);
+	g_linkNode = node;
+	return TRUE;
+}
+
+/*
+ * Function: HMI_linkDeadline
+ * ---------------------------
+ * Time a request may take: its frame and the longest response to its command
+ * at the current rate (LINK_BITS_PER_BYTE per byte), once for every request in flight
+ * since their frames share the line, plus LINK_PROCESSING_MS.
+ */
+static uint16 HMI_linkDeadline(const HMI_RequestType *request)
+{
+	uint32 bits = LINK_BITS_PER_BYTE * (2 * FRAME_OVERHEAD + request->length + 1);
+
+	switch(request->data[0]){
+	case DISPLAY_VALUES:
+		bits += LINK_BITS_PER_BYTE * PACK_SIZE;
+		break;
+
+	case DETECT_FAULTS:
+		bits += LINK_BITS_PER_BYTE * (1 + FAULTS_PER_PAGE);
+		break;
+
+	case READ_THRESHOLDS:
+		bits += LINK_BITS_PER_BYTE * THRESHOLDS_SIZE;
+		break;
+
+	case READ_DIDS:
+		bits += LINK_BITS_PER_BYTE * DIDS_MAX_LENGTH;
+		break;
+
+	case READ_WEAR:
+		bits += LINK_BITS_PER_BYTE * WEAR_SIZE;
+		break;
+
+	case CLEAR_DTC:
+		bits += LINK_BITS_PER_BYTE * CLEAR_SIZE;
+		break;
+
+	case FIND_FAULTS:
+		bits += LINK_BITS_PER_BYTE * FIND_SIZE;
+		break;
+
+	case READ_RULE:
+		bits += LINK_BITS_PER_BYTE * RULE_SIZE;
+		break;
+
+	case WRITE_RULE:
+		bits += LINK_BITS_PER_BYTE;
+		break;
+
+	default:
+		break;
+	}
+	bits *= g_linkOutstanding;
+
+	return LINK_PROCESSING_MS + (uint16)((bits * 1000UL + g_baudRates[g_baudIndex] - 1) / g_baudRates[g_baudIndex]);
+}
+
+/*
+ * Function: HMI_linkArm
+ * ----------------------
+ * Starts the link timer on the earliest deadline of the requests in flight.
+ */
+static void HMI_linkArm(void)
+{
+	uint32 now = SWTIMER_getTime();
+	sint32 next = 0;
+	boolean armed = FALSE;
+	uint8 i;
+
+	for(i = 0; i < LINK_MAX_OUTSTANDING; i++){
+		if(g_requests[i].used && g_requests[i].attempts != 0){
+			if(!armed || (sint32)(g_requests[i].deadline - now) < next){
+				next = (sint32)(g_requests[i].deadline - now);
+				armed = TRUE;
+			}
+		}
+	}
+
+	if(!armed){
+		SWTIMER_stop(TIMER_LINK);
+	}
+	else{
+		SWTIMER_start(TIMER_LINK, (next > 0) ? (uint16)next : 1);
+	}
+}
+
+/*
+ * Function: HMI_linkTransmit
+ * ---------------------------
+ * Sends a request (again, with the same correlation id) and sets the deadline
+ * of this attempt. The caller rearms the link timer.
+ */
+static void HMI_linkTransmit(HMI_RequestType *request)
+{
+	uint32 now = SWTIMER_getTime();
+
+	if(request->attempts == 0){
+		request->startTime = now;
+	}
+	request->attempts++;
+	request->deadline = now + HMI_linkDeadline(request);
+	FRAME_queue(FRAME_TYPE_REQUEST, request->id, request->data, request->length);
+}
+
+/*
+ * Function: HMI_linkSendNodeCommand
+ * ----------------------------------
+ * Sends a command to a Control Unit in a request frame with a new correlation
+ * id, the response is waited for without blocking and other requests may be
+ * sent meanwhile. While the link cannot be used or the node cannot be
+ * addressed yet the request waits in its slot.
+ * With all the slots in flight the command is dropped (counted as a failure).
+ */
+static void HMI_linkSendNodeCommand(uint8 node, uint8 command)
+{
+	HMI_RequestType *request = NULL_PTR;
+	uint8 i;
+
+	for(i = 0; i < LINK_MAX_OUTSTANDING; i++){
+		if(!g_requests[i].used){
+			request = &g_requests[i];
+			break;
+		}
+	}
+	if(request == NULL_PTR){
+		g_linkFailures++;
+		return;
+	}
+
+	request->data[0] = command;
+	request->length = 1;
+	if(command == DETECT_FAULTS){
+		/* Next page of the fault viewer */
+		request->data[1] = (uint8)(g_totalFaults >> 8);
+		request->data[2] = (uint8)g_totalFaults;
+		request->data[3] = FAULTS_PER_PAGE;
+		request->length = 4;
+	}
+	else if(command == READ_DIDS){
+		/* DIDs of the status screen */
+		for(i = 0; i < STATUS_DIDS_COUNT; i++){
+			request->data[request->length++] = (uint8)(pgm_read_word(&g_statusDids[i]) >> 8);
+			request->data[request->length++] = (uint8)pgm_read_word(&g_statusDids[i]);
+		}
+	}
+	else if(command == EXPORT_FAULTS){
+		/* Next window of the fault log export, its LOG_DATA frames carry the id given below */
+		request->data[1] = (uint8)(g_logNext >> 8);
+		request->data[2] = (uint8)g_logNext;
+		request->data[3] = LOG_WINDOW_FRAMES;
+		request->length = 4;
+		g_logSeq = g_linkNextId;
+		g_logFrames = 0;
+		g_logIdle = 0;
+	}
+	else if(command == CLEAR_DTC){
+		request->data[1] = g_clearMode;
+		request->length = 2;
+	}
+	else if(command == READ_RULE){
+		request->data[1] = g_ruleIndex;
+		request->length = 2;
+	}
+	else if(command == WRITE_RULE){
+		/* Rule of the rules screen, as edited */
+		request->data[1] = g_ruleIndex;
+		memcpy(&request->data[2], &g_rule[RULE_DATA], FRAME_RULE_LENGTH);
+		request->length = 2 + FRAME_RULE_LENGTH;
+	}
+
+	request->used = TRUE;
+	request->node = node;
+	request->id = g_linkNextId++;
+	request->attempts = 0;
+	g_linkOutstanding++;
+
+	if(HMI_linkCanSend() && HMI_linkSelect(node)){
+		HMI_linkTransmit(request);
+		HMI_linkArm();
+	}
+}
+
+/*
+ * Function: HMI_linkSendCommand
+ * ------------------------------
+ * Sends a command to the node chosen on the nodes screen.
+ */
+static void HMI_linkSendCommand(uint8 command)
+{
+	HMI_linkSendNodeCommand(g_node, command);
+}
+
+/*
+ * Function: HMI_linkPollNext
+ * ---------------------------
+ * Nodes screen: asks the next node for its DIDs, one node at a time so each
+ * one is addressed as soon as the previous one answered or was given up.
+ */
+static void HMI_linkPollNext(void)
+{
+	g_nodePoll = (g_nodePoll + 1) % LINK_NODES_COUNT;
+	HMI_linkSendNodeCommand(g_nodePoll, READ_DIDS);
+}
+
+/*
+ * Function: HMI_linkTrain
+ * ------------------------
+ * Startup link training: sends SYNC_BYTE every TRAINING_SYNC_PERIOD_MS, the
+ * Control Unit times it, sets its baud rate to match and answers with ACK.
+ */
+static void HMI_linkTrain(void)
+{
+	g_linkState = LINK_TRAINING;
+	g_trainingSyncs = 1;
+	UART_sendByte(SYNC_BYTE);
+	SWTIMER_start(TIMER_LINK, TRAINING_SYNC_PERIOD_MS);
+}
+
+/*
+ * Function: HMI_linkSubscribe
+ * ----------------------------
+ * Asks the Control Unit to push telemetry frames at the given rate (0 = stop),
+ * with an initial credit of DASH_CREDIT_WINDOW frames.
+ * While the link cannot be used the subscription is kept and sent afterwards.
+ */
+static void HMI_linkSubscribe(uint8 rate_Hz)
+{
+	uint8 payload[2];
+
+	g_dashSubscription = rate_Hz;
+
+	if(!HMI_linkCanSend() || !HMI_linkSelect(g_node)){
+		g_dashSubscriptionPending = TRUE;
+		return;
+	}
+
+	g_dashSubscriptionPending = FALSE;
+	payload[0] = g_dashSubscription;
+	payload[1] = DASH_CREDIT_WINDOW;
+	FRAME_queue(FRAME_TYPE_SUBSCRIBE, 0, payload, 2);
+}
+
+/*
+ * Function: HMI_linkGrantCredit
+ * ------------------------------
+ * Lets the Control Unit send telemetry frames up to DASH_CREDIT_WINDOW after
+ * the last one received. The grant is absolute, a lost one is made up for by
+ * the next.
+ */
+static void HMI_linkGrantCredit(void)
+{
+	if(!g_dashSynced || !HMI_linkCanSend() || (LINK_MULTIDROP && g_linkNode != g_node)){
+		return;
+	}
+
+	g_dashCredit = g_dashLastSeq + DASH_CREDIT_WINDOW;
+	FRAME_queue(FRAME_TYPE_CREDIT, 0, &g_dashCredit, 1);
+}
+
+/*
+ * Function: HMI_linkResume
+ * -------------------------
+ * Called when the link can be used again (training or negotiation step over)
+ * and, on a multi-drop line, from the main loop for the requests waiting for
+ * their node to be addressed: sends what waited.
+ */
+static void HMI_linkResume(void)
+{
+	boolean sent = FALSE;
+	uint8 i;
+
+	if(!HMI_linkCanSend()){
+		return;
+	}
+
+	if(g_dashSubscriptionPending){
+		HMI_linkSubscribe(g_dashSubscription);
+	}
+	for(i = 0; i < LINK_MAX_OUTSTANDING; i++){
+		if(g_requests[i].used && g_requests[i].attempts == 0 && HMI_linkSelect(g_requests[i].node)){
+			HMI_linkTransmit(&g_requests[i]);
+			sent = TRUE;
+		}
+	}
+	if(sent){
+		HMI_linkArm();
+	}
+}
+
+/*
+ * Function: HMI_linkTrainingEnd
+ * ------------------------------
+ * Ends the link training, with or without an answer.
+ */
+static void HMI_linkTrainingEnd(void)
+{
+	SWTIMER_stop(TIMER_LINK);
+	g_linkState = LINK_IDLE;
+	HMI_linkResume();
+}
+
+/*
+ * Function: HMI_linkResponse
+ * ---------------------------
+ * Response frame: ends the request in flight with the same correlation id,
+ * records the round trip and raises a frame event with the received data.
+ * A late response to a request already given up is dropped.
+ */
+static void HMI_linkResponse(const FRAME_Type *frame)
+{
+	HMI_RequestType *request = NULL_PTR;
+	uint32 rtt;
+	uint8 command;
+	uint8 i;
+
+	if(frame->length < 1){
+		return;
+	}
+	for(i = 0; i < LINK_MAX_OUTSTANDING; i++){
+		if(g_requests[i].used && g_requests[i].attempts != 0 &&
+		   g_requests[i].id == frame->seq && g_requests[i].data[0] == frame->payload[0]){
+			request = &g_requests[i];
+			break;
+		}
+	}
+	if(request == NULL_PTR){
+		return;
+	}
+
+	rtt = SWTIMER_getTime() - request->startTime;
+	g_rttCount++;
+	g_rttSum += rtt;
+	if(rtt > g_rttMax){
+		g_rttMax = (rtt > 0xFFFF) ? 0xFFFF : (uint16)rtt;
+	}
+
+	request->used = FALSE;
+	g_linkOutstanding--;
+	HMI_linkArm();
+
+	command = frame->payload[0];
+	if(command == DISPLAY_VALUES && frame->length >= 1 + PACK_SIZE){
+		memcpy(g_pack, &frame->payload[1], PACK_SIZE);
+		HMI_handleEvent(EVENT_FRAME, FRAME_PACK);
+	}
+	else if(command == DETECT_FAULTS && frame->length >= 2){
+		g_faultFlags = frame->payload[1];
+		g_faultCount = frame->length - 2;
+		if(g_faultCount > FAULTS_PER_PAGE){
+			g_faultCount = FAULTS_PER_PAGE;
+		}
+		memcpy(g_faultCodes, &frame->payload[2], g_faultCount);
+		HMI_handleEvent(EVENT_FRAME, FRAME_FAULTS);
+	}
+	else if(command == READ_THRESHOLDS && frame->length >= 1 + THRESHOLDS_SIZE){
+		memcpy(g_thresholds, &frame->payload[1], THRESHOLDS_SIZE);
+		HMI_handleEvent(EVENT_FRAME, FRAME_THRESHOLDS);
+	}
+	else if(command == READ_DIDS){
+		g_didLength = frame->length - 1;
+		memcpy(g_didData, &frame->payload[1], g_didLength);
+		HMI_handleEvent(EVENT_FRAME, FRAME_DIDS);
+	}
+	else if(command == READ_WEAR && frame->length >= 1 + WEAR_SIZE){
+		memcpy(g_wear, &frame->payload[1], WEAR_SIZE);
+		HMI_handleEvent(EVENT_FRAME, FRAME_WEAR);
+	}
+	else if(command == CLEAR_DTC && frame->length >= 1 + CLEAR_SIZE){
+		g_clearStatus = frame->payload[1];
+		g_clearErased = ((uint16)frame->payload[2] << 8) | frame->payload[3];
+		g_clearPages = ((uint16)frame->payload[4] << 8) | frame->payload[5];
+		HMI_handleEvent(EVENT_FRAME, FRAME_CLEAR);
+	}
+	else if(command == FIND_FAULTS){
+		/* Nothing after the command: EEPROM error, the whole log is shown */
+		g_faultFirst = (frame->length >= 1 + FIND_SIZE) ? ((uint16)frame->payload[1] << 8) | frame->payload[2] : 0;
+		HMI_handleEvent(EVENT_FRAME, FRAME_FIND);
+	}
+	else if(command == READ_RULE && frame->length >= 1 + RULE_SIZE){
+		memcpy(g_rule, &frame->payload[1], RULE_SIZE);
+		HMI_handleEvent(EVENT_FRAME, FRAME_RULE);
+	}
+	else if(command == WRITE_RULE && frame->length >= 2){
+		g_ruleStatus = frame->payload[1];
+		HMI_handleEvent(EVENT_FRAME, FRAME_RULE_SAVED);
+	}
+}
+
+/*
+ * Function: HMI_linkTimeout
+ * --------------------------
+ * Link timer expiry: every request past its deadline is sent again, or given
+ * up after LINK_MAX_ATTEMPTS. Returns TRUE if a request was given up.
+ */
+static boolean HMI_linkTimeout(void)
+{
+	uint32 now = SWTIMER_getTime();
+	boolean failed = FALSE;
+	uint8 i;
+
+	for(i = 0; i < LINK_MAX_OUTSTANDING; i++){
+		if(!g_requests[i].used || g_requests[i].attempts == 0 ||
+		   (sint32)(now - g_requests[i].deadline) < 0){
+			continue;
+		}
+
+		/* The request or its response was lost */
+		if(g_requests[i].attempts < LINK_MAX_ATTEMPTS){
+			g_linkRetries++;
+			HMI_linkTransmit(&g_requests[i]);
+		}
+		else{
+			g_linkFailures++;
+			g_requests[i].used = FALSE;
+			g_linkOutstanding--;
+			failed = TRUE;
+		}
+	}
+
+	HMI_linkArm();
+	return failed;
+}
+
+/*
+ * Function: HMI_baudSetRate
+ * --------------------------
+ * Switches the UART to a rate of FRAME_BAUD_RATES.
+ */
+static void HMI_baudSetRate(uint8 index)
+{
+	UART_ErrorCountersType counters;
+
+	g_baudIndex = index;
+	UART_setBaudRate(g_baudRates[index]);
+	FRAME_resetReceiver(&g_frameRx);
+
+	/* Errors seen while both ends were switching do not count against the new rate */
+	UART_getErrorCounters(&counters);
+	g_lineErrors = counters.frame_errors + counters.data_overruns + counters.parity_errors;
+}
+
+/*
+ * Function: HMI_baudRequest
+ * --------------------------
+ * Asks the Control Unit for a rate, it answers with the fastest one both support.
+ * Commands and subscriptions wait until the negotiation ends.
+ */
+static void HMI_baudRequest(uint8 index)
+{
+	g_baudState = BAUD_WAIT_ACCEPT;
+	FRAME_queue(FRAME_TYPE_BAUD_REQUEST, 0, &index, 1);
+	SWTIMER_startPeriodic(TIMER_BAUD, BAUD_CHECK_PERIOD_MS);
+}
+
+/*
+ * Function: HMI_baudEnd
+ * ----------------------
+ * Ends a negotiation step and sends what waited for it.
+ */
+static void HMI_baudEnd(void)
+{
+	g_baudState = BAUD_IDLE;
+	HMI_linkResume();
+}
+
+/*
+ * Function: HMI_baudReceive
+ * --------------------------
+ * Negotiation frames from the Control Unit.
+ * BAUD_ACCEPT: switch to the accepted rate and confirm it with a link check.
+ * LINK_STATUS: the rate works, the line errors of both ends decide whether it
+ * must step down.
+ */
+static void HMI_baudReceive(const FRAME_Type *frame)
+{
+	UART_ErrorCountersType counters;
+	uint16 errors;
+
+	if(frame->length < 1){
+		return;
+	}
+
+	if(frame->type == FRAME_TYPE_BAUD_ACCEPT){
+		if(g_baudState != BAUD_WAIT_ACCEPT || frame->payload[0] >= FRAME_BAUD_RATES_COUNT){
+			return;
+		}
+		g_baudPrevious = g_baudIndex;
+		HMI_baudSetRate(frame->payload[0]);
+		_delay_ms(BAUD_SWITCH_GUARD_MS);
+
+		g_baudState = BAUD_WAIT_CONFIRM;
+		g_baudMissed = 0;
+		FRAME_queue(FRAME_TYPE_LINK_CHECK, 0, NULL_PTR, 0);
+		SWTIMER_startPeriodic(TIMER_BAUD, BAUD_CHECK_PERIOD_MS);
+		return;
+	}
+
+	/* LINK_STATUS */
+	g_baudMissed = 0;
+	if(g_baudState == BAUD_WAIT_CONFIRM){
+		g_baudAttempts = 0;
+		HMI_baudEnd();
+	}
+
+	UART_getErrorCounters(&counters);
+	errors = counters.frame_errors + counters.data_overruns + counters.parity_errors;
+	if((uint16)(errors - g_lineErrors) + frame->payload[0] > BAUD_ERROR_THRESHOLD && g_baudIndex != 0){
+		g_baudCeiling = g_baudIndex - 1;
+		if(HMI_linkCanSend() && g_linkOutstanding == 0){
+			HMI_baudRequest(g_baudCeiling);
+		}
+	}
+	g_lineErrors = errors;
+}
+
+/*
+ * Function: HMI_baudTick
+ * -----------------------
+ * Runs every BAUD_CHECK_PERIOD_MS: times out the negotiation steps, steps the
+ * rate up to the ceiling and checks the link above the base rate.
+ */
+static void HMI_baudTick(void)
+{
+	switch(g_baudState){
+
+	case BAUD_WAIT_ACCEPT:
+		/* No answer: retry on the next tick, a Control Unit that never answers keeps the rate */
+		if(++g_baudAttempts >= BAUD_MAX_ATTEMPTS){
+			g_baudCeiling = g_baudIndex;
+		}
+		HMI_baudEnd();
+		break;
+
+	case BAUD_WAIT_CONFIRM:
+		/* The new rate does not work: back to the previous one, the Control Unit does the same */
+		g_baudCeiling = (g_baudIndex > g_baudPrevious) ? g_baudIndex - 1 : g_baudPrevious;
+		HMI_baudSetRate(g_baudPrevious);
+		HMI_baudEnd();
+		break;
+
+	default:
+		if(g_linkState != LINK_IDLE || g_linkOutstanding != 0){
+			break;  /* Never switch with requests in flight */
+		}
+		if(g_baudIndex < g_baudCeiling){
+			HMI_baudRequest(g_baudCeiling);
+		}
+		else if(g_baudIndex != 0){
+			if(g_baudMissed >= BAUD_MAX_MISSED_CHECKS){
+				/* Link lost: both ends fall back to the base rate on their own */
+				g_baudCeiling = g_baudIndex - 1;
+				g_baudMissed = 0;
+				HMI_baudSetRate(0);
+			}
+			else{
+				g_baudMissed++;
+				FRAME_queue(FRAME_TYPE_LINK_CHECK, 0, NULL_PTR, 0);
+			}
+		}
+		break;
+	}
+}
+
+/*
+ * Function: HMI_linkReceive
+ * --------------------------
+ * Receive state machine, assembles the UART bytes into frames and dispatches
+ * each complete one. Bytes outside frames are only expected during the link
+ * training (its ACK), the frame receiver skips them otherwise.
+ */
+static void HMI_linkReceive(uint8 data)
+{
+	if(g_linkState == LINK_TRAINING){
+		if(data == ACK){
+			HMI_linkTrainingEnd();  /* Rates match */
+		}
+		return;
+	}
+
+	if(!FRAME_receiveByte(&g_frameRx, data)){
+		return;
+	}
+
+	switch(g_frameRx.frame.type){
+	case FRAME_TYPE_TELEMETRY:
+	case FRAME_TYPE_TELEMETRY_DELTA:
+		HMI_handleEvent(EVENT_FRAME, FRAME_TELEMETRY);
+		break;
+
+	case FRAME_TYPE_BAUD_ACCEPT:
+	case FRAME_TYPE_LINK_STATUS:
+		HMI_baudReceive(&g_frameRx.frame);
+		break;
+
+	case FRAME_TYPE_LOG_DATA:
+		HMI_handleEvent(EVENT_FRAME, FRAME_LOG);
+		break;
+
+	case FRAME_TYPE_CLEAR_PROGRESS:
+		HMI_handleEvent(EVENT_FRAME, FRAME_CLEAR_PROGRESS);
+		break;
+
+	case FRAME_TYPE_RESPONSE:
+		HMI_linkResponse(&g_frameRx.frame);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/*******************************************************************************
+ *                          Screen State Machine                               *
+ *******************************************************************************/
+
+/*
+ * Function: HMI_showScreen
+ * -------------------------
+ * Leaves the current screen, draws the new one from the flash screen table and
+ * starts its timer if it has one.
+ */
+static void HMI_showScreen(HMI_ScreenID screen)
+{
+	uint8 i;
+
+	/* A full fault page only waits for a key while it is shown */
+	g_faultMore = FALSE;
+
+	/* Leaving the dashboard ends the subscription */
+	if(g_currentScreen == SCREEN_DASHBOARD && screen != SCREEN_DASHBOARD){
+		SWTIMER_stop(TIMER_DASH);
+		HMI_linkSubscribe(0);
+	}
+
+	SWTIMER_stop(TIMER_SCREEN);
+	g_currentScreen = screen;
+	MENU_showScreen(&g_screens[screen]);
+
+	switch(screen){
+	case SCREEN_WELCOME:
+		SWTIMER_start(TIMER_SCREEN, WELCOME_TIME_MS);
+		break;
+
+	case SCREEN_SYSTEM_STARTED:
+		SWTIMER_start(TIMER_SCREEN, HOLD_TIME_MS);
+		break;
+
+	case SCREEN_SENSOR_VALUES:
+		HMI_showPack();
+		SWTIMER_start(TIMER_SCREEN, HOLD_TIME_MS);
+		break;
+
+	case SCREEN_FAULT_LIST:
+		g_faultRow = 0;
+		break;
+
+	case SCREEN_READING_FAULTS:
+		g_totalFaults = 0;
+		g_faultFirst = 0;
+		break;
+
+	case SCREEN_RULES:
+		/* The rule is read by the READ_RULE command of the key, editing waits for it */
+		g_ruleLoaded = FALSE;
+		g_ruleField = FRAME_RULE_THRESHOLD;
+		g_ruleTyping = FALSE;
+		HMI_displayNumber(0, 5, g_ruleIndex + 1, 2);
+		break;
+
+	case SCREEN_SYSTEM_STOPPED:
+		g_countdown = COUNTDOWN_SECONDS;
+		HMI_showCountdown();
+		SWTIMER_start(TIMER_SCREEN, COUNTDOWN_STEP_MS);
+		break;
+
+	case SCREEN_LINK_STATS:
+		HMI_showLinkStats();
+		SWTIMER_startPeriodic(TIMER_SCREEN, LINK_STATS_REFRESH_MS);
+		break;
+
+	case SCREEN_LOG_EXPORT:
+		/* The export itself is started by the EXPORT_FAULTS command of the key */
+		g_logNext = 0;
+		memset(g_logCounts, 0, sizeof(g_logCounts));
+		g_logRetries = 0;
+		g_logFailed = FALSE;
+		g_logDone = FALSE;
+		HMI_showLog();
+		SWTIMER_startPeriodic(TIMER_SCREEN, LOG_REFRESH_MS);
+		break;
+
+	case SCREEN_STATUS:
+		/* Two requests in flight together, each field is filled when its response comes */
+		HMI_linkSendCommand(READ_DIDS);
+		HMI_linkSendCommand(READ_THRESHOLDS);
+		break;
+
+	case SCREEN_NODES:
+		for(i = 0; i < LINK_NODES_COUNT; i++){
+			g_nodeReplies[i] = 0;
+		}
+		HMI_showNodes();
+		if(g_linkOutstanding == 0){
+			HMI_linkPollNext();
+		}
+		SWTIMER_startPeriodic(TIMER_SCREEN, NODES_REFRESH_MS);
+		break;
+
+	case SCREEN_DASHBOARD:
+		g_dashFrames = 0;
+		g_dashLost = 0;
+		g_dashTicks = 0;
+		g_dashSynced = FALSE;
+		g_dashHaveState = FALSE;
+		g_dashStale = FALSE;
+		g_dashLastTime = 0;
+		g_dashShownValid = FALSE;
+		HMI_displayNumber(2, 4, pgm_read_byte(&g_dashRates[g_dashRateIndex]), 3);
+		HMI_displayNumber(2, 12, 0, 3);
+		HMI_displayNumber(3, 5, 0, 5);
+		HMI_linkSubscribe(pgm_read_byte(&g_dashRates[g_dashRateIndex]));
+		SWTIMER_startPeriodic(TIMER_DASH, DASH_REFRESH_MS);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/*
+ * Function: HMI_handleLocalCommand
+ * ---------------------------------
+ * Actions bound to keys that are handled by the HMI itself.
+ */
+static void HMI_handleLocalCommand(uint8 command)
+{
+	if((command & 0xF0) == RULE_DIGIT){
+		HMI_ruleType(command & 0x0F);
+		return;
+	}
+
+	switch(command){
+	case NODE_NEXT:
+		/* Node of the other screens, only changed here so the dashboard never switches node */
+		g_node = (g_node + 1) % LINK_NODES_COUNT;
+		HMI_showNodes();
+		return;
+
+	case LOG_CLEAR_QUICK:
+	case LOG_CLEAR_ERASE:
+		/* The status line follows the response, then the erase progress frames */
+		g_clearMode = (command == LOG_CLEAR_ERASE) ? CLEAR_ERASE : CLEAR_QUICK;
+		LCD_displayStringRowColumn_P(2, 0, STR_CLEAR_BUSY);
+		HMI_linkSendCommand(CLEAR_DTC);
+		return;
+
+	case RULE_NEXT:
+		g_ruleIndex = (g_ruleIndex + 1) % FRAME_RULES_COUNT;
+		HMI_showScreen(SCREEN_RULES);
+		HMI_linkSendCommand(READ_RULE);
+		return;
+
+	case RULE_FIELD:
+		g_ruleField += (g_ruleField == FRAME_RULE_THRESHOLD) ? 2 : 1;
+		if(g_ruleField >= FRAME_RULE_LENGTH){
+			g_ruleField = FRAME_RULE_SIGNAL;
+		}
+		g_ruleTyping = FALSE;
+		if(g_ruleLoaded){
+			HMI_showRuleField();
+		}
+		return;
+
+	case RULE_SAVE:
+		/* The status line follows the response */
+		if(g_ruleLoaded){
+			g_ruleTyping = FALSE;
+			LCD_displayStringRowColumn_P(3, 0, STR_RULE_SAVING);
+			HMI_linkSendCommand(WRITE_RULE);
+		}
+		return;
+
+	case DASH_RATE_UP:
+		if(g_dashRateIndex < DASH_RATES_COUNT - 1){
+			g_dashRateIndex++;
+		}
+		break;
+
+	case DASH_RATE_DOWN:
+		if(g_dashRateIndex > 0){
+			g_dashRateIndex--;
+		}
+		break;
+
+	default:
+		return;
+	}
+
+	/* New rate: resubscribe (the stream restarts with a keyframe) and restart the statistics */
+	HMI_displayNumber(2, 4, pgm_read_byte(&g_dashRates[g_dashRateIndex]), 3);
+	g_dashFrames = 0;
+	g_dashTicks = 0;
+	g_dashSynced = FALSE;
+	HMI_linkSubscribe(pgm_read_byte(&g_dashRates[g_dashRateIndex]));
+	SWTIMER_startPeriodic(TIMER_DASH, DASH_REFRESH_MS);
+}
+
+/*
+ * Function: HMI_handleKey
+ * ------------------------
+ * Key event: looks the key up in the bindings of the current screen, sends the
+ * bound command and moves to the bound screen.
+ */
+static void HMI_handleKey(uint8 key)
+{
+	MENU_KeyBindingType binding;
+
+	/* On a full fault page any key other than the menu key asks for the next page */
+	if(g_faultMore && key != MENU_MAIN){
+		HMI_showScreen(SCREEN_FAULT_LIST);
+		HMI_linkSendCommand(DETECT_FAULTS);
+		return;
+	}
+
+	if(!MENU_getBinding(&g_screens[g_currentScreen], key, &binding)){
+		HMI_showScreen(SCREEN_INVALID_KEY);
+		return;
+	}
+
+	if(binding.command != MENU_NO_COMMAND && (binding.command & MENU_LOCAL_FLAG)){
+		HMI_handleLocalCommand(binding.command);
+		return;
+	}
+
+	/* Change screen first, leaving the dashboard must unsubscribe before the command */
+	HMI_showScreen(binding.screen);
+
+	if(binding.command != MENU_NO_COMMAND){
+		HMI_linkSendCommand(binding.command);
+	}
+}
+
+/*
+ * Function: HMI_handleFrame
+ * --------------------------
+ * Frame event: updates the screen waiting for the received data.
+ * Frames that arrive after the user left the screen are dropped.
+ */
+static void HMI_handleFrame(HMI_FrameType frame)
+{
+	const uint8 *data;
+	uint16 erased;
+	uint16 pages;
+	uint8 i;
+
+	switch(frame){
+	case FRAME_PACK:
+		if(g_currentScreen == SCREEN_DISPLAY_VALUES){
+			HMI_showScreen(SCREEN_SENSOR_VALUES);
+		}
+		break;
+
+	case FRAME_THRESHOLDS:
+		if(g_currentScreen == SCREEN_STATUS){
+			HMI_displayNumber(0, 12, g_thresholds[0], 3);
+			HMI_displayNumber(1, 13, g_thresholds[1], 3);
+		}
+		break;
+
+	case FRAME_WEAR:
+		if(g_currentScreen == SCREEN_WEAR){
+			HMI_displayNumber(0, 11, ((uint16)g_wear[6] << 8) | g_wear[7], 5);
+			HMI_displayNumber(1, 11, ((uint16)g_wear[4] << 8) | g_wear[5], 5);
+			HMI_displayNumber(2, 11, ((uint16)g_wear[8] << 8) | g_wear[9], 5);
+			HMI_displayNumber(3, 5, ((uint16)g_wear[2] << 8) | g_wear[3], 4);
+			HMI_displayNumber(3, 12, ((uint16)g_wear[0] << 8) | g_wear[1], 4);
+		}
+		break;
+
+	case FRAME_LOG:
+		if(g_currentScreen == SCREEN_LOG_EXPORT){
+			HMI_logReceive(&g_frameRx.frame);
+		}
+		break;
+
+	case FRAME_CLEAR:
+		if(g_currentScreen == SCREEN_CLEAR_LOG){
+			HMI_showClear(g_clearStatus, g_clearErased, g_clearPages);
+		}
+		break;
+
+	case FRAME_CLEAR_PROGRESS:
+		/* Pages erased, pages in the journal: all of them ends the erase */
+		if(g_currentScreen != SCREEN_CLEAR_LOG || g_frameRx.frame.length < 4){
+			break;
+		}
+		data = g_frameRx.frame.payload;
+		erased = ((uint16)data[0] << 8) | data[1];
+		pages = ((uint16)data[2] << 8) | data[3];
+		HMI_showClear(CLEAR_STARTED, erased, pages);
+		break;
+
+	case FRAME_RULE:
+		if(g_currentScreen == SCREEN_RULES && g_rule[0] == g_ruleIndex){
+			g_ruleLoaded = TRUE;
+			HMI_showRule();
+			HMI_showRuleField();
+		}
+		break;
+
+	case FRAME_RULE_SAVED:
+		if(g_currentScreen == SCREEN_RULES){
+			LCD_displayStringRowColumn_P(3, 0, (g_ruleStatus == RULE_SAVED) ? STR_RULE_SAVED : STR_RULE_REJECTED);
+		}
+		break;
+
+	case FRAME_DIDS:
+		if(g_currentScreen == SCREEN_STATUS){
+			HMI_showStatusDids();
+		}
+		else if(g_currentScreen == SCREEN_NODES){
+			if((data = HMI_findDid(FRAME_DID_TEMPERATURE)) != NULL_PTR){
+				HMI_displayNumber(g_nodePoll + 1, 3, data[0], 3);
+			}
+			if((data = HMI_findDid(FRAME_DID_DISTANCE)) != NULL_PTR){
+				HMI_displayNumber(g_nodePoll + 1, 7, ((uint16)data[0] << 8) | data[1], 4);
+			}
+			g_nodeReplies[g_nodePoll]++;
+			HMI_linkPollNext();
+		}
+		break;
+
+	case FRAME_FIND:
+		/* Recent faults: the viewer starts at the first one */
+		if(g_currentScreen == SCREEN_READING_FAULTS){
+			g_totalFaults = g_faultFirst;
+			HMI_linkSendCommand(DETECT_FAULTS);
+		}
+		break;
+
+	case FRAME_FAULTS:
+		if(g_currentScreen != SCREEN_READING_FAULTS &&
+		   (g_currentScreen != SCREEN_FAULT_LIST || g_faultRow != 0)){
+			break;  /* Viewer closed */
+		}
+
+		if(g_faultCount == 0){
+			HMI_showScreen((g_totalFaults == g_faultFirst) ? SCREEN_NO_FAULTS : SCREEN_END_LIST);
+			break;
+		}
+
+		if(g_currentScreen == SCREEN_READING_FAULTS){
+			HMI_showScreen(SCREEN_FAULT_LIST);
+		}
+		for(i = 0; i < g_faultCount; i++){
+			HMI_showFault(g_faultCodes[i]);
+		}
+
+		/* Last page: keep the codes visible, the menu key leaves the list.
+		 * Otherwise the next page is only asked for when the user presses a key. */
+		if(g_faultFlags & FAULTS_MORE){
+			LCD_displayStringRowColumn_P(3, 0, STR_PRESS_ANY_KEY);
+			g_faultMore = TRUE;
+		}
+		else{
+			LCD_displayStringRowColumn_P(3, 0, STR_END_LIST);
+		}
+		break;
+
+	case FRAME_TELEMETRY:
+		if(g_currentScreen != SCREEN_DASHBOARD){
+			HMI_linkSubscribe(0);  /* Late frame or lost unsubscribe */
+			break;
+		}
+
+		HMI_dashboardReceive(&g_frameRx.frame);
+
+		/* Half of the credit used (or none granted since the subscription): grant
+		 * more, the frame left the receive buffer */
+		if((uint8)(g_dashCredit - g_dashLastSeq) <= DASH_CREDIT_WINDOW / 2 ||
+		   (uint8)(g_dashCredit - g_dashLastSeq) > DASH_CREDIT_WINDOW){
+			HMI_linkGrantCredit();
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+/*
+ * Function: HMI_handleTimer
+ * --------------------------
+ * Timer event: screen hold times, the stop countdown and request deadlines.
+ */
+static void HMI_handleTimer(HMI_TimerID timer)
+{
+	boolean failed;
+
+	if(timer == TIMER_LINK && g_linkState == LINK_TRAINING){
+		if(g_trainingSyncs < TRAINING_MAX_SYNCS){
+			g_trainingSyncs++;
+			UART_sendByte(SYNC_BYTE);
+			SWTIMER_start(TIMER_LINK, TRAINING_SYNC_PERIOD_MS);
+		}
+		else{
+			HMI_linkTrainingEnd();  /* No answer: keep the configured rate */
+		}
+		return;
+	}
+
+	if(timer == TIMER_LINK){
+		/* Control Unit did not answer a request: the screen waiting for it shows the error,
+		 * the nodes screen goes on with the next node */
+		failed = HMI_linkTimeout();
+		if(failed && g_currentScreen == SCREEN_NODES){
+			HMI_linkPollNext();
+		}
+		else if(failed &&
+		        (g_currentScreen == SCREEN_DISPLAY_VALUES ||
+		         g_currentScreen == SCREEN_READING_FAULTS ||
+		         g_currentScreen == SCREEN_FAULT_LIST ||
+		         g_currentScreen == SCREEN_STATUS ||
+		         g_currentScreen == SCREEN_WEAR ||
+		         g_currentScreen == SCREEN_CLEAR_LOG ||
+		         g_currentScreen == SCREEN_RULES)){
+			HMI_showScreen(SCREEN_LINK_ERROR);
+		}
+		return;
+	}
+
+	if(timer == TIMER_BAUD){
+		HMI_baudTick();
+		return;
+	}
+
+	if(timer == TIMER_DASH){
+		if(g_dashHaveState){
+			HMI_dashboardUpdate(g_dashState);
+		}
+		HMI_linkGrantCredit();  /* Also recovers from a lost grant */
+		if(++g_dashTicks < DASH_STATS_TICKS){
+			return;
+		}
+		g_dashTicks = 0;
+
+		/* Frame rate reached in the last window and lost frames so far */
+		HMI_displayNumber(2, 12, g_dashFrames, 3);
+		HMI_displayNumber(3, 5, g_dashLost, 5);
+
+		/* Nothing received: the subscription was lost, send it again */
+		if(g_dashFrames == 0){
+			HMI_linkSubscribe(pgm_read_byte(&g_dashRates[g_dashRateIndex]));
+		}
+		g_dashFrames = 0;
+		return;
+	}
+
+	switch(g_currentScreen){
+	case SCREEN_WELCOME:
+		HMI_showScreen(SCREEN_MAIN_MENU);
+		break;
+
+	case SCREEN_SYSTEM_STARTED:
+		HMI_showScreen(SCREEN_MENU_PROMPT);
+		break;
+
+	case SCREEN_SENSOR_VALUES:
+		HMI_showScreen(SCREEN_DISPLAY_DONE);
+		break;
+
+	case SCREEN_SYSTEM_STOPPED:
+		g_countdown--;
+		if(g_countdown == 0){
+			HMI_showScreen(SCREEN_MAIN_MENU);
+		}
+		else{
+			HMI_showCountdown();
+			SWTIMER_start(TIMER_SCREEN, COUNTDOWN_STEP_MS);
+		}
+		break;
+
+	case SCREEN_LINK_STATS:
+		HMI_showLinkStats();
+		break;
+
+	case SCREEN_CLEAR_LOG:
+		/* Erase running: read its state, the response ends it if the last progress frame was lost */
+		g_clearMode = CLEAR_STATUS;
+		HMI_linkSendCommand(CLEAR_DTC);
+		break;
+
+	case SCREEN_LOG_EXPORT:
+		HMI_showLog();  /* The LCD is refreshed at a slower pace than the frames */
+		if(g_logDone || ++g_logIdle < LOG_TIMEOUT_TICKS){
+			break;
+		}
+
+		/* The window, its end or the request was lost: ask for it again or give up */
+		if(g_logRetries < LOG_MAX_RETRIES){
+			g_logRetries++;
+			HMI_linkSendCommand(EXPORT_FAULTS);
+		}
+		else{
+			g_logFailed = TRUE;
+			g_logDone = TRUE;
+			HMI_showLog();
+		}
+		break;
+
+	case SCREEN_NODES:
+		HMI_showNodeRates();
+		if(g_linkOutstanding == 0){
+			HMI_linkPollNext();  /* The polling stopped (request dropped), start it again */
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+/*
+ * Function: HMI_handleEvent
+ * --------------------------
+ * Dispatches one event to the screen state machine.
+ */
+static void HMI_handleEvent(HMI_EventType event, uint8 value)
+{
+	switch(event){
+	case EVENT_KEY:
+		HMI_handleKey(value);
+		break;
+
+	case EVENT_FRAME:
+		HMI_handleFrame((HMI_FrameType)value);
+		break;
+
+	case EVENT_TIMER:
+		HMI_handleTimer((HMI_TimerID)value);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/*******************************************************************************
+ *                                 Main Function                               *
+ *******************************************************************************/
+int main(void){
+	uint8 keyValue;   // Variable to store keypad input
+
+	/* UART configuration structure */
+	UART_ConfigType UART_Config = {
+			.bit_data = LINK_MULTIDROP ? UART_9_BIT_DATA : UART_8_BIT_DATA,  /* 9th bit marks the node addresses */
+			.parity = UART_PARITY_DISABLED,
+			.stop_bit = UART_ONE_STOP_BIT,
+			.baud_rate = 9600
+	};
+
+	SREG |= (1<<7); /* Enable global interrupts */
+
+	/* Initialize peripherals */
+	LCD_init();
+	KEYPAD_init();
+	UART_init(&UART_Config);
+	SWTIMER_init();
+	FRAME_resetReceiver(&g_frameRx);
+
+	/* Link training, then the first tick after it starts the baud rate negotiation.
+	 * Point-to-point only, a shared line stays at the base rate. */
+	if(!LINK_MULTIDROP){
+		HMI_linkTrain();
+		SWTIMER_startPeriodic(TIMER_BAUD, BAUD_CHECK_PERIOD_MS);
+	}
+
+	/* Display startup message, the main menu follows on timeout */
+	HMI_showScreen(SCREEN_WELCOME);
+	SWTIMER_startPeriodic(TIMER_KEYPAD, KEYPAD_SAMPLE_PERIOD_MS);
+
+	/* === Event Loop === */
+	for(;;){
+		/* Keypad event (debounced press edge only), one sample per tick */
+		if(SWTIMER_expired(TIMER_KEYPAD)){
+			keyValue = KEYPAD_getNewKey();
+			if(keyValue != NO_PRESSED_KEY){
+				HMI_handleEvent(EVENT_KEY, keyValue);
+			}
+		}
+
+		/* UART bytes, frame events are raised by the receive state machine */
+		while(UART_dataAvailable()){
+			HMI_linkReceive(UART_recieveByte());
+		}
+		FRAME_checkTimeout(&g_frameRx);  /* Resync on the next SOF if a frame stopped midway */
+
+		/* Requests waiting for their node to be addressed, then the queued frames by channel priority */
+		if(LINK_MULTIDROP){
+			HMI_linkResume();
+		}
+		FRAME_service();
+
+		/* Timer events */
+		if(SWTIMER_expired(TIMER_LINK)){
+			HMI_handleEvent(EVENT_TIMER, TIMER_LINK);
+		}
+		if(SWTIMER_expired(TIMER_SCREEN)){
+			HMI_handleEvent(EVENT_TIMER, TIMER_SCREEN);
+		}
+		if(SWTIMER_expired(TIMER_DASH)){
+			HMI_handleEvent(EVENT_TIMER, TIMER_DASH);
+		}
+		if(SWTIMER_expired(TIMER_BAUD)){
+			HMI_handleEvent(EVENT_TIMER, TIMER_BAUD);
+		}
+	}
+}
@@ -0,0 +1,67 @@
+/******************************************************************************
+ *
+ * Module: MENU
+ *
+ * File Name: hmi_menu.c
+ *
+ * Description: Source file for the table-driven HMI menu engine
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include "hmi_menu.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Clear the LCD and draw all the lines of the given flash screen entry.
+ */
+void MENU_showScreen(const MENU_ScreenType *screen_P)
+{
+	uint8 row;
+	const char *line;
+
+	LCD_clearScreen();
+
+	for(row = 0; row < LCD_ROWS; row++)
+	{
+		/* The line pointers are stored in flash with the screen entry */
+		line = (const char *)pgm_read_word(&screen_P->line[row]);
+		if(line != NULL_PTR)
+		{
+			LCD_displayStringRowColumn_P(row, 0, line);
+		}
+	}
+}
+
+/*
+ * Description :
+ * Search the key bindings of the given flash screen entry for the pressed key.
+ * Copies the matching binding to RAM and returns TRUE, or returns FALSE if the
+ * key is not bound on this screen.
+ */
+boolean MENU_getBinding(const MENU_ScreenType *screen_P, uint8 key, MENU_KeyBindingType *binding)
+{
+	uint8 i;
+	const MENU_KeyBindingType *bindings;
+	uint8 count;
+
+	bindings = (const MENU_KeyBindingType *)pgm_read_word(&screen_P->bindings);
+	count = pgm_read_byte(&screen_P->bindingsCount);
+
+	for(i = 0; i < count; i++)
+	{
+		if(pgm_read_byte(&bindings[i].key) == key)
+		{
+			memcpy_P(binding, &bindings[i], sizeof(MENU_KeyBindingType));
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
@@ -0,0 +1,81 @@
+/******************************************************************************
+ *
+ * Module: MENU
+ *
+ * File Name: hmi_menu.h
+ *
+ * Description: Header file for the table-driven HMI menu engine.
+ *              Screens, labels and key bindings are kept in flash (PROGMEM)
+ *              so they do not take any SRAM at runtime.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef HMI_MENU_H_
+#define HMI_MENU_H_
+
+#include "std_types.h"
+#include "lcd.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Used in a key binding when the key only changes the screen (nothing sent over UART) */
+#define MENU_NO_COMMAND                   0xFF
+
+/* Commands with this bit set are actions handled by the HMI itself, never sent over UART */
+#define MENU_LOCAL_FLAG                   0x80
+
+/*******************************************************************************
+ *                                Data Types                                   *
+ *******************************************************************************/
+
+/*
+ * Key binding entry:
+ * - key     : keypad value that triggers the binding
+ * - command : command byte sent to the Control ECU (MENU_NO_COMMAND if none)
+ * - screen  : index of the screen shown after the key is accepted
+ */
+typedef struct
+{
+	uint8 key;
+	uint8 command;
+	uint8 screen;
+}MENU_KeyBindingType;
+
+/*
+ * Screen entry:
+ * - line          : one flash string per LCD row (NULL_PTR leaves the row empty)
+ * - bindings      : flash table of the keys accepted on this screen
+ * - bindingsCount : number of entries in the bindings table
+ *
+ * Note: The screen table itself must be declared with PROGMEM.
+ */
+typedef struct
+{
+	const char *line[LCD_ROWS];
+	const MENU_KeyBindingType *bindings;
+	uint8 bindingsCount;
+}MENU_ScreenType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Clear the LCD and draw all the lines of the given flash screen entry.
+ */
+void MENU_showScreen(const MENU_ScreenType *screen_P);
+
+/*
+ * Description :
+ * Search the key bindings of the given flash screen entry for the pressed key.
+ * Copies the matching binding to RAM and returns TRUE, or returns FALSE if the
+ * key is not bound on this screen.
+ */
+boolean MENU_getBinding(const MENU_ScreenType *screen_P, uint8 key, MENU_KeyBindingType *binding);
+
+#endif /* HMI_MENU_H_ */
@@ -0,0 +1,463 @@
+/******************************************************************************
+ *
+ * Module: FRAME
+ *
+ * File Name: frame.c
+ *
+ * Description: Source file for the UART framing layer shared by both ECUs
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include "frame.h"
+#include "crc8.h"
+#include "uart.h"
+#include "sw_timer.h"
+
+/*******************************************************************************
+ *                                Data Types                                   *
+ *******************************************************************************/
+
+/* Transmit queue of a channel */
+typedef struct
+{
+	FRAME_Type frames[FRAME_QUEUE_DEPTH];
+	uint8 head;
+	uint8 count;
+}FRAME_QueueType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Channels in priority order, g_queues uses the same order */
+static const uint8 g_channels[FRAME_CHANNELS_COUNT] = {
+	FRAME_CHANNEL_LINK,
+	FRAME_CHANNEL_COMMAND,
+	FRAME_CHANNEL_DIAG,
+	FRAME_CHANNEL_TELEMETRY,
+	FRAME_CHANNEL_BULK
+};
+
+static FRAME_QueueType g_queues[FRAME_CHANNELS_COUNT];
+
+/* Start of every delta field in the telemetry sample, bit n of the change mask
+ * flags the field from g_deltaFields[n] up to g_deltaFields[n + 1] */
+static const uint8 g_deltaFields[] = {
+	FRAME_TELEMETRY_DISTANCE,
+	FRAME_TELEMETRY_TEMP,
+	FRAME_TELEMETRY_WIN1,
+	FRAME_TELEMETRY_WIN2,
+	FRAME_TELEMETRY_LENGTH
+};
+
+#define FRAME_DELTA_FIELDS      (sizeof(g_deltaFields) - 1)
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Send a byte after the SOF, escaped if it is FRAME_SOF or FRAME_ESCAPE.
+ */
+static void FRAME_sendStuffed(uint8 data)
+{
+	if(data == FRAME_SOF || data == FRAME_ESCAPE)
+	{
+		UART_sendByte(FRAME_ESCAPE);
+		data ^= FRAME_ESCAPE_XOR;
+	}
+	UART_sendByte(data);
+}
+
+/*
+ * Description :
+ * Returns the CRC of a frame: TYPE, SEQ, LENGTH and the payload.
+ */
+static uint8 FRAME_crc(uint8 type, uint8 seq, const uint8 *payload, uint8 length)
+{
+	uint8 header[3];
+
+	header[0] = type;
+	header[1] = seq;
+	header[2] = length;
+	return CRC8_update(CRC8_update(CRC8_INIT, header, 3), payload, length);
+}
+
+/*
+ * Description :
+ * Returns the queue of a channel, the bulk one for an unknown channel.
+ */
+static FRAME_QueueType *FRAME_getQueue(uint8 channel)
+{
+	uint8 i;
+
+	for(i = 0; i < FRAME_CHANNELS_COUNT - 1; i++)
+	{
+		if(g_channels[i] == channel)
+		{
+			break;
+		}
+	}
+
+	return &g_queues[i];
+}
+
+/*
+ * Description :
+ * Returns the number of bytes a frame takes on the line, stuffing included.
+ */
+static uint8 FRAME_stuffedSize(const FRAME_Type *frame)
+{
+	uint8 crc = FRAME_crc(frame->type, frame->seq, frame->payload, frame->length);
+	uint8 size = FRAME_OVERHEAD + frame->length;
+	uint8 i;
+
+	size += (frame->type == FRAME_SOF || frame->type == FRAME_ESCAPE);
+	size += (frame->seq == FRAME_SOF || frame->seq == FRAME_ESCAPE);
+	size += (crc == FRAME_SOF || crc == FRAME_ESCAPE);
+	for(i = 0; i < frame->length; i++)
+	{
+		size += (frame->payload[i] == FRAME_SOF || frame->payload[i] == FRAME_ESCAPE);
+	}
+	return size;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Build a frame around the payload and send it through the UART.
+ */
+void FRAME_send(uint8 type, uint8 seq, const uint8 *payload, uint8 length)
+{
+	uint8 i;
+
+	UART_sendByte(FRAME_SOF);
+	FRAME_sendStuffed(type);
+	FRAME_sendStuffed(seq);
+	FRAME_sendStuffed(length);
+
+	for(i = 0; i < length; i++)
+	{
+		FRAME_sendStuffed(payload[i]);
+	}
+
+	FRAME_sendStuffed(FRAME_crc(type, seq, payload, length));
+}
+
+/*
+ * Description :
+ * Queue a frame on the channel of its type and send what the UART can take.
+ * Returns FALSE if the queue of the channel is full (the frame is dropped).
+ */
+boolean FRAME_queue(uint8 type, uint8 seq, const uint8 *payload, uint8 length)
+{
+	FRAME_QueueType *queue = FRAME_getQueue(FRAME_CHANNEL(type));
+	FRAME_Type *frame;
+	uint8 i;
+
+	if(length > FRAME_MAX_PAYLOAD || queue->count == FRAME_QUEUE_DEPTH)
+	{
+		return FALSE;
+	}
+
+	frame = &queue->frames[(queue->head + queue->count) % FRAME_QUEUE_DEPTH];
+	frame->type = type;
+	frame->seq = seq;
+	frame->length = length;
+	for(i = 0; i < length; i++)
+	{
+		frame->payload[i] = payload[i];
+	}
+	queue->count++;
+
+	FRAME_service();
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Returns the number of frames that can still be queued on a channel.
+ */
+uint8 FRAME_queueSpace(uint8 channel)
+{
+	return FRAME_QUEUE_DEPTH - FRAME_getQueue(channel)->count;
+}
+
+/*
+ * Description :
+ * Returns TRUE when no frame is waiting in any channel queue.
+ */
+boolean FRAME_queuesEmpty(void)
+{
+	uint8 i;
+
+	for(i = 0; i < FRAME_CHANNELS_COUNT; i++)
+	{
+		if(g_queues[i].count != 0)
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Move queued frames to the UART, highest priority channel first. Must be
+ * called from the main loop.
+ * A frame is only moved while less than one frame is left in the UART transmit
+ * buffer: the line stays busy, and a higher priority frame queued later only
+ * waits for the bytes already there. Link frames only need room, they must be
+ * on their way before a baud rate switch drains the buffer.
+ * A node of a multi-drop line keeps its frames queued while it is not selected.
+ */
+void FRAME_service(void)
+{
+	FRAME_QueueType *queue;
+	FRAME_Type *frame;
+	uint8 pending;
+	uint8 i;
+
+	if(!UART_isSelected())
+	{
+		return;
+	}
+
+	for(i = 0; i < FRAME_CHANNELS_COUNT; i++)
+	{
+		queue = &g_queues[i];
+		while(queue->count != 0)
+		{
+			frame = &queue->frames[queue->head];
+			pending = (UART_TX_BUFFER_SIZE - 1) - UART_txSpace();
+			if(UART_txSpace() < FRAME_stuffedSize(frame) ||
+			   (g_channels[i] != FRAME_CHANNEL_LINK && pending >= FRAME_MAX_SIZE))
+			{
+				return;  /* Lower priority channels wait too */
+			}
+
+			FRAME_send(frame->type, frame->seq, frame->payload, frame->length);
+			queue->head = (queue->head + 1) % FRAME_QUEUE_DEPTH;
+			queue->count--;
+		}
+	}
+}
+
+/*
+ * Description :
+ * Drop any partly received frame and wait for the next SOF.
+ */
+void FRAME_resetReceiver(FRAME_ReceiverType *rx)
+{
+	rx->state = FRAME_WAIT_SOF;
+	rx->index = 0;
+	rx->crc = CRC8_INIT;
+	rx->escaped = FALSE;
+}
+
+/*
+ * Description :
+ * Returns TRUE while the receiver is in the middle of a frame.
+ */
+boolean FRAME_isReceiving(const FRAME_ReceiverType *rx)
+{
+	return (rx->state != FRAME_WAIT_SOF);
+}
+
+/*
+ * Description :
+ * Feed one received byte to the receiver.
+ * Returns TRUE when a complete frame with a valid CRC is in rx->frame.
+ */
+boolean FRAME_receiveByte(FRAME_ReceiverType *rx, uint8 data)
+{
+	/* A SOF is never stuffed: it always starts a frame, the frame it cuts is dropped */
+	if(data == FRAME_SOF)
+	{
+		if(rx->state != FRAME_WAIT_SOF)
+		{
+			rx->dropped++;
+		}
+		FRAME_resetReceiver(rx);
+		rx->last_ms = SWTIMER_getTime();
+		rx->state = FRAME_WAIT_TYPE;
+		return FALSE;
+	}
+
+	if(rx->state == FRAME_WAIT_SOF)
+	{
+		return FALSE;  /* Not in a frame */
+	}
+	rx->last_ms = SWTIMER_getTime();
+
+	/* Unstuff */
+	if(data == FRAME_ESCAPE)
+	{
+		if(rx->escaped)
+		{
+			FRAME_resetReceiver(rx);  /* Two escapes in a row */
+			rx->dropped++;
+			return FALSE;
+		}
+		rx->escaped = TRUE;
+		return FALSE;
+	}
+	if(rx->escaped)
+	{
+		data ^= FRAME_ESCAPE_XOR;
+		rx->escaped = FALSE;
+	}
+
+	switch(rx->state)
+	{
+	case FRAME_WAIT_TYPE:
+		rx->frame.type = data;
+		rx->crc = CRC8_update(rx->crc, &data, 1);
+		rx->state = FRAME_WAIT_SEQ;
+		break;
+
+	case FRAME_WAIT_SEQ:
+		rx->frame.seq = data;
+		rx->crc = CRC8_update(rx->crc, &data, 1);
+		rx->state = FRAME_WAIT_LENGTH;
+		break;
+
+	case FRAME_WAIT_LENGTH:
+		if(data > FRAME_MAX_PAYLOAD)
+		{
+			FRAME_resetReceiver(rx);  /* Corrupted length */
+			rx->dropped++;
+			break;
+		}
+		rx->frame.length = data;
+		rx->crc = CRC8_update(rx->crc, &data, 1);
+		rx->index = 0;
+		rx->state = (data == 0) ? FRAME_WAIT_CRC : FRAME_WAIT_PAYLOAD;
+		break;
+
+	case FRAME_WAIT_PAYLOAD:
+		rx->frame.payload[rx->index++] = data;
+		rx->crc = CRC8_update(rx->crc, &data, 1);
+		if(rx->index == rx->frame.length)
+		{
+			rx->state = FRAME_WAIT_CRC;
+		}
+		break;
+
+	case FRAME_WAIT_CRC:
+		rx->state = FRAME_WAIT_SOF;
+		if(data != rx->crc)
+		{
+			rx->dropped++;
+			return FALSE;
+		}
+		return TRUE;
+
+	default:
+		FRAME_resetReceiver(rx);
+		break;
+	}
+
+	return FALSE;
+}
+
+/*
+ * Description :
+ * Drops a partly received frame when no byte came for FRAME_RX_TIMEOUT_MS.
+ * Must be called when all the received bytes were fed, a stalled main loop
+ * does not make a frame time out.
+ */
+void FRAME_checkTimeout(FRAME_ReceiverType *rx)
+{
+	if(rx->state != FRAME_WAIT_SOF && SWTIMER_getTime() - rx->last_ms > FRAME_RX_TIMEOUT_MS)
+	{
+		FRAME_resetReceiver(rx);
+		rx->dropped++;
+	}
+}
+
+/*
+ * Description :
+ * Build a delta telemetry payload holding the fields of sample that differ from reference.
+ * Returns the payload length (at least 1, the change mask).
+ */
+uint8 FRAME_encodeDelta(const uint8 *sample, const uint8 *reference, uint8 *payload)
+{
+	uint8 field, i;
+	uint8 mask = 0;
+	uint8 length = 1;
+
+	for(field = 0; field < FRAME_DELTA_FIELDS; field++)
+	{
+		for(i = g_deltaFields[field]; i < g_deltaFields[field + 1]; i++)
+		{
+			if(sample[i] != reference[i])
+			{
+				break;
+			}
+		}
+		if(i == g_deltaFields[field + 1])
+		{
+			continue;  /* Field unchanged */
+		}
+
+		mask |= (1 << field);
+		for(i = g_deltaFields[field]; i < g_deltaFields[field + 1]; i++)
+		{
+			payload[length++] = sample[i];
+		}
+	}
+
+	payload[0] = mask;
+	return length;
+}
+
+/*
+ * Description :
+ * Apply a delta telemetry payload on a full telemetry sample.
+ * Returns FALSE if the payload length does not match its change mask.
+ */
+boolean FRAME_applyDelta(uint8 *sample, const uint8 *payload, uint8 length)
+{
+	uint8 field, i;
+	uint8 index = 1;
+
+	if(length == 0)
+	{
+		return FALSE;
+	}
+
+	/* Check the length first so a bad frame leaves the sample untouched */
+	for(field = 0; field < FRAME_DELTA_FIELDS; field++)
+	{
+		if(payload[0] & (1 << field))
+		{
+			index += g_deltaFields[field + 1] - g_deltaFields[field];
+		}
+	}
+	if(index != length)
+	{
+		return FALSE;
+	}
+
+	index = 1;
+	for(field = 0; field < FRAME_DELTA_FIELDS; field++)
+	{
+		if(payload[0] & (1 << field))
+		{
+			for(i = g_deltaFields[field]; i < g_deltaFields[field + 1]; i++)
+			{
+				sample[i] = payload[index++];
+			}
+		}
+	}
+
+	return TRUE;
+}
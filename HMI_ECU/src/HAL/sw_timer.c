@@ -0,0 +1,204 @@
+/******************************************************************************
+ *
+ * Module: SWTIMER
+ *
+ * File Name: sw_timer.c
+ *
+ * Description: Source file for the software timers driver
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include "sw_timer.h"
+#include "timer.h"
+#include <avr/io.h>
+#include <util/atomic.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Remaining ticks of every software timer (0 = stopped) */
+static volatile uint16 g_remainingTicks[SWTIMER_MAX_TIMERS];
+
+/* Reload value of every periodic timer (0 = one-shot) */
+static volatile uint16 g_reloadTicks[SWTIMER_MAX_TIMERS];
+
+/* Bit n is set by the tick when timer n elapses */
+static volatile uint8 g_expiredFlags = 0;
+
+/* Free-running time since init in ms */
+static volatile uint32 g_time_ms = 0;
+
+/* Tick configuration: CTC mode, one compare match every SWTIMER_TICK_MS */
+static const Timer_ConfigType g_tickConfig = {
+	.timer_ID = SWTIMER_HW_TIMER_ID,
+	.timer_mode = TIMER_COMP,
+	.timer_clock = (Timer_ClockType)SWTIMER_HW_CLOCK,  /* Timer2 has its own prescaler codes */
+	.timer_compare_MatchValue = SWTIMER_COMPARE_VALUE
+};
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Timer call back, runs every SWTIMER_TICK_MS in interrupt context.
+ */
+static void SWTIMER_tick(void)
+{
+	uint8 i;
+
+	g_time_ms += SWTIMER_TICK_MS;
+
+	for(i = 0; i < SWTIMER_MAX_TIMERS; i++)
+	{
+		if(g_remainingTicks[i] != 0)
+		{
+			g_remainingTicks[i]--;
+			if(g_remainingTicks[i] == 0)
+			{
+				g_expiredFlags |= (1 << i);
+				g_remainingTicks[i] = g_reloadTicks[i];
+			}
+		}
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start the hardware timer tick. All software timers are stopped.
+ */
+void SWTIMER_init(void)
+{
+	uint8 i;
+
+	for(i = 0; i < SWTIMER_MAX_TIMERS; i++)
+	{
+		g_remainingTicks[i] = 0;
+		g_reloadTicks[i] = 0;
+	}
+	g_expiredFlags = 0;
+	g_time_ms = 0;
+
+	TIMER_setCallBack(SWTIMER_tick, SWTIMER_HW_TIMER_ID);
+	TIMER_init(&g_tickConfig);
+}
+
+/*
+ * Description :
+ * (Re)start a one-shot software timer. The time is rounded up to the tick period.
+ */
+void SWTIMER_start(uint8 timer_id, uint16 time_ms)
+{
+	uint16 ticks = (time_ms + SWTIMER_TICK_MS - 1) / SWTIMER_TICK_MS;
+
+	if(timer_id >= SWTIMER_MAX_TIMERS)
+	{
+		return;
+	}
+	if(ticks == 0)
+	{
+		ticks = 1;
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_remainingTicks[timer_id] = ticks;
+		g_reloadTicks[timer_id] = 0;
+		g_expiredFlags &= ~(1 << timer_id);
+	}
+}
+
+/*
+ * Description :
+ * (Re)start a periodic software timer. It is reloaded by the tick itself, so the
+ * expiries stay on a fixed schedule whatever the time taken to handle them.
+ * Expiries not consumed before the next one are merged.
+ */
+void SWTIMER_startPeriodic(uint8 timer_id, uint16 period_ms)
+{
+	uint16 ticks = (period_ms + SWTIMER_TICK_MS - 1) / SWTIMER_TICK_MS;
+
+	if(timer_id >= SWTIMER_MAX_TIMERS)
+	{
+		return;
+	}
+	if(ticks == 0)
+	{
+		ticks = 1;
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_remainingTicks[timer_id] = ticks;
+		g_reloadTicks[timer_id] = ticks;
+		g_expiredFlags &= ~(1 << timer_id);
+	}
+}
+
+/*
+ * Description :
+ * Stop a software timer and discard a pending expiry.
+ */
+void SWTIMER_stop(uint8 timer_id)
+{
+	if(timer_id >= SWTIMER_MAX_TIMERS)
+	{
+		return;
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_remainingTicks[timer_id] = 0;
+		g_reloadTicks[timer_id] = 0;
+		g_expiredFlags &= ~(1 << timer_id);
+	}
+}
+
+/*
+ * Description :
+ * Returns TRUE once after the timer elapsed (the expiry is consumed), FALSE otherwise.
+ */
+boolean SWTIMER_expired(uint8 timer_id)
+{
+	boolean expired = FALSE;
+
+	if(timer_id >= SWTIMER_MAX_TIMERS)
+	{
+		return FALSE;
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if(g_expiredFlags & (1 << timer_id))
+		{
+			g_expiredFlags &= ~(1 << timer_id);
+			expired = TRUE;
+		}
+	}
+
+	return expired;
+}
+
+/*
+ * Description :
+ * Returns the time in ms since SWTIMER_init() (resolution SWTIMER_TICK_MS).
+ */
+uint32 SWTIMER_getTime(void)
+{
+	uint32 time;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		time = g_time_ms;
+	}
+
+	return time;
+}
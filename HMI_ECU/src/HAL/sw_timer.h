@@ -0,0 +1,77 @@
+/******************************************************************************
+ *
+ * Module: SWTIMER
+ *
+ * File Name: sw_timer.h
+ *
+ * Description: Header file for the software timers driver.
+ *              One hardware timer generates a periodic tick and up to
+ *              SWTIMER_MAX_TIMERS one-shot or periodic software timers count down on it.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef SW_TIMER_H_
+#define SW_TIMER_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Hardware timer used to generate the tick */
+#define SWTIMER_HW_TIMER_ID               TIMER1_ID
+#define SWTIMER_HW_CLOCK                  TIMER_PRESCALER_64
+
+/* Tick period in ms (Timer1, prescaler 64, compare 124 @ 8 MHz), fine enough to time the link round trips */
+#define SWTIMER_TICK_MS                   1
+#define SWTIMER_COMPARE_VALUE             124
+
+/* Number of software timers available to the application */
+#define SWTIMER_MAX_TIMERS                5
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start the hardware timer tick. All software timers are stopped.
+ */
+void SWTIMER_init(void);
+
+/*
+ * Description :
+ * (Re)start a one-shot software timer. The time is rounded up to the tick period.
+ */
+void SWTIMER_start(uint8 timer_id, uint16 time_ms);
+
+/*
+ * Description :
+ * (Re)start a periodic software timer. It is reloaded by the tick itself, so the
+ * expiries stay on a fixed schedule whatever the time taken to handle them.
+ * Expiries not consumed before the next one are merged.
+ */
+void SWTIMER_startPeriodic(uint8 timer_id, uint16 period_ms);
+
+/*
+ * Description :
+ * Stop a software timer and discard a pending expiry.
+ */
+void SWTIMER_stop(uint8 timer_id);
+
+/*
+ * Description :
+ * Returns TRUE once after the timer elapsed (the expiry is consumed), FALSE otherwise.
+ */
+boolean SWTIMER_expired(uint8 timer_id);
+
+/*
+ * Description :
+ * Returns the time in ms since SWTIMER_init() (resolution SWTIMER_TICK_MS).
+ */
+uint32 SWTIMER_getTime(void);
+
+#endif /* SW_TIMER_H_ */
@@ -1,142 +1,396 @@
-/******************************************************************************
- *
- * Module: UART
- *
- * File Name: uart.c
- *
- * Description: Source file for the UART AVR driver (Polling-based)
- *
- * Author: Kerolous Labib
- *
- *******************************************************************************/
-
-#include "uart.h"
-#include "avr/io.h"       /* UART Registers */
-#include "common_macros.h" /* Bit manipulation macros */
-
-
-/*******************************************************************************
- *                      Functions Definitions                                  *
- *******************************************************************************/
-
-/*
- * Description :
- * Initialize UART:
- * - Configure frame format (data bits, parity, stop bits)
- * - Enable TX & RX
- * - Configure baud rate (double speed mode)
- */
-void UART_init(const UART_ConfigType * Config_Ptr)
-{
-	uint16 ubrr_value = 0;
-
-	/* Enable double transmission speed */
-	UCSRA = (1 << U2X);
-
-	/************************** UCSRB Description **************************
-	 * RXCIE = 0 Disable RX Complete Interrupt
-	 * TXCIE = 0 Disable TX Complete Interrupt
-	 * UDRIE = 0 Disable UDR Empty Interrupt
-	 * RXEN  = 1 Receiver Enable
-	 * TXEN  = 1 Transmitter Enable
-	 * UCSZ2 = Configured for 9-bit mode only
-	 ***********************************************************************/
-	UCSRB = (1 << RXEN) | (1 << TXEN);
-	if(Config_Ptr->bit_data == UART_9_BIT_DATA)
-		SET_BIT(UCSRB, UCSZ2);
-	else
-		CLEAR_BIT(UCSRB, UCSZ2);
-
-	/************************** UCSRC Description **************************
-	 * URSEL   = 1 (Write to UCSRC)
-	 * UMSEL   = 0 Asynchronous Operation
-	 * UPM1:0  = Parity mode
-	 * USBS    = Stop bits
-	 * UCSZ1:0 = Data bits
-	 * UCPOL   = 0 (Used only for synchronous mode)
-	 ***********************************************************************/
-	UCSRC = (1 << URSEL)
-			| ((Config_Ptr->parity) << UPM0)
-			| ((Config_Ptr->stop_bit) << USBS)
-			| (GET_BIT(Config_Ptr->bit_data, 0) << UCSZ0)
-			| (GET_BIT(Config_Ptr->bit_data, 1) << UCSZ1);
-
-	/* Calculate UBRR value for baud rate (with double speed) */
-	ubrr_value = (uint16)(((F_CPU / (Config_Ptr->baud_rate * 8UL))) - 1);
-
-	/* Set baud rate registers */
-	UBRRH = ubrr_value >> 8;
-	UBRRL = ubrr_value;
-}
-
-/*
- * Description :
- * Send one byte through UART (polling-based).
- */
-void UART_sendByte(const uint8 data)
-{
-	/* Wait until UDR register is empty (UDRE = 1) */
-	while(BIT_IS_CLEAR(UCSRA, UDRE)) {}
-
-	/* Put data in the transmit buffer */
-	UDR = data;
-}
-
-/*
- * Description :
- * Receive one byte through UART (polling-based).
- */
-uint8 UART_recieveByte(void)
-{
-	/* Wait until data is received (RXC = 1) */
-	while(BIT_IS_CLEAR(UCSRA, RXC)) {}
-
-	/* Return received data from buffer */
-	return UDR;
-}
-
-/*
- * Description :
- * Send a null-terminated string through UART.
- */
-void UART_sendString(const uint8 *Str)
-{
-	uint8 i = 0;
-	while(Str[i] != '\0')
-	{
-		UART_sendByte(Str[i]);
-		i++;
-	}
-}
-
-/*
- * Description :
- * Receive a string until '#' symbol, then replace it with '\0'.
- */
-void UART_receiveString(uint8 *Str)
-{
-	uint8 i = 0;
-
-	/* Receive first byte */
-	Str[i] = UART_recieveByte();
-
-	/* Keep receiving until '#' */
-	while(Str[i] != '#')
-	{
-		i++;
-		Str[i] = UART_recieveByte();
-	}
-
-	/* Replace '#' with string terminator */
-	Str[i] = '\0';
-}
-
-/*
- * Description :
- * Check if new data is available (non-blocking polling).
- * Returns 1 if RXC = 1 (data received), else 0.
- */
-uint8 UART_dataAvailable(void)
-{
-	return BIT_IS_SET(UCSRA, RXC);
-}
+/******************************************************************************
+ *
+ * Module: UART
+ *
+ * File Name: uart.c
+ *
+ * Description: Source file for the UART AVR driver
+ *              (Interrupt-driven transmit and receive buffers)
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include "uart.h"
+#include "avr/io.h"       /* UART Registers */
+#include "common_macros.h" /* Bit manipulation macros */
+#include <avr/interrupt.h> /* For UART RX and UDR empty ISRs */
+#include <util/atomic.h>   /* For reading the counters */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Receive ring buffer: the ISR writes at head, the application reads at tail */
+static volatile uint8 g_rxBuffer[UART_RX_BUFFER_SIZE];
+static volatile uint8 g_rxHead = 0;
+static volatile uint8 g_rxTail = 0;
+
+/* Transmit ring buffer: the application writes at head, the ISR sends from tail */
+static volatile uint8 g_txBuffer[UART_TX_BUFFER_SIZE];
+static volatile uint8 g_txHead = 0;
+static volatile uint8 g_txTail = 0;
+
+/* Bit n set: the byte at g_txBuffer[n] is an address byte (9th bit set) */
+static volatile uint8 g_txAddressFlags[UART_TX_BUFFER_SIZE / 8];
+
+/* Multi-drop node address (UART_NO_ADDRESS = not a node) and selection state */
+static volatile uint8 g_address = UART_NO_ADDRESS;
+static volatile boolean g_selected = TRUE;
+
+/* Set once a byte was written to UDR, TXC is only meaningful after that */
+static volatile boolean g_txStarted = FALSE;
+
+/* Line quality counters */
+static volatile UART_ErrorCountersType g_errors;
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Multi-drop: the transmitter only drives TXD while the node is selected. With
+ * TXEN cleared the pin is released (an input without pull-up) once the byte
+ * being sent is out, and the bytes still queued wait for the next selection.
+ * Called with the interrupts off.
+ */
+static void UART_driveLine(void)
+{
+	if(g_selected)
+	{
+		SET_BIT(UCSRB, TXEN);
+		if(g_txHead != g_txTail)
+		{
+			SET_BIT(UCSRB, UDRIE);
+		}
+	}
+	else
+	{
+		CLEAR_BIT(UCSRB, UDRIE);
+		CLEAR_BIT(UCSRB, TXEN);
+	}
+}
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(USART_RXC_vect)
+{
+	uint8 status = UCSRA;  /* Error flags are only valid before UDR is read */
+	uint8 ninth = UCSRB;   /* RXB8 too */
+	uint8 data = UDR;      /* Reading UDR clears the RXC flag */
+	uint8 next = (g_rxHead + 1) & (UART_RX_BUFFER_SIZE - 1);
+
+	g_errors.received++;
+	if(BIT_IS_SET(status, DOR))
+	{
+		g_errors.data_overruns++;
+	}
+	if(BIT_IS_SET(status, FE))
+	{
+		g_errors.frame_errors++;
+		return;
+	}
+	if(BIT_IS_SET(status, PE))
+	{
+		g_errors.parity_errors++;
+		return;
+	}
+
+	/* Address byte on a multi-drop line: receive the next data bytes only if it is ours */
+	if(g_address != UART_NO_ADDRESS && BIT_IS_SET(ninth, RXB8))
+	{
+		g_selected = (data == g_address);
+		UCSRA = (UCSRA & (1 << U2X)) | (g_selected ? 0 : (1 << MPCM));
+		UART_driveLine();
+		return;
+	}
+
+	/* Drop the byte if the buffer is full, the protocol above recovers it */
+	if(next != g_rxTail)
+	{
+		g_rxBuffer[g_rxHead] = data;
+		g_rxHead = next;
+	}
+	else
+	{
+		g_errors.buffer_full++;
+	}
+}
+
+ISR(USART_UDRE_vect)
+{
+	if(g_txHead == g_txTail || !g_selected)
+	{
+		/* Nothing left to send (or the line belongs to another node), stop the
+		 * interrupt until the next byte is queued or the node is selected */
+		CLEAR_BIT(UCSRB, UDRIE);
+		return;
+	}
+
+	/* Clear TXC (write 1) so it tells when this byte has been shifted out */
+	UCSRA = (UCSRA & ((1 << U2X) | (1 << MPCM))) | (1 << TXC);
+
+	/* 9th bit first, it is sent with the byte written to UDR */
+	if(BIT_IS_SET(g_txAddressFlags[g_txTail / 8], g_txTail % 8))
+	{
+		SET_BIT(UCSRB, TXB8);
+	}
+	else
+	{
+		CLEAR_BIT(UCSRB, TXB8);
+	}
+	UDR = g_txBuffer[g_txTail];
+	g_txTail = (g_txTail + 1) & (UART_TX_BUFFER_SIZE - 1);
+	g_txStarted = TRUE;
+}
+
+/*
+ * Description :
+ * Queue one byte, marked as an address byte or not. Only waits while the
+ * transmit buffer is full.
+ */
+static void UART_queueByte(uint8 data, boolean address)
+{
+	uint8 next = (g_txHead + 1) & (UART_TX_BUFFER_SIZE - 1);
+
+	/* Wait until the ISR made room in the buffer */
+	while(next == g_txTail) {}
+
+	g_txBuffer[g_txHead] = data;
+	if(address)
+	{
+		SET_BIT(g_txAddressFlags[g_txHead / 8], g_txHead % 8);
+	}
+	else
+	{
+		CLEAR_BIT(g_txAddressFlags[g_txHead / 8], g_txHead % 8);
+	}
+	g_txHead = next;
+
+	/* (Re)start the transmission, a node that is not selected sends it once it is */
+	if(g_selected)
+	{
+		SET_BIT(UCSRB, UDRIE);
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Initialize UART:
+ * - Configure frame format (data bits, parity, stop bits)
+ * - Enable TX & RX
+ * - Configure baud rate (double speed mode)
+ */
+void UART_init(const UART_ConfigType * Config_Ptr)
+{
+	uint16 ubrr_value = 0;
+
+	/* Enable double transmission speed */
+	UCSRA = (1 << U2X);
+
+	/************************** UCSRB Description **************************
+	 * RXCIE = 1 Enable RX Complete Interrupt (fills the receive buffer)
+	 * TXCIE = 0 Disable TX Complete Interrupt
+	 * UDRIE = 0 UDR Empty Interrupt, enabled while the transmit buffer holds data
+	 * RXEN  = 1 Receiver Enable
+	 * TXEN  = 1 Transmitter Enable
+	 * UCSZ2 = Configured for 9-bit mode only
+	 ***********************************************************************/
+	g_rxHead = 0;
+	g_rxTail = 0;
+	g_txHead = 0;
+	g_txTail = 0;
+	g_txStarted = FALSE;
+	UCSRB = (1 << RXCIE) | (1 << RXEN) | (1 << TXEN);
+	if(Config_Ptr->bit_data == UART_9_BIT_DATA)
+		SET_BIT(UCSRB, UCSZ2);
+	else
+		CLEAR_BIT(UCSRB, UCSZ2);
+
+	/************************** UCSRC Description **************************
+	 * URSEL   = 1 (Write to UCSRC)
+	 * UMSEL   = 0 Asynchronous Operation
+	 * UPM1:0  = Parity mode
+	 * USBS    = Stop bits
+	 * UCSZ1:0 = Data bits
+	 * UCPOL   = 0 (Used only for synchronous mode)
+	 ***********************************************************************/
+	UCSRC = (1 << URSEL)
+			| ((Config_Ptr->parity) << UPM0)
+			| ((Config_Ptr->stop_bit) << USBS)
+			| (GET_BIT(Config_Ptr->bit_data, 0) << UCSZ0)
+			| (GET_BIT(Config_Ptr->bit_data, 1) << UCSZ1);
+
+	/* Calculate UBRR value for baud rate (with double speed), rounded to the nearest */
+	ubrr_value = (uint16)(((F_CPU + Config_Ptr->baud_rate * 4UL) / (Config_Ptr->baud_rate * 8UL)) - 1);
+
+	/* Set baud rate registers */
+	UBRRH = ubrr_value >> 8;
+	UBRRL = ubrr_value;
+}
+
+/*
+ * Description :
+ * Change the baud rate at runtime.
+ * Waits until every queued byte left the transmitter, then drops the received
+ * bytes still in the buffer (they may be half old, half new rate).
+ */
+void UART_setBaudRate(UART_BaudRateType baud_rate)
+{
+	uint16 ubrr_value = (uint16)(((F_CPU + baud_rate * 4UL) / (baud_rate * 8UL)) - 1);
+
+	/* Wait for the buffer, then for the last byte to leave the shift register */
+	while(g_txHead != g_txTail) {}
+	if(g_txStarted)
+	{
+		while(BIT_IS_CLEAR(UCSRA, TXC)) {}
+	}
+
+	UBRRH = ubrr_value >> 8;
+	UBRRL = ubrr_value;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_rxTail = g_rxHead;
+	}
+}
+
+/*
+ * Description :
+ * Copy the line quality counters.
+ */
+void UART_getErrorCounters(UART_ErrorCountersType *counters)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		*counters = g_errors;
+	}
+}
+
+/*
+ * Description :
+ * Queue one byte for transmission through UART.
+ * The UDR empty interrupt sends it, only waits while the buffer is full.
+ */
+void UART_sendByte(const uint8 data)
+{
+	UART_queueByte(data, FALSE);
+}
+
+/*
+ * Description :
+ * Set the address of this node on a multi-drop line (9-bit mode), the node is
+ * deselected (TXD released) until the master sends it. UART_NO_ADDRESS leaves
+ * the multi-drop mode, every byte is received again.
+ */
+void UART_setAddress(uint8 address)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_address = address;
+		g_selected = (address == UART_NO_ADDRESS);
+		UCSRA = (UCSRA & (1 << U2X)) | (g_selected ? 0 : (1 << MPCM));
+		UART_driveLine();
+	}
+}
+
+/*
+ * Description :
+ * Returns TRUE if the last address byte was the address of this node (always
+ * TRUE without an address). A node must only transmit while selected, the
+ * bytes it queues meanwhile wait in the transmit buffer.
+ */
+boolean UART_isSelected(void)
+{
+	return g_selected;
+}
+
+/*
+ * Description :
+ * Queue an address byte (9th bit set) selecting one node of a multi-drop line,
+ * the bytes queued after it go to that node.
+ */
+void UART_sendAddress(uint8 address)
+{
+	UART_queueByte(address, TRUE);
+}
+
+/*
+ * Description :
+ * Returns the number of bytes that can be queued without waiting.
+ */
+uint8 UART_txSpace(void)
+{
+	return (UART_TX_BUFFER_SIZE - 1) - ((g_txHead - g_txTail) & (UART_TX_BUFFER_SIZE - 1));
+}
+
+/*
+ * Description :
+ * Receive one byte through UART.
+ * Waits until the RX interrupt has put a byte in the receive buffer.
+ */
+uint8 UART_recieveByte(void)
+{
+	uint8 data;
+
+	/* Wait until data is received */
+	while(g_rxHead == g_rxTail) {}
+
+	/* Return the oldest byte from the buffer */
+	data = g_rxBuffer[g_rxTail];
+	g_rxTail = (g_rxTail + 1) & (UART_RX_BUFFER_SIZE - 1);
+	return data;
+}
+
+/*
+ * Description :
+ * Send a null-terminated string through UART.
+ */
+void UART_sendString(const uint8 *Str)
+{
+	uint8 i = 0;
+	while(Str[i] != '\0')
+	{
+		UART_sendByte(Str[i]);
+		i++;
+	}
+}
+
+/*
+ * Description :
+ * Receive a string until '#' symbol, then replace it with '\0'.
+ */
+void UART_receiveString(uint8 *Str)
+{
+	uint8 i = 0;
+
+	/* Receive first byte */
+	Str[i] = UART_recieveByte();
+
+	/* Keep receiving until '#' */
+	while(Str[i] != '#')
+	{
+		i++;
+		Str[i] = UART_recieveByte();
+	}
+
+	/* Replace '#' with string terminator */
+	Str[i] = '\0';
+}
+
+/*
+ * Description :
+ * Check if new data is available (non-blocking polling).
+ * Returns 1 if the receive buffer holds data, else 0.
+ */
+uint8 UART_dataAvailable(void)
+{
+	return (g_rxHead != g_rxTail);
+}
@@ -0,0 +1,102 @@
+/******************************************************************************
+ *
+ * Module: Host tools
+ *
+ * File Name: control_host.c
+ *
+ * Description: Virtual Control ECU. Runs the Control ECU application
+ * (Control_APP.c and the modules under it, unchanged) on the host, with its
+ * UART on a pseudo-terminal and the board, EEPROM and timer models of host/.
+ * The path of the pseudo-terminal is printed on the first line of the
+ * output, a tester (diag_client) or a terminal program opens it as the serial
+ * port of the ECU. The EEPROMs start blank and the ECU runs until killed.
+ *
+ * Usage: control_host [-t temperature] [-d distance]
+ *   -t : temperature read by the LM35 in degrees C (default 25)
+ *   -d : distance read by the ultrasonic sensor in cm (default 100)
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "std_types.h"
+#include "host_board.h"
+#include "host_eeprom.h"
+#include "host_uart.h"
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/* main() of Control_APP.c, renamed by the build */
+int CONTROL_main(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Open a pseudo-terminal in raw mode and return its master side. The slave
+ * side is kept open, so the line stays up while the tester reopens it.
+ */
+static int CONTROL_HOST_openLine(void)
+{
+	struct termios mode;
+	int master, slave;
+
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if(master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+	{
+		perror("control_host: pseudo-terminal");
+		exit(EXIT_FAILURE);
+	}
+
+	slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	if(slave < 0 || tcgetattr(slave, &mode) != 0)
+	{
+		perror("control_host: pseudo-terminal");
+		exit(EXIT_FAILURE);
+	}
+	cfmakeraw(&mode);
+	tcsetattr(slave, TCSANOW, &mode);
+
+	printf("%s\n", ptsname(master));
+	fflush(stdout);
+	return master;
+}
+
+int main(int argc, char *argv[])
+{
+	int option;
+
+	while((option = getopt(argc, argv, "t:d:")) != -1)
+	{
+		switch(option)
+		{
+		case 't':
+			HOST_setTemperature((uint8)strtoul(optarg, NULL, 0));
+			break;
+		case 'd':
+			HOST_setDistance((uint16)strtoul(optarg, NULL, 0));
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-t temperature] [-d distance]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	HOST_eepromErase();
+	HOST_uartOpen(CONTROL_HOST_openLine());
+
+	return CONTROL_main();
+}
@@ -0,0 +1,739 @@
+/******************************************************************************
+ *
+ * Module: Host tools
+ *
+ * File Name: diag_client.c
+ *
+ * Description: Diagnostic tester for the Control ECU. Opens the serial line of
+ * the ECU (the pseudo-terminal of control_host, or the serial port of a real
+ * board at 9600 baud), trains the link with SYNC bytes and runs the
+ * diagnostic services of diag.h through the framing layer (frame.c) of the
+ * ECUs. The tester side of the ISO-TP style segmentation is here: segmented
+ * requests follow the flow control of the ECU, segmented responses are paced
+ * with the block size and STMIN of the tester. Every check prints PASS or
+ * FAIL, the exit status is the number of failures.
+ *
+ * Checks:
+ *   - ReadDataByIdentifier (0x22): one DID, then every DID of the registry
+ *     (a segmented request and a segmented response), with and without a
+ *     block size and a STMIN, the sizes against FRAME_DID_SIZES
+ *   - negative responses: unknown DID, odd request length, unknown SID,
+ *     unknown ReadDTCInformation sub-function, DTC group other than all
+ *   - ReadDTCInformation (0x19) 0x01 and 0x02 agree with each other, and
+ *     0x06 returns the occurrence counter and the last seen record
+ *   - ClearDiagnosticInformation (0x14) leaves no DTC reported
+ * With -f, monitoring is started first and the fault code given must be
+ * reported failed with at least one occurrence (control_host -d 5 fails
+ * P001, the distance rule).
+ *
+ * Usage: diag_client [-f faultCode] [-v] line
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "frame.h"
+#include "diag.h"
+#include "uart.h"
+#include "sw_timer.h"
+#include "autobaud.h"
+#include "host_uart.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Link training, as the HMI does it */
+#define CLIENT_SYNC_ATTEMPTS              150
+#define CLIENT_SYNC_PERIOD_MS             20
+#define CLIENT_ACK                        0x05
+
+/* Longest wait for a frame of the ECU, and retries of a command request */
+#define CLIENT_TIMEOUT_MS                 1000
+#define CLIENT_COMMAND_ATTEMPTS           3
+
+/* Commands of the request frames used here (see Control_APP.c) */
+#define CLIENT_START_MONITORING           1
+#define CLIENT_STOP_MONITORING            4
+
+/* Time for the fault rules to debounce once monitoring runs (5 checks of 100 ms) */
+#define CLIENT_DEBOUNCE_MS                1500
+
+/* Segment kinds (high nibble of the PCI byte) and flow status, see diag.h */
+#define CLIENT_PCI_SINGLE                 0x0
+#define CLIENT_PCI_FIRST                  0x1
+#define CLIENT_PCI_CONSECUTIVE            0x2
+#define CLIENT_PCI_FLOW_CONTROL           0x3
+#define CLIENT_FLOW_CONTINUE              0x0
+#define CLIENT_FLOW_WAIT                  0x1
+#define CLIENT_SINGLE_DATA                (FRAME_MAX_PAYLOAD - 1)
+#define CLIENT_FIRST_DATA                 (FRAME_MAX_PAYLOAD - 2)
+#define CLIENT_CONSECUTIVE_DATA           (FRAME_MAX_PAYLOAD - 1)
+
+/* DTC status bits and report formats (see dtc.h and Control_APP.c) */
+#define CLIENT_DTC_TEST_FAILED            0x01
+#define CLIENT_DTC_RECORD_OCCURRENCES     0x01
+#define CLIENT_DTC_RECORD_LAST_SEEN       0x02
+#define CLIENT_DTC_RECORD_ALL             0xFF
+#define CLIENT_DTC_RECORD_SIZE            4     /* DTC number (3 bytes), status */
+
+/*******************************************************************************
+ *                                Data Types                                   *
+ *******************************************************************************/
+
+/* Flow control the tester gives for a segmented response */
+typedef struct
+{
+	uint8 blockSize;        /* Consecutive frames per block (0 = all) */
+	uint8 separation_ms;    /* STMIN */
+}CLIENT_FlowType;
+
+/* Diagnostic exchange */
+typedef struct
+{
+	uint8 response[DIAG_MAX_LENGTH];
+	uint8 length;
+	uint8 flowControls;     /* Flow controls sent for the response */
+	uint32 minGap_ms;       /* Shortest time between two consecutive frames of a block */
+	const char *error;      /* Transport error, NULL_PTR if the response came */
+}CLIENT_ExchangeType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static FRAME_ReceiverType g_rx;
+static uint8 g_frameSeq = 0;         /* SEQ of the diagnostic frames */
+static uint8 g_requestId = 0;        /* Correlation id of the command requests */
+static boolean g_ackSeen = FALSE;    /* ACK byte received outside a frame */
+static boolean g_verbose = FALSE;
+static uint16 g_failures = 0;
+
+static const uint8 g_didSizes[FRAME_DIDS_COUNT] = FRAME_DID_SIZES;
+
+static const CLIENT_FlowType g_flowFree = { 0, 0 };
+static const CLIENT_FlowType g_flowPaced = { 2, 10 };
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+static void CLIENT_check(const char *name, boolean passed, const char *detail)
+{
+	printf("%s %s", passed ? "PASS" : "FAIL", name);
+	if(!passed && detail != NULL_PTR)
+	{
+		printf(": %s", detail);
+	}
+	printf("\n");
+	if(!passed)
+	{
+		g_failures++;
+	}
+}
+
+static void CLIENT_dump(const char *direction, const uint8 *data, uint8 length)
+{
+	uint8 i;
+
+	if(!g_verbose)
+	{
+		return;
+	}
+	printf("  %s", direction);
+	for(i = 0; i < length; i++)
+	{
+		printf(" %02X", data[i]);
+	}
+	printf("\n");
+}
+
+/*
+ * Description :
+ * Wait for a frame of a type from the ECU, the other frames are dropped.
+ * Returns FALSE if none came within timeout_ms.
+ */
+static boolean CLIENT_receive(uint8 type, FRAME_Type *frame, uint32 timeout_ms)
+{
+	uint32 start = SWTIMER_getTime();
+	uint8 data;
+
+	while(SWTIMER_getTime() - start < timeout_ms)
+	{
+		while(UART_dataAvailable())
+		{
+			data = UART_recieveByte();
+			if(FRAME_isReceiving(&g_rx) || data == FRAME_SOF)
+			{
+				if(FRAME_receiveByte(&g_rx, data) && g_rx.frame.type == type)
+				{
+					*frame = g_rx.frame;
+					return TRUE;
+				}
+			}
+			else if(data == CLIENT_ACK)
+			{
+				g_ackSeen = TRUE;
+			}
+		}
+		FRAME_checkTimeout(&g_rx);
+	}
+	return FALSE;
+}
+
+static void CLIENT_wait(uint32 time_ms)
+{
+	FRAME_Type frame;
+
+	CLIENT_receive(0, &frame, time_ms);  /* No frame has type 0, the line is only drained */
+}
+
+/*
+ * Description :
+ * Send SYNC bytes until the ECU answers with an ACK. The SYNC bytes are timed
+ * by the ECU at startup, and answered by its main loop once it runs.
+ */
+static boolean CLIENT_train(void)
+{
+	uint8 attempt;
+
+	g_ackSeen = FALSE;
+	for(attempt = 0; attempt < CLIENT_SYNC_ATTEMPTS && !g_ackSeen; attempt++)
+	{
+		UART_sendByte(AUTOBAUD_SYNC_BYTE);
+		CLIENT_wait(CLIENT_SYNC_PERIOD_MS);
+	}
+	CLIENT_wait(CLIENT_SYNC_PERIOD_MS * 2);  /* ACKs of the last SYNC bytes */
+	return g_ackSeen;
+}
+
+/*
+ * Description :
+ * Send a command request and wait for its response (same correlation id),
+ * the request is sent again if none comes.
+ */
+static boolean CLIENT_command(uint8 command, FRAME_Type *response)
+{
+	uint8 id = g_requestId++;
+	uint8 attempt;
+
+	for(attempt = 0; attempt < CLIENT_COMMAND_ATTEMPTS; attempt++)
+	{
+		FRAME_send(FRAME_TYPE_REQUEST, id, &command, 1);
+		while(CLIENT_receive(FRAME_TYPE_RESPONSE, response, CLIENT_TIMEOUT_MS))
+		{
+			if(response->seq == id && response->length >= 1 && response->payload[0] == command)
+			{
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
+
+static void CLIENT_sendSegment(const uint8 *payload, uint8 length)
+{
+	CLIENT_dump(">", payload, length);
+	FRAME_send(FRAME_TYPE_DIAG, g_frameSeq++, payload, length);
+}
+
+/*
+ * Description :
+ * Wait for the flow control of the ECU to a segmented request, a WAIT is
+ * followed by another one. Returns FALSE on a timeout or an overflow.
+ */
+static boolean CLIENT_receiveFlowControl(CLIENT_FlowType *flow, CLIENT_ExchangeType *exchange)
+{
+	FRAME_Type frame;
+
+	while(CLIENT_receive(FRAME_TYPE_DIAG, &frame, DIAG_FLOW_CONTROL_TIMEOUT_MS))
+	{
+		CLIENT_dump("<", frame.payload, frame.length);
+		if(frame.length < 3 || (frame.payload[0] >> 4) != CLIENT_PCI_FLOW_CONTROL)
+		{
+			continue;
+		}
+		if((frame.payload[0] & 0x0F) == CLIENT_FLOW_CONTINUE)
+		{
+			flow->blockSize = frame.payload[1];
+			flow->separation_ms = (frame.payload[2] <= 0x7F) ? frame.payload[2] : 1;
+			return TRUE;
+		}
+		if((frame.payload[0] & 0x0F) != CLIENT_FLOW_WAIT)
+		{
+			exchange->error = "request refused by a flow control overflow";
+			return FALSE;
+		}
+	}
+	exchange->error = "no flow control";
+	return FALSE;
+}
+
+/*
+ * Description :
+ * Send a request: a single frame, or a first frame and consecutive frames
+ * paced by the flow control of the ECU.
+ */
+static boolean CLIENT_sendRequest(const uint8 *request, uint8 length, CLIENT_ExchangeType *exchange)
+{
+	uint8 payload[FRAME_MAX_PAYLOAD];
+	CLIENT_FlowType flow;
+	uint8 index, count, segment = 1, blockLeft;
+
+	if(length <= CLIENT_SINGLE_DATA)
+	{
+		payload[0] = (CLIENT_PCI_SINGLE << 4) | length;
+		memcpy(&payload[1], request, length);
+		CLIENT_sendSegment(payload, length + 1);
+		return TRUE;
+	}
+
+	payload[0] = (CLIENT_PCI_FIRST << 4);
+	payload[1] = length;
+	memcpy(&payload[2], request, CLIENT_FIRST_DATA);
+	CLIENT_sendSegment(payload, FRAME_MAX_PAYLOAD);
+	if(!CLIENT_receiveFlowControl(&flow, exchange))
+	{
+		return FALSE;
+	}
+
+	blockLeft = flow.blockSize;
+	for(index = CLIENT_FIRST_DATA; index < length; index += count)
+	{
+		count = length - index;
+		if(count > CLIENT_CONSECUTIVE_DATA)
+		{
+			count = CLIENT_CONSECUTIVE_DATA;
+		}
+		payload[0] = (CLIENT_PCI_CONSECUTIVE << 4) | segment;
+		memcpy(&payload[1], &request[index], count);
+		CLIENT_sendSegment(payload, count + 1);
+		segment = (segment + 1) & 0x0F;
+
+		if(index + count < length)
+		{
+			if(flow.blockSize != 0 && --blockLeft == 0)
+			{
+				if(!CLIENT_receiveFlowControl(&flow, exchange))
+				{
+					return FALSE;
+				}
+				blockLeft = flow.blockSize;
+			}
+			else
+			{
+				CLIENT_wait(flow.separation_ms);
+			}
+		}
+	}
+	return TRUE;
+}
+
+static void CLIENT_sendFlowControl(const CLIENT_FlowType *flow, CLIENT_ExchangeType *exchange)
+{
+	uint8 payload[3];
+
+	payload[0] = (CLIENT_PCI_FLOW_CONTROL << 4) | CLIENT_FLOW_CONTINUE;
+	payload[1] = flow->blockSize;
+	payload[2] = flow->separation_ms;
+	CLIENT_sendSegment(payload, 3);
+	exchange->flowControls++;
+}
+
+/*
+ * Description :
+ * Receive a response: a single frame, or a first frame and the consecutive
+ * frames, with a flow control after the first frame and after every block.
+ */
+static boolean CLIENT_receiveResponse(const CLIENT_FlowType *flow, CLIENT_ExchangeType *exchange)
+{
+	FRAME_Type frame;
+	uint8 segment = 1, count, expected, blockLeft;
+	uint32 last_ms = 0;
+	boolean inBlock = FALSE;
+
+	do
+	{
+		if(!CLIENT_receive(FRAME_TYPE_DIAG, &frame, CLIENT_TIMEOUT_MS))
+		{
+			exchange->error = "no response";
+			return FALSE;
+		}
+		CLIENT_dump("<", frame.payload, frame.length);
+	}while(frame.length == 0 || (frame.payload[0] >> 4) == CLIENT_PCI_FLOW_CONTROL);
+
+	switch(frame.payload[0] >> 4)
+	{
+	case CLIENT_PCI_SINGLE:
+		exchange->length = frame.payload[0] & 0x0F;
+		if(exchange->length == 0 || exchange->length >= frame.length)
+		{
+			exchange->error = "bad single frame";
+			return FALSE;
+		}
+		memcpy(exchange->response, &frame.payload[1], exchange->length);
+		return TRUE;
+
+	case CLIENT_PCI_FIRST:
+		exchange->length = frame.payload[1];
+		if((frame.payload[0] & 0x0F) != 0 || exchange->length <= CLIENT_SINGLE_DATA ||
+		   frame.length != FRAME_MAX_PAYLOAD)
+		{
+			exchange->error = "bad first frame";
+			return FALSE;
+		}
+		memcpy(exchange->response, &frame.payload[2], CLIENT_FIRST_DATA);
+		break;
+
+	default:
+		exchange->error = "consecutive frame without a first frame";
+		return FALSE;
+	}
+
+	CLIENT_sendFlowControl(flow, exchange);
+	blockLeft = flow->blockSize;
+	for(count = CLIENT_FIRST_DATA; count < exchange->length; count += expected)
+	{
+		if(!CLIENT_receive(FRAME_TYPE_DIAG, &frame, DIAG_CONSECUTIVE_TIMEOUT_MS))
+		{
+			exchange->error = "consecutive frame missing";
+			return FALSE;
+		}
+		CLIENT_dump("<", frame.payload, frame.length);
+
+		expected = exchange->length - count;
+		if(expected > CLIENT_CONSECUTIVE_DATA)
+		{
+			expected = CLIENT_CONSECUTIVE_DATA;
+		}
+		if(frame.length < expected + 1 || frame.payload[0] != ((CLIENT_PCI_CONSECUTIVE << 4) | segment))
+		{
+			exchange->error = "consecutive frame out of sequence";
+			return FALSE;
+		}
+		if(inBlock && SWTIMER_getTime() - last_ms < exchange->minGap_ms)
+		{
+			exchange->minGap_ms = SWTIMER_getTime() - last_ms;
+		}
+		last_ms = SWTIMER_getTime();
+		inBlock = TRUE;
+
+		memcpy(&exchange->response[count], &frame.payload[1], expected);
+		segment = (segment + 1) & 0x0F;
+
+		if(flow->blockSize != 0 && --blockLeft == 0 && count + expected < exchange->length)
+		{
+			CLIENT_sendFlowControl(flow, exchange);
+			blockLeft = flow->blockSize;
+			inBlock = FALSE;  /* The gap after a flow control is not paced by STMIN */
+		}
+	}
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Run one diagnostic exchange. Returns FALSE on a transport error (exchange->error).
+ */
+static boolean CLIENT_diag(const uint8 *request, uint8 length, const CLIENT_FlowType *flow,
+		CLIENT_ExchangeType *exchange)
+{
+	memset(exchange, 0, sizeof(*exchange));
+	exchange->minGap_ms = 0xFFFFFFFFUL;
+
+	return CLIENT_sendRequest(request, length, exchange) && CLIENT_receiveResponse(flow, exchange);
+}
+
+/*
+ * Description :
+ * Run a request that must get a negative response with a given code.
+ */
+static void CLIENT_checkNegative(const char *name, const uint8 *request, uint8 length, uint8 nrc)
+{
+	CLIENT_ExchangeType exchange;
+	char detail[64];
+
+	if(!CLIENT_diag(request, length, &g_flowFree, &exchange))
+	{
+		CLIENT_check(name, FALSE, exchange.error);
+		return;
+	}
+	snprintf(detail, sizeof(detail), "response %02X %02X %02X, length %u", exchange.response[0],
+			exchange.response[1], exchange.response[2], exchange.length);
+	CLIENT_check(name, exchange.length == 3 && exchange.response[0] == DIAG_NEGATIVE_RESPONSE &&
+			exchange.response[1] == request[0] && exchange.response[2] == nrc, detail);
+}
+
+/*******************************************************************************
+ *                                 Checks                                      *
+ *******************************************************************************/
+
+static void CLIENT_checkReadDid(void)
+{
+	uint8 request[] = { DIAG_SID_READ_DID, (uint8)(FRAME_DID_TEMPERATURE >> 8), (uint8)FRAME_DID_TEMPERATURE };
+	CLIENT_ExchangeType exchange;
+
+	if(!CLIENT_diag(request, sizeof(request), &g_flowFree, &exchange))
+	{
+		CLIENT_check("0x22 one DID", FALSE, exchange.error);
+		return;
+	}
+	CLIENT_check("0x22 one DID", exchange.length == 4 &&
+			exchange.response[0] == DIAG_SID_READ_DID + DIAG_POSITIVE_RESPONSE &&
+			exchange.response[1] == request[1] && exchange.response[2] == request[2], "bad response");
+}
+
+/*
+ * Description :
+ * Read every DID in one request (segmented request and response), with the
+ * flow control given, and check the IDs and sizes of the response.
+ */
+static void CLIENT_checkReadAllDids(const char *name, const CLIENT_FlowType *flow)
+{
+	uint8 request[1 + 2 * FRAME_DIDS_COUNT];
+	CLIENT_ExchangeType exchange;
+	uint8 index = 1, did;
+	uint16 id;
+	char detail[96];
+
+	request[0] = DIAG_SID_READ_DID;
+	for(did = 0; did < FRAME_DIDS_COUNT; did++)
+	{
+		request[1 + 2 * did] = (uint8)((FRAME_DID_FIRST + did) >> 8);
+		request[2 + 2 * did] = (uint8)(FRAME_DID_FIRST + did);
+	}
+
+	if(!CLIENT_diag(request, sizeof(request), flow, &exchange))
+	{
+		CLIENT_check(name, FALSE, exchange.error);
+		return;
+	}
+
+	if(exchange.response[0] != DIAG_SID_READ_DID + DIAG_POSITIVE_RESPONSE)
+	{
+		snprintf(detail, sizeof(detail), "response %02X %02X %02X", exchange.response[0],
+				exchange.response[1], exchange.response[2]);
+		CLIENT_check(name, FALSE, detail);
+		return;
+	}
+	for(did = 0; did < FRAME_DIDS_COUNT; did++)
+	{
+		id = ((uint16)exchange.response[index] << 8) | exchange.response[index + 1];
+		if(index + 2 + g_didSizes[did] > exchange.length || id != FRAME_DID_FIRST + did)
+		{
+			snprintf(detail, sizeof(detail), "DID %04X not found at byte %u", FRAME_DID_FIRST + did, index);
+			CLIENT_check(name, FALSE, detail);
+			return;
+		}
+		index += 2 + g_didSizes[did];
+	}
+
+	snprintf(detail, sizeof(detail), "%u bytes left over, %u flow controls, STMIN %u ms, shortest gap %lu ms",
+			exchange.length - index, exchange.flowControls, flow->separation_ms,
+			(unsigned long)exchange.minGap_ms);
+	CLIENT_check(name, index == exchange.length &&
+			(flow->blockSize == 0 || exchange.flowControls > 1) &&
+			(flow->separation_ms == 0 || exchange.minGap_ms >= flow->separation_ms), detail);
+	if(g_verbose)
+	{
+		printf("  %u bytes, %s\n", exchange.length, detail);
+	}
+}
+
+/*
+ * Description :
+ * Returns the number of DTCs with a status in mask (0x19 0x01), checked against
+ * the list of 0x19 0x02. -1 if the exchange failed.
+ */
+static sint16 CLIENT_checkDtcCount(uint8 mask, uint8 *records, uint8 *recordsLength)
+{
+	uint8 countRequest[] = { DIAG_SID_READ_DTC, 0x01, mask };
+	uint8 listRequest[] = { DIAG_SID_READ_DTC, 0x02, mask };
+	CLIENT_ExchangeType exchange;
+	uint16 count;
+	char detail[64];
+
+	if(!CLIENT_diag(countRequest, sizeof(countRequest), &g_flowFree, &exchange))
+	{
+		CLIENT_check("0x19 0x01 count by status mask", FALSE, exchange.error);
+		return -1;
+	}
+	count = ((uint16)exchange.response[4] << 8) | exchange.response[5];
+	CLIENT_check("0x19 0x01 count by status mask", exchange.length == 6 &&
+			exchange.response[0] == DIAG_SID_READ_DTC + DIAG_POSITIVE_RESPONSE &&
+			exchange.response[1] == 0x01, "bad response");
+
+	if(!CLIENT_diag(listRequest, sizeof(listRequest), &g_flowFree, &exchange))
+	{
+		CLIENT_check("0x19 0x02 DTCs by status mask", FALSE, exchange.error);
+		return -1;
+	}
+	snprintf(detail, sizeof(detail), "%u bytes for %u DTCs", exchange.length, count);
+	CLIENT_check("0x19 0x02 DTCs by status mask", exchange.length == 3 + CLIENT_DTC_RECORD_SIZE * count &&
+			exchange.response[0] == DIAG_SID_READ_DTC + DIAG_POSITIVE_RESPONSE &&
+			exchange.response[1] == 0x02, detail);
+
+	*recordsLength = exchange.length - 3;
+	memcpy(records, &exchange.response[3], *recordsLength);
+	return (sint16)count;
+}
+
+static void CLIENT_checkExtData(uint8 faultCode, boolean failed)
+{
+	uint8 request[] = { DIAG_SID_READ_DTC, 0x06, 0x00, faultCode, 0x00, CLIENT_DTC_RECORD_ALL };
+	CLIENT_ExchangeType exchange;
+	char detail[64];
+
+	if(!CLIENT_diag(request, sizeof(request), &g_flowFree, &exchange))
+	{
+		CLIENT_check("0x19 0x06 extended data records", FALSE, exchange.error);
+		return;
+	}
+	/* 0x59 0x06, DTC number, status, occurrence counter record, last seen record */
+	snprintf(detail, sizeof(detail), "length %u, status %02X, occurrences %u", exchange.length,
+			exchange.response[5], exchange.response[7]);
+	CLIENT_check("0x19 0x06 extended data records", exchange.length == 14 &&
+			exchange.response[0] == DIAG_SID_READ_DTC + DIAG_POSITIVE_RESPONSE &&
+			exchange.response[1] == 0x06 && exchange.response[3] == faultCode &&
+			exchange.response[6] == CLIENT_DTC_RECORD_OCCURRENCES &&
+			exchange.response[8] == CLIENT_DTC_RECORD_LAST_SEEN &&
+			(!failed || ((exchange.response[5] & CLIENT_DTC_TEST_FAILED) && exchange.response[7] >= 1)), detail);
+}
+
+static void CLIENT_checkClear(void)
+{
+	uint8 request[] = { DIAG_SID_CLEAR_DTC, 0xFF, 0xFF, 0xFF };
+	uint8 records[DIAG_MAX_LENGTH];
+	uint8 recordsLength;
+	CLIENT_ExchangeType exchange;
+
+	if(!CLIENT_diag(request, sizeof(request), &g_flowFree, &exchange))
+	{
+		CLIENT_check("0x14 clear all DTCs", FALSE, exchange.error);
+		return;
+	}
+	CLIENT_check("0x14 clear all DTCs", exchange.length == 1 &&
+			exchange.response[0] == DIAG_SID_CLEAR_DTC + DIAG_POSITIVE_RESPONSE, "bad response");
+	CLIENT_check("no DTC after the clear", CLIENT_checkDtcCount(0xFF, records, &recordsLength) == 0, NULL_PTR);
+}
+
+static void CLIENT_checkNegatives(void)
+{
+	const uint8 unknownDid[] = { DIAG_SID_READ_DID, 0x02, 0x00 };
+	const uint8 oddLength[] = { DIAG_SID_READ_DID, 0x01 };
+	const uint8 unknownSid[] = { 0x10, 0x01 };
+	const uint8 unknownReport[] = { DIAG_SID_READ_DTC, 0x03 };
+	const uint8 oneGroup[] = { DIAG_SID_CLEAR_DTC, 0x00, 0x01, 0x00 };
+
+	CLIENT_checkNegative("0x22 unknown DID", unknownDid, sizeof(unknownDid), DIAG_NRC_REQUEST_OUT_OF_RANGE);
+	CLIENT_checkNegative("0x22 odd length", oddLength, sizeof(oddLength), DIAG_NRC_INVALID_FORMAT);
+	CLIENT_checkNegative("unknown SID", unknownSid, sizeof(unknownSid), DIAG_NRC_SERVICE_NOT_SUPPORTED);
+	CLIENT_checkNegative("0x19 unknown sub-function", unknownReport, sizeof(unknownReport),
+			DIAG_NRC_SUBFUNCTION_NOT_SUPPORTED);
+	CLIENT_checkNegative("0x14 one DTC group", oneGroup, sizeof(oneGroup), DIAG_NRC_REQUEST_OUT_OF_RANGE);
+}
+
+/*
+ * Description :
+ * Open the line in raw mode at the base rate of the link.
+ */
+static int CLIENT_openLine(const char *path)
+{
+	struct termios mode;
+	int fd = open(path, O_RDWR | O_NOCTTY);
+
+	if(fd < 0 || tcgetattr(fd, &mode) != 0)
+	{
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+	cfmakeraw(&mode);
+	cfsetspeed(&mode, B9600);
+	mode.c_cc[VMIN] = 0;
+	mode.c_cc[VTIME] = 0;
+	tcsetattr(fd, TCSANOW, &mode);
+	return fd;
+}
+
+int main(int argc, char *argv[])
+{
+	UART_ConfigType config = { UART_8_BIT_DATA, UART_PARITY_DISABLED, UART_ONE_STOP_BIT, 9600 };
+	uint8 records[DIAG_MAX_LENGTH];
+	uint8 recordsLength, i;
+	sint16 faultCode = -1, failedCount;
+	boolean failed;
+	FRAME_Type response;
+	int option;
+
+	while((option = getopt(argc, argv, "f:v")) != -1)
+	{
+		switch(option)
+		{
+		case 'f':
+			faultCode = (sint16)strtol(optarg, NULL, 0);
+			break;
+		case 'v':
+			g_verbose = TRUE;
+			break;
+		default:
+			optind = argc;
+			break;
+		}
+	}
+	if(optind != argc - 1)
+	{
+		fprintf(stderr, "usage: %s [-f faultCode] [-v] line\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	HOST_uartOpen(CLIENT_openLine(argv[optind]));
+	UART_init(&config);
+	SWTIMER_init();
+	FRAME_resetReceiver(&g_rx);
+
+	CLIENT_check("link training", CLIENT_train(), "no ACK to the SYNC bytes");
+	if(g_failures != 0)
+	{
+		return g_failures;
+	}
+
+	CLIENT_checkReadDid();
+	CLIENT_checkReadAllDids("0x22 every DID, segmented both ways", &g_flowFree);
+	CLIENT_checkReadAllDids("0x22 every DID, block size 2, STMIN 10 ms", &g_flowPaced);
+	CLIENT_checkNegatives();
+
+	if(faultCode >= 0)
+	{
+		CLIENT_check("start monitoring", CLIENT_command(CLIENT_START_MONITORING, &response), "no response");
+		CLIENT_wait(CLIENT_DEBOUNCE_MS);
+		CLIENT_check("stop monitoring", CLIENT_command(CLIENT_STOP_MONITORING, &response), "no response");
+	}
+
+	failedCount = CLIENT_checkDtcCount(CLIENT_DTC_TEST_FAILED, records, &recordsLength);
+	failed = FALSE;
+	for(i = 0; i + CLIENT_DTC_RECORD_SIZE <= recordsLength; i += CLIENT_DTC_RECORD_SIZE)
+	{
+		if(records[i + 1] == faultCode)
+		{
+			failed = TRUE;
+		}
+	}
+	if(faultCode >= 0)
+	{
+		CLIENT_check("fault code reported failed", failedCount >= 1 && failed, "not in the failed DTCs");
+	}
+	CLIENT_checkExtData((faultCode >= 0) ? (uint8)faultCode : 1, faultCode >= 0);
+	CLIENT_checkClear();
+
+	printf("%u failures\n", g_failures);
+	return g_failures;
+}
@@ -0,0 +1,23 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: avr/interrupt.h
+ *
+ * Description: Host stand-in for the avr-libc interrupt header. The host models
+ * have no interrupts, the peripherals are polled.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#define sei()                             (SREG |= (1 << 7))
+#define cli()                             (SREG &= ~(1 << 7))
+#define ISR(vector)                       void vector(void)
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
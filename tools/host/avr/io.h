@@ -0,0 +1,24 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: avr/io.h
+ *
+ * Description: Host stand-in for the avr-libc I/O header. Only the status
+ * register is there, the drivers that touch the other registers are replaced
+ * by the host models.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+#include <stdint.h>
+
+extern volatile uint8_t HOST_SREG;
+
+#define SREG                              HOST_SREG
+
+#endif /* HOST_AVR_IO_H_ */
@@ -0,0 +1,31 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: avr/pgmspace.h
+ *
+ * Description: Host stand-in for the avr-libc program memory header. The host
+ * has one address space, the flash tables are ordinary constants.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s)                           (s)
+
+/* Read through the pointer type, the tables of function pointers are 8 bytes wide here */
+#define pgm_read_byte(address)            (*(const unsigned char *)(address))
+#define pgm_read_word(address)            (*(address))
+#define pgm_read_dword(address)           (*(address))
+
+#define memcpy_P                          memcpy
+#define strcpy_P                          strcpy
+#define strlen_P                          strlen
+
+#endif /* HOST_AVR_PGMSPACE_H_ */
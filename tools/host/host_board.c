@@ -0,0 +1,98 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: host_board.c
+ *
+ * Description: Model of the Control ECU board for the host builds.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include "host_board.h"
+#include "host_timer.h"
+#include "gpio.h"
+#include "adc.h"
+#include "dc_motor.h"
+#include "lm35_sensor.h"
+#include "ultrasonic.h"
+#include "twi.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+volatile uint8_t HOST_SREG = 0;
+
+static uint8 g_temperature = HOST_DEFAULT_TEMPERATURE;
+static uint16 g_distance = HOST_DEFAULT_DISTANCE;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void HOST_setTemperature(uint8 temperature)
+{
+	g_temperature = temperature;
+}
+
+void HOST_setDistance(uint16 distance)
+{
+	g_distance = distance;
+}
+
+/*******************************************************************************
+ *                              Peripherals                                    *
+ *******************************************************************************/
+
+void GPIO_setupPinDirection(uint8 port_num, uint8 pin_num, GPIO_PinDirectionType direction)
+{
+}
+
+/* The buttons are released (low) */
+uint8 GPIO_readPin(uint8 port_num, uint8 pin_num)
+{
+	return LOGIC_LOW;
+}
+
+void ADC_init(ADC_typeConfig *ptr)
+{
+}
+
+uint8 LM35_getTemperature(void)
+{
+	return g_temperature;
+}
+
+void Ultrasonic_init(void)
+{
+}
+
+uint16 Ultrasonic_readDistance(void)
+{
+	HOST_timerUpdate();
+	return g_distance;
+}
+
+void DcMotor_Init(MOTOR_typeConfig *ptr)
+{
+}
+
+void DcMotor_Rotate(MOTOR_typeConfig *ptr, DcMotor_State state, uint8 speed)
+{
+}
+
+void TWI_init(const TWI_ConfigType * Config_Ptr)
+{
+}
+
+/* No TWI master on the host, the registers are never read */
+void TWI_slaveInit(const volatile uint8 *registers, uint8 count)
+{
+}
+
+boolean TWI_slaveIsBusy(void)
+{
+	return FALSE;
+}
@@ -0,0 +1,35 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: host_board.h
+ *
+ * Description: Model of the Control ECU board for the host builds: the window
+ * buttons are released, the motors and the TWI slave do nothing, and the
+ * sensors read the values set here.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef HOST_BOARD_H_
+#define HOST_BOARD_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define HOST_DEFAULT_TEMPERATURE          25    /* Degrees C */
+#define HOST_DEFAULT_DISTANCE             100   /* cm */
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/* Values read by LM35_getTemperature() and Ultrasonic_readDistance() */
+void HOST_setTemperature(uint8 temperature);
+void HOST_setDistance(uint16 distance);
+
+#endif /* HOST_BOARD_H_ */
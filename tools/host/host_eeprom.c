@@ -0,0 +1,167 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: host_eeprom.c
+ *
+ * Description: RAM models of the external and internal EEPROMs for the host
+ * builds of the Control ECU code.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_eeprom.h"
+#include "external_eeprom.h"
+#include "internal_eeprom.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define HOST_EEPROM_MAX_SIZE              (8 * 65536UL)  /* 8 24C512 */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static EEPROM_DeviceType g_device;  /* Memory selected by EEPROM_init() */
+
+static uint8 g_eeprom[HOST_EEPROM_MAX_SIZE];
+static uint8 g_ieeprom[IEEPROM_SIZE];
+static boolean g_ieepromLost = FALSE;
+static HOST_EepromStatsType g_stats;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static void HOST_eepromFault(const char *access, EEPROM_AddressType address, uint16 length)
+{
+	fprintf(stderr, "EEPROM: %s of %u bytes at 0x%05lX refused by the memory\n",
+			access, length, (unsigned long)address);
+	exit(EXIT_FAILURE);
+}
+
+void HOST_eepromErase(void)
+{
+	memset(g_eeprom, 0xFF, sizeof(g_eeprom));
+	memset(g_ieeprom, 0xFF, sizeof(g_ieeprom));
+}
+
+uint8 *HOST_eepromData(void)
+{
+	return g_eeprom;
+}
+
+void HOST_ieepromLoseWrites(boolean lost)
+{
+	g_ieepromLost = lost;
+}
+
+void HOST_eepromGetStats(HOST_EepromStatsType *stats)
+{
+	*stats = g_stats;
+}
+
+void HOST_eepromResetStats(void)
+{
+	memset(&g_stats, 0, sizeof(g_stats));
+}
+
+/*******************************************************************************
+ *                    External EEPROM (external_eeprom.h)                      *
+ *******************************************************************************/
+
+void EEPROM_init(const EEPROM_DeviceType *device)
+{
+	g_device = *device;
+	if(EEPROM_getCapacity() > HOST_EEPROM_MAX_SIZE)
+	{
+		HOST_eepromFault("selection", 0, 0);
+	}
+}
+
+EEPROM_AddressType EEPROM_getCapacity(void)
+{
+	return (EEPROM_AddressType)g_device.capacity * g_device.chips;
+}
+
+uint8 EEPROM_getPageSize(void)
+{
+	return g_device.pageSize;
+}
+
+uint8 EEPROM_writeByte(EEPROM_AddressType u32addr,uint8 u8data)
+{
+	return EEPROM_writeBlock(u32addr, &u8data, 1);
+}
+
+uint8 EEPROM_readByte(EEPROM_AddressType u32addr,uint8 *u8data)
+{
+	return EEPROM_readBlock(u32addr, u8data, 1);
+}
+
+uint8 EEPROM_writeBlock(EEPROM_AddressType u32addr,const uint8 *data,uint8 length)
+{
+	/* The page address counter rolls over inside the page, the part would write over its start */
+	if(length == 0 || length > g_device.pageSize ||
+	   u32addr % g_device.pageSize + length > g_device.pageSize ||
+	   u32addr + length > EEPROM_getCapacity())
+	{
+		HOST_eepromFault("write", u32addr, length);
+	}
+	memcpy(&g_eeprom[u32addr], data, length);
+	g_stats.writes++;
+	return SUCCESS;
+}
+
+uint8 EEPROM_readBlock(EEPROM_AddressType u32addr,uint8 *data,uint16 length)
+{
+	/* A sequential read rolls over at the end of the chip */
+	if(length == 0 || u32addr + length > EEPROM_getCapacity() ||
+	   u32addr / g_device.capacity != (u32addr + length - 1) / g_device.capacity)
+	{
+		HOST_eepromFault("read", u32addr, length);
+	}
+	memcpy(data, &g_eeprom[u32addr], length);
+	g_stats.reads++;
+	g_stats.readBytes += length;
+	return SUCCESS;
+}
+
+uint8 EEPROM_waitReady(void)
+{
+	return SUCCESS;
+}
+
+/*******************************************************************************
+ *                    Internal EEPROM (internal_eeprom.h)                      *
+ *******************************************************************************/
+
+boolean IEEPROM_write(uint16 address, const uint8 *data, uint8 length)
+{
+	if(length > IEEPROM_BUFFER_SIZE || address + length > IEEPROM_SIZE)
+	{
+		return FALSE;
+	}
+	if(!g_ieepromLost)
+	{
+		memcpy(&g_ieeprom[address], data, length);
+	}
+	return TRUE;
+}
+
+void IEEPROM_read(uint16 address, uint8 *data, uint8 length)
+{
+	memcpy(data, &g_ieeprom[address], length);
+}
+
+boolean IEEPROM_isBusy(void)
+{
+	return FALSE;
+}
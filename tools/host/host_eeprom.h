@@ -0,0 +1,61 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: host_eeprom.h
+ *
+ * Description: RAM models of the external (24Cxx) and internal EEPROMs for the
+ * host builds of the Control ECU code. They implement external_eeprom.h and
+ * internal_eeprom.h, and check what the real parts would refuse: a block
+ * written across a write page or past the memory, a block read across a chip.
+ * Such an access is a bug in the caller, it is printed and the program stops.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef HOST_EEPROM_H_
+#define HOST_EEPROM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Data Types                                   *
+ *******************************************************************************/
+
+/* Accesses to the external EEPROM since the last HOST_eepromResetStats() */
+typedef struct
+{
+	uint32 reads;        /* EEPROM_readByte() and EEPROM_readBlock() transfers */
+	uint32 readBytes;
+	uint32 writes;       /* Write cycles */
+}HOST_EepromStatsType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Erase both memories (all bytes 0xFF), like new parts.
+ */
+void HOST_eepromErase(void);
+
+/*
+ * Description :
+ * Returns the contents of the external EEPROM (EEPROM_getCapacity() bytes), to
+ * corrupt them on purpose.
+ */
+uint8 *HOST_eepromData(void);
+
+/*
+ * Description :
+ * While lost is TRUE, the internal EEPROM writes are accepted but never
+ * programmed, like writes still in the background when the power goes.
+ */
+void HOST_ieepromLoseWrites(boolean lost);
+
+void HOST_eepromGetStats(HOST_EepromStatsType *stats);
+void HOST_eepromResetStats(void);
+
+#endif /* HOST_EEPROM_H_ */
@@ -0,0 +1,115 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: host_timer.c
+ *
+ * Description: Model of the AVR hardware timers and busy waits on the host clock.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include <time.h>
+
+#include "host_timer.h"
+#include "timer.h"
+#include <util/delay.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define HOST_TIMERS_COUNT                 3
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Clock divisions of the CSn2:0 codes, Timer2 has its own table */
+static const uint16 g_prescalers[8]  = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+static const uint16 g_prescalers2[8] = { 0, 1, 8, 32, 64, 128, 256, 1024 };
+
+static void (*g_callBacks[HOST_TIMERS_COUNT])(void);
+static uint64 g_period_us[HOST_TIMERS_COUNT];   /* Time between two interrupts (0 = stopped) */
+static uint64 g_next_us[HOST_TIMERS_COUNT];     /* Time of the next interrupt */
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+uint64 HOST_timerClock_us(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64)now.tv_sec * 1000000ULL + (uint64)now.tv_nsec / 1000;
+}
+
+void HOST_timerUpdate(void)
+{
+	uint64 now = HOST_timerClock_us();
+	uint8 id;
+
+	for(id = 0; id < HOST_TIMERS_COUNT; id++)
+	{
+		while(g_period_us[id] != 0 && now >= g_next_us[id])
+		{
+			g_next_us[id] += g_period_us[id];
+			if(g_callBacks[id] != NULL_PTR)
+			{
+				(*g_callBacks[id])();
+			}
+		}
+	}
+}
+
+void HOST_delay_us(double us)
+{
+	uint64 end = HOST_timerClock_us() + (uint64)us;
+	struct timespec step = { 0, 1000000 };
+
+	while(HOST_timerClock_us() < end)
+	{
+		nanosleep(&step, NULL);
+		HOST_timerUpdate();
+	}
+}
+
+/*******************************************************************************
+ *                           Timers (timer.h)                                  *
+ *******************************************************************************/
+
+void TIMER_init(const Timer_ConfigType * Config_Ptr)
+{
+	Timer_ID_Type id = Config_Ptr->timer_ID;
+	uint16 prescaler = (id == TIMER2_ID) ? g_prescalers2[Config_Ptr->timer_clock & 0x07] :
+	                                       g_prescalers[Config_Ptr->timer_clock & 0x07];
+	uint32 counts;
+
+	switch(Config_Ptr->timer_mode)
+	{
+	case TIMER_COMP:
+		counts = (uint32)Config_Ptr->timer_compare_MatchValue + 1 - Config_Ptr->timer_InitialValue;
+		break;
+	case TIMER_OVF:
+		counts = ((id == TIMER1_ID) ? 0x10000UL : 0x100UL) - Config_Ptr->timer_InitialValue;
+		break;
+	default:
+		counts = 0;  /* PWM: no interrupt */
+		break;
+	}
+
+	g_period_us[id] = (uint64)counts * prescaler * 1000000ULL / F_CPU;
+	g_next_us[id] = HOST_timerClock_us() + g_period_us[id];
+}
+
+void TIMER_deInit(Timer_ID_Type timer_ID)
+{
+	g_period_us[timer_ID] = 0;
+}
+
+void TIMER_setCallBack(void(*a_ptr)(void), Timer_ID_Type a_timer_ID )
+{
+	g_callBacks[a_timer_ID] = a_ptr;
+}
@@ -0,0 +1,39 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: host_timer.h
+ *
+ * Description: Model of the AVR hardware timers (timer.h) on the host clock.
+ * A timer started by TIMER_init() in compare or overflow mode runs its
+ * callback once for every period elapsed, as its interrupt would. There are
+ * no interrupts on the host: the elapsed periods are run by HOST_timerUpdate(),
+ * which the other host models call each time they are polled or wait, so
+ * sw_timer.c runs unchanged over it.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef HOST_TIMER_H_
+#define HOST_TIMER_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Run the callbacks of the periods elapsed since the last update.
+ */
+void HOST_timerUpdate(void);
+
+/*
+ * Description :
+ * Returns the host clock in us (monotonic, arbitrary origin).
+ */
+uint64 HOST_timerClock_us(void);
+
+#endif /* HOST_TIMER_H_ */
@@ -0,0 +1,222 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: host_uart.c
+ *
+ * Description: Model of the UART driver and of the baud rate detection over a
+ * host file descriptor.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "host_uart.h"
+#include "host_timer.h"
+#include "uart.h"
+#include "autobaud.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Longest SYNC byte measure, one Timer1 overflow at 8 MHz */
+#define HOST_AUTOBAUD_TIMEOUT_MS          9
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static int g_fd = -1;
+
+static uint8 g_rxBuffer[UART_RX_BUFFER_SIZE];
+static uint8 g_rxHead = 0;           /* Next byte written */
+static uint8 g_rxTail = 0;           /* Next byte read */
+static uint8 g_rxCount = 0;
+
+static UART_BaudRateType g_baudRate = 0;
+static UART_ErrorCountersType g_counters;
+
+/*******************************************************************************
+ *                      Private Functions                                      *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Move the bytes waiting on the descriptor to the receive ring, waiting up to
+ * timeout_ms (-1 = no limit) for the first one when none is there. Returns
+ * the number of bytes moved.
+ */
+static uint8 HOST_uartPoll(int timeout_ms)
+{
+	struct pollfd line = { g_fd, POLLIN, 0 };
+	uint8 data[UART_RX_BUFFER_SIZE];
+	uint8 room = UART_RX_BUFFER_SIZE - g_rxCount;
+	ssize_t count;
+	uint8 i;
+
+	HOST_timerUpdate();
+	if(g_fd < 0 || room == 0 || poll(&line, 1, timeout_ms) <= 0)
+	{
+		HOST_timerUpdate();
+		return 0;
+	}
+	HOST_timerUpdate();
+
+	count = read(g_fd, data, room);
+	if(count <= 0)
+	{
+		if(count == 0 || (errno != EAGAIN && errno != EINTR))
+		{
+			fprintf(stderr, "UART: line closed\n");
+			exit(EXIT_FAILURE);
+		}
+		return 0;
+	}
+
+	for(i = 0; i < count; i++)
+	{
+		g_rxBuffer[g_rxHead] = data[i];
+		g_rxHead = (g_rxHead + 1) & (UART_RX_BUFFER_SIZE - 1);
+		g_rxCount++;
+		g_counters.received++;
+	}
+	return (uint8)count;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void HOST_uartOpen(int fd)
+{
+	g_fd = fd;
+}
+
+/*******************************************************************************
+ *                              UART (uart.h)                                  *
+ *******************************************************************************/
+
+void UART_init(const UART_ConfigType * Config_Ptr)
+{
+	g_rxHead = 0;
+	g_rxTail = 0;
+	g_rxCount = 0;
+	g_baudRate = Config_Ptr->baud_rate;
+}
+
+void UART_sendByte(const uint8 data)
+{
+	while(write(g_fd, &data, 1) != 1)
+	{
+		if(errno != EAGAIN && errno != EINTR)
+		{
+			fprintf(stderr, "UART: line closed\n");
+			exit(EXIT_FAILURE);
+		}
+		HOST_uartPoll(1);
+	}
+}
+
+uint8 UART_txSpace(void)
+{
+	HOST_timerUpdate();
+	return UART_TX_BUFFER_SIZE - 1;
+}
+
+void UART_setBaudRate(UART_BaudRateType baud_rate)
+{
+	g_baudRate = baud_rate;
+}
+
+void UART_getErrorCounters(UART_ErrorCountersType *counters)
+{
+	*counters = g_counters;
+}
+
+void UART_setAddress(uint8 address)
+{
+}
+
+boolean UART_isSelected(void)
+{
+	return TRUE;
+}
+
+void UART_sendAddress(uint8 address)
+{
+}
+
+uint8 UART_recieveByte(void)
+{
+	uint8 data;
+
+	while(g_rxCount == 0)
+	{
+		HOST_uartPoll(-1);
+	}
+
+	data = g_rxBuffer[g_rxTail];
+	g_rxTail = (g_rxTail + 1) & (UART_RX_BUFFER_SIZE - 1);
+	g_rxCount--;
+	return data;
+}
+
+void UART_sendString(const uint8 *Str)
+{
+	while(*Str != '\0')
+	{
+		UART_sendByte(*Str++);
+	}
+}
+
+void UART_receiveString(uint8 *Str)
+{
+	uint8 i = 0;
+
+	Str[i] = UART_recieveByte();
+	while(Str[i] != '#')
+	{
+		Str[++i] = UART_recieveByte();
+	}
+	Str[i] = '\0';
+}
+
+/*
+ * Description :
+ * Polled by the main loops: an idle poll waits 1 ms for the line, so a host
+ * build does not spin on a CPU.
+ */
+uint8 UART_dataAvailable(void)
+{
+	HOST_uartPoll((g_rxCount == 0) ? 1 : 0);
+	return (g_rxCount != 0);
+}
+
+/*******************************************************************************
+ *                    Baud rate detection (autobaud.h)                         *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Every byte on the host line comes at the rate set, a SYNC byte measures it.
+ * The byte is also left in the receive ring, as the UART receives it on target.
+ */
+uint32 AUTOBAUD_measure(void)
+{
+	uint8 last;
+
+	if(HOST_uartPoll(HOST_AUTOBAUD_TIMEOUT_MS) == 0)
+	{
+		return 0;
+	}
+
+	last = g_rxBuffer[(g_rxHead - 1) & (UART_RX_BUFFER_SIZE - 1)];
+	return (last == AUTOBAUD_SYNC_BYTE) ? g_baudRate : 0;
+}
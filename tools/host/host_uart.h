@@ -0,0 +1,33 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: host_uart.h
+ *
+ * Description: Model of the UART driver (uart.h) and of the baud rate detection
+ * (autobaud.h) over a host file descriptor: a pseudo-terminal, or a serial
+ * port wired to a real ECU. The bytes are read into the same receive ring as
+ * the driver, each time it is polled, and written to the descriptor at once:
+ * the transmit buffer is never full. There is no line timing, no 9-bit mode
+ * and no line error, a multi-drop node is always selected.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef HOST_UART_H_
+#define HOST_UART_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Use a file descriptor as the line, before UART_init().
+ */
+void HOST_uartOpen(int fd);
+
+#endif /* HOST_UART_H_ */
@@ -0,0 +1,21 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: util/atomic.h
+ *
+ * Description: Host stand-in for the avr-libc atomic blocks. Nothing interrupts
+ * the host builds, an atomic block is a plain block.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef HOST_UTIL_ATOMIC_H_
+#define HOST_UTIL_ATOMIC_H_
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+#define ATOMIC_BLOCK(type)                for(int host_atomic = 1; host_atomic; host_atomic = 0)
+
+#endif /* HOST_UTIL_ATOMIC_H_ */
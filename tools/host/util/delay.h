@@ -0,0 +1,21 @@
+/******************************************************************************
+ *
+ * Module: HOST
+ *
+ * File Name: util/delay.h
+ *
+ * Description: Host stand-in for the avr-libc busy waits, they sleep instead.
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+void HOST_delay_us(double us);
+
+#define _delay_us(us)                     HOST_delay_us(us)
+#define _delay_ms(ms)                     HOST_delay_us((ms) * 1000.0)
+
+#endif /* HOST_UTIL_DELAY_H_ */
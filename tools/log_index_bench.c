@@ -0,0 +1,230 @@
+/******************************************************************************
+ *
+ * Module: Host tools
+ *
+ * File Name: log_index_bench.c
+ *
+ * Description: Host benchmark of the time index of the fault journal. Runs the
+ * Control ECU fault_log.c on a RAM EEPROM for each memory size, with a log
+ * time that advances in random steps and resets that lose the mirror now and
+ * then, so the journal wraps several times. The index entries are corrupted
+ * at random along the way. At regular points LOG_findRange() is asked for
+ * random time ranges and checked against a brute force search of the log
+ * times of the records still in the journal:
+ *   - misses     : ranges that leave out a record of the time range (must be 0)
+ *   - excess     : records returned out of the time range (whole pages)
+ *   - reads      : EEPROM transfers per query, against the journal pages a
+ *                  linear scan would read
+ *
+ * Usage: log_index_bench [seed]
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fault_log.h"
+#include "external_eeprom.h"
+#include "host_eeprom.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define BENCH_WRAPS                       3     /* Journal rings filled per memory */
+#define BENCH_MAX_STEP_MS                 (5 * LOG_MINUTE_MS)
+#define BENCH_RESET_ODDS                  50    /* One reset in 50 records */
+#define BENCH_MIRROR_LOSS_ODDS            3     /* One reset in 3 loses the mirror */
+#define BENCH_CORRUPT_PERIOD              50    /* Records between two corrupted index entries */
+#define BENCH_QUERY_PERIOD                97    /* Records between two query rounds */
+#define BENCH_QUERIES                     20    /* Queries per round */
+#define BENCH_MAX_RECORDS                 (BENCH_WRAPS * LOG_MAX_PAGES * LOG_RECORDS_PER_PAGE)
+
+/* Same place as LOG_init(): the index follows the journal and the wear counters, 4-byte aligned */
+#define BENCH_INDEX_ADDRESS(pages)        (((EEPROM_AddressType)(pages) * (LOG_PAGE_SIZE + 2) + LOG_INDEX_SIZE - 1) \
+                                           / LOG_INDEX_SIZE * LOG_INDEX_SIZE)
+
+/*******************************************************************************
+ *                                Data Types                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	const char *name;
+	EEPROM_DeviceType device;
+}BENCH_MemoryType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const BENCH_MemoryType g_memories[] =
+{
+	{ "24C16",    EEPROM_24C16(1) },
+	{ "24C64",    EEPROM_24C64(1) },
+	{ "24C512",   EEPROM_24C512(1) },
+	{ "8x24C512", EEPROM_24C512(8) },
+};
+
+/* Memory descriptor the application defines (see Control_APP.c) */
+EEPROM_DeviceType EEPROM_Device = EEPROM_24C16(1);
+
+static uint32 g_now_ms = 0;  /* Time since the last reset */
+
+/* Log time of every record appended, the journal keeps the last LOG_count() */
+static LOG_TimeType g_times[BENCH_MAX_RECORDS];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Stands for sw_timer.c, the log time only needs the time since the reset */
+uint32 SWTIMER_getTime(void)
+{
+	return g_now_ms;
+}
+
+static uint32 BENCH_random(uint32 range)
+{
+	return (uint32)rand() % range;
+}
+
+static void BENCH_reset(void)
+{
+	g_now_ms = BENCH_random(1000);
+	HOST_ieepromLoseWrites(BENCH_random(BENCH_MIRROR_LOSS_ODDS) == 0);
+	LOG_init();
+	HOST_ieepromLoseWrites(FALSE);
+}
+
+static void BENCH_corruptIndex(void)
+{
+	uint16 pages = LOG_getPages();
+	EEPROM_AddressType address = BENCH_INDEX_ADDRESS(pages) +
+			BENCH_random(pages) * LOG_INDEX_SIZE + BENCH_random(LOG_INDEX_SIZE);
+
+	HOST_eepromData()[address] ^= 0x10;
+}
+
+/*
+ * Description :
+ * Run the benchmark on one memory. Returns FALSE if a query missed a record or
+ * the log failed.
+ */
+static boolean BENCH_run(const BENCH_MemoryType *memory)
+{
+	uint32 records, appended = 0, queries = 0, misses = 0;
+	uint64 excess = 0, reads = 0;
+	HOST_EepromStatsType stats;
+
+	HOST_eepromErase();
+	EEPROM_init(&memory->device);
+	g_now_ms = 0;
+	LOG_init();
+
+	records = (uint32)BENCH_WRAPS * LOG_getPages() * LOG_RECORDS_PER_PAGE;
+	while(appended < records)
+	{
+		g_now_ms += BENCH_random(BENCH_MAX_STEP_MS);
+		if(BENCH_random(BENCH_RESET_ODDS) == 0)
+		{
+			BENCH_reset();
+		}
+		if(appended % BENCH_CORRUPT_PERIOD == 0)
+		{
+			BENCH_corruptIndex();
+		}
+
+		g_times[appended++] = LOG_getTime();
+		if(!LOG_append(1 + appended % LOG_COUNTED_CODES))
+		{
+			printf("%-9s append failed after %lu records\n", memory->name, (unsigned long)appended);
+			return FALSE;
+		}
+
+		if(appended % BENCH_QUERY_PERIOD == 0)
+		{
+			uint16 count = LOG_count();
+			const LOG_TimeType *times = &g_times[appended - count];
+			uint8 query;
+
+			for(query = 0; query < BENCH_QUERIES; query++)
+			{
+				LOG_TimeType from = times[BENCH_random(count)];
+				LOG_TimeType to = times[BENCH_random(count)];
+				sint32 low = -1, high = -1;
+				uint16 first, end, index;
+
+				if(from > to)
+				{
+					LOG_TimeType swap = from;
+					from = to;
+					to = swap;
+				}
+				/* Open ranges, as "since the log started" and "up to now" */
+				if(BENCH_random(4) == 0)
+				{
+					from = 0;
+				}
+				if(BENCH_random(4) == 0)
+				{
+					to = LOG_getTime();
+				}
+
+				for(index = 0; index < count; index++)
+				{
+					if(times[index] >= from && times[index] <= to)
+					{
+						if(low < 0)
+						{
+							low = index;
+						}
+						high = index + 1;
+					}
+				}
+
+				HOST_eepromResetStats();
+				if(!LOG_findRange(from, to, &first, &end))
+				{
+					printf("%-9s LOG_findRange failed\n", memory->name);
+					return FALSE;
+				}
+				HOST_eepromGetStats(&stats);
+				reads += stats.reads;
+				queries++;
+
+				if(low >= 0)
+				{
+					if(first > low || end < high)
+					{
+						misses++;
+					}
+					excess += (uint32)(end - first) - (uint32)(high - low);
+				}
+			}
+		}
+	}
+
+	printf("%-9s %5u %8lu %8lu %7lu %8.2f %11.1f %8u\n", memory->name, LOG_getPages(),
+			(unsigned long)appended, (unsigned long)queries, (unsigned long)misses,
+			(double)excess / queries, (double)reads / queries, LOG_getPages());
+	return (misses == 0);
+}
+
+int main(int argc, char *argv[])
+{
+	boolean passed = TRUE;
+	uint8 memory;
+
+	srand((argc > 1) ? (unsigned)strtoul(argv[1], NULL, 0) : 1);
+
+	printf("%-9s %5s %8s %8s %7s %8s %11s %8s\n", "memory", "pages", "records", "queries",
+			"misses", "excess", "reads/query", "linear");
+	for(memory = 0; memory < sizeof(g_memories) / sizeof(g_memories[0]); memory++)
+	{
+		passed = BENCH_run(&g_memories[memory]) && passed;
+	}
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
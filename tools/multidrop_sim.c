@@ -0,0 +1,379 @@
+/******************************************************************************
+ *
+ * Module: Host tools
+ *
+ * File Name: multidrop_sim.c
+ *
+ * Description: Host simulation of the nodes screen of the HMI on a multi-drop
+ * line (LINK_NODES_COUNT > 1). The HMI polls the Control ECUs in turn with
+ * READ_DIDS, one request at a time, like HMI_linkPollNext(): the next node is
+ * addressed once the previous one answered or was given up. The simulation
+ * follows the line byte by byte in simulated time:
+ *   - the address byte (9th bit set) on every change of node,
+ *   - the request and response frames, built by the real frame.c so the byte
+ *     stuffing of the sequence numbers, data and CRC is counted,
+ *   - the main loop of the node before it answers (0 .. -l ms),
+ *   - the LCD writes of the HMI on each reply and on each NODES_REFRESH_MS
+ *     window, which block its main loop (4 LCD accesses of 1 ms each),
+ *   - frames lost at random, with the deadlines and retries of the HMI
+ *     (HMI_linkDeadline(), LINK_MAX_ATTEMPTS).
+ * The refresh rate of each node is counted per NODES_REFRESH_MS window, as
+ * the nodes screen shows it, for several frame loss rates.
+ *
+ * Usage: multidrop_sim [-n nodes] [-l loopMs] [-t seconds] [seed]
+ *   -n : Control ECUs on the line (default 3)
+ *   -l : longest main loop pass of a Control ECU in ms (default 3)
+ *   -t : simulated time per loss rate in s (default 60)
+ *
+ * Author: Kerolous Labib
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "std_types.h"
+#include "frame.h"
+#include "uart.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Link of the HMI on a multi-drop line (HMI_APP.c) */
+#define SIM_BAUD_RATE                     9600UL
+#define SIM_BITS_PER_BYTE                 11UL   /* Start, 8 data, address and stop bits */
+#define SIM_PROCESSING_MS                 100    /* LINK_PROCESSING_MS */
+#define SIM_MAX_ATTEMPTS                  3      /* LINK_MAX_ATTEMPTS */
+#define SIM_DIDS_MAX_LENGTH               (FRAME_MAX_PAYLOAD - 1)
+#define SIM_REFRESH_MS                    1000   /* NODES_REFRESH_MS */
+#define SIM_READ_DIDS                     8      /* READ_DIDS command */
+#define SIM_REQUEST_LENGTH                9      /* READ_DIDS and the 4 status DIDs */
+
+/* LCD of the HMI in 8-bit mode: LCD_SendCommand() and LCD_DisplayCharacter() wait 4 x 1 ms */
+#define SIM_LCD_ACCESS_US                 4000UL
+#define SIM_LCD_REPLY_ACCESSES            (1 + 3 + 1 + 4)  /* Temperature and distance fields of the node row */
+#define SIM_LCD_WINDOW_ACCESSES           (1 + 3)          /* Rate field of a node row */
+#define SIM_HMI_LOOP_US                   500UL            /* Main loop pass of the HMI without LCD writes */
+
+#define SIM_MAX_NODES                     8
+#define SIM_LINE_US(bytes)                ((uint64)(bytes) * SIM_BITS_PER_BYTE * 1000000UL / SIM_BAUD_RATE)
+
+/*******************************************************************************
+ *                                Data Types                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint32 polls;                         /* READ_DIDS requests (first attempts) */
+	uint32 retries;
+	uint32 failures;                      /* Requests given up */
+	uint32 late;                          /* Replies after the deadline of their attempt */
+	uint32 replies[SIM_MAX_NODES];        /* Per node, all windows */
+	uint32 minReplies[SIM_MAX_NODES];     /* Per node, worst window */
+	uint32 windows;
+	uint64 lineUs;                        /* Both directions of the line busy */
+	uint64 lcdUs;                         /* HMI main loop blocked on the LCD */
+}SIM_ResultType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const uint8 g_lossRates[] = { 0, 1, 5, 10 };  /* Frames lost in percent */
+
+static uint8 g_nodes = 3;
+static uint32 g_nodeLoopUs = 3000;
+static uint32 g_durationMs = 60000;
+
+static uint32 g_lineBytes = 0;                       /* Bytes frame.c sent */
+static uint8 g_requestId = 0;
+
+static uint64 g_hmiFree;                             /* HMI main loop free again */
+static uint64 g_nextWindow;                          /* Next NODES_REFRESH_MS screen tick */
+static uint32 g_windowReplies[SIM_MAX_NODES];
+static SIM_ResultType g_result;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* UART and timer of frame.c: the bytes are only counted */
+void UART_sendByte(const uint8 data)
+{
+	g_lineBytes++;
+}
+
+uint8 UART_txSpace(void)
+{
+	return UART_TX_BUFFER_SIZE - 1;
+}
+
+boolean UART_isSelected(void)
+{
+	return TRUE;
+}
+
+uint32 SWTIMER_getTime(void)
+{
+	return 0;
+}
+
+static uint32 SIM_random(uint32 range)
+{
+	return (range == 0) ? 0 : (uint32)rand() % range;
+}
+
+static boolean SIM_lost(uint8 lossRate)
+{
+	return (SIM_random(100) < lossRate);
+}
+
+/*
+ * Description :
+ * Returns the line time in us of a frame built by frame.c, stuffing included.
+ */
+static uint64 SIM_frameTime(uint8 type, uint8 seq, const uint8 *payload, uint8 length)
+{
+	g_lineBytes = 0;
+	FRAME_send(type, seq, payload, length);
+	return SIM_LINE_US(g_lineBytes);
+}
+
+/*
+ * Description :
+ * Line time of the READ_DIDS request of the nodes screen (the 4 status DIDs).
+ */
+static uint64 SIM_requestTime(uint8 id)
+{
+	const uint8 request[SIM_REQUEST_LENGTH] = {
+		SIM_READ_DIDS,
+		(uint8)(FRAME_DID_TEMPERATURE >> 8), (uint8)FRAME_DID_TEMPERATURE,
+		(uint8)(FRAME_DID_DISTANCE >> 8), (uint8)FRAME_DID_DISTANCE,
+		(uint8)(FRAME_DID_MONITORING >> 8), (uint8)FRAME_DID_MONITORING,
+		(uint8)(FRAME_DID_FAULTS_LOGGED >> 8), (uint8)FRAME_DID_FAULTS_LOGGED
+	};
+
+	return SIM_frameTime(FRAME_TYPE_REQUEST, id, request, sizeof(request));
+}
+
+/*
+ * Description :
+ * Line time of the answer of a node, with the values a node reads: a
+ * temperature, a distance, the monitoring flag and the journal count.
+ */
+static uint64 SIM_responseTime(uint8 id)
+{
+	uint16 distance = 2 + SIM_random(400);
+	uint16 logged = SIM_random(600);
+	const uint8 response[] = {
+		SIM_READ_DIDS,
+		(uint8)(FRAME_DID_TEMPERATURE >> 8), (uint8)FRAME_DID_TEMPERATURE, (uint8)(15 + SIM_random(40)),
+		(uint8)(FRAME_DID_DISTANCE >> 8), (uint8)FRAME_DID_DISTANCE, (uint8)(distance >> 8), (uint8)distance,
+		(uint8)(FRAME_DID_MONITORING >> 8), (uint8)FRAME_DID_MONITORING, 1,
+		(uint8)(FRAME_DID_FAULTS_LOGGED >> 8), (uint8)FRAME_DID_FAULTS_LOGGED, (uint8)(logged >> 8), (uint8)logged
+	};
+
+	/* The response carries the correlation id of the request in its SEQ */
+	return SIM_frameTime(FRAME_TYPE_RESPONSE, id, response, sizeof(response));
+}
+
+/*
+ * Description :
+ * Same time as HMI_linkDeadline() for READ_DIDS with one request in flight, in ms.
+ */
+static uint32 SIM_deadline(void)
+{
+	uint32 bits = SIM_BITS_PER_BYTE * (2 * FRAME_OVERHEAD + SIM_REQUEST_LENGTH + 1) + SIM_BITS_PER_BYTE * SIM_DIDS_MAX_LENGTH;
+
+	return SIM_PROCESSING_MS + (bits * 1000UL + SIM_BAUD_RATE - 1) / SIM_BAUD_RATE;
+}
+
+/*
+ * Description :
+ * Returns when the HMI main loop handles an event of the given time. The
+ * screen ticks before it are handled first: each one ends a NODES_REFRESH_MS
+ * window and writes the rates (HMI_showNodeRates()).
+ */
+static uint64 SIM_hmiHandle(uint64 event)
+{
+	uint64 start;
+	uint8 node;
+
+	while(g_nextWindow <= event)
+	{
+		start = (g_nextWindow > g_hmiFree) ? g_nextWindow : g_hmiFree;
+		for(node = 0; node < g_nodes; node++)
+		{
+			if(g_result.windows == 0 || g_windowReplies[node] < g_result.minReplies[node])
+			{
+				g_result.minReplies[node] = g_windowReplies[node];
+			}
+			g_result.replies[node] += g_windowReplies[node];
+			g_windowReplies[node] = 0;
+		}
+		g_result.windows++;
+
+		g_hmiFree = start + (uint64)g_nodes * SIM_LCD_WINDOW_ACCESSES * SIM_LCD_ACCESS_US;
+		g_result.lcdUs += (uint64)g_nodes * SIM_LCD_WINDOW_ACCESSES * SIM_LCD_ACCESS_US;
+		g_nextWindow += SIM_REFRESH_MS * 1000UL;
+	}
+
+	start = (event > g_hmiFree) ? event : g_hmiFree;
+	return start + SIM_random(SIM_HMI_LOOP_US);
+}
+
+/*
+ * Description :
+ * Runs the nodes screen for g_durationMs with the given frame loss rate.
+ */
+static void SIM_run(uint8 lossRate)
+{
+	uint64 now = 0, end = (uint64)g_durationMs * 1000UL;
+	uint64 sent, answered, deadline, frame;
+	uint8 node = 0, selected = 0xFF, attempts;
+	boolean replied;
+
+	memset(&g_result, 0, sizeof(g_result));
+	memset(g_windowReplies, 0, sizeof(g_windowReplies));
+	g_hmiFree = 0;
+	g_nextWindow = SIM_REFRESH_MS * 1000UL;
+
+	while(now < end)
+	{
+		/* HMI_linkPollNext(): one request to the next node, addressed first if needed */
+		g_result.polls++;
+		g_requestId++;
+		attempts = 0;
+		replied = FALSE;
+		sent = now;
+		if(node != selected)
+		{
+			sent += SIM_LINE_US(1);
+			g_result.lineUs += SIM_LINE_US(1);
+			selected = node;
+		}
+
+		while(attempts < SIM_MAX_ATTEMPTS)
+		{
+			/* HMI_linkTransmit(): the deadline counts from the request, on the 1 ms software timer */
+			attempts++;
+			deadline = (now / 1000 + SIM_deadline()) * 1000;
+			frame = SIM_requestTime(g_requestId);
+			sent += frame;
+			g_result.lineUs += frame;
+
+			if(!SIM_lost(lossRate))
+			{
+				/* The node answers from its main loop, then the response goes up the line */
+				frame = SIM_responseTime(g_requestId);
+				answered = sent + SIM_random(g_nodeLoopUs) + frame;
+				g_result.lineUs += frame;
+				if(!SIM_lost(lossRate))
+				{
+					answered = SIM_hmiHandle(answered);
+					if(answered < deadline)
+					{
+						now = answered;
+						replied = TRUE;
+						break;
+					}
+					g_result.late++;
+				}
+			}
+
+			/* HMI_linkTimeout(): sent again to the same node, or given up */
+			now = SIM_hmiHandle(deadline);
+			sent = now;
+			if(attempts < SIM_MAX_ATTEMPTS)
+			{
+				g_result.retries++;
+			}
+		}
+
+		if(replied)
+		{
+			/* FRAME_DIDS on the nodes screen: the row of the node is written */
+			g_windowReplies[node]++;
+			g_hmiFree = now + SIM_LCD_REPLY_ACCESSES * SIM_LCD_ACCESS_US;
+			g_result.lcdUs += SIM_LCD_REPLY_ACCESSES * SIM_LCD_ACCESS_US;
+			now = g_hmiFree;
+		}
+		else
+		{
+			g_result.failures++;
+		}
+		node = (node + 1) % g_nodes;
+	}
+
+	/* Last windows of the run */
+	SIM_hmiHandle(end);
+}
+
+static void SIM_print(uint8 lossRate)
+{
+	uint8 node;
+
+	printf("%3u%% %6lu %7lu %6lu %5lu ", lossRate, (unsigned long)g_result.polls,
+			(unsigned long)g_result.retries, (unsigned long)g_result.failures,
+			(unsigned long)g_result.late);
+	for(node = 0; node < g_nodes; node++)
+	{
+		printf(" %5.2f %3lu", (g_result.windows == 0) ? 0.0 :
+				(double)g_result.replies[node] / g_result.windows,
+				(unsigned long)g_result.minReplies[node]);
+	}
+	printf(" %6.1f %6.1f\n", 100.0 * g_result.lineUs / ((uint64)g_durationMs * 1000UL),
+			100.0 * g_result.lcdUs / ((uint64)g_durationMs * 1000UL));
+}
+
+int main(int argc, char *argv[])
+{
+	uint8 rate, node;
+	int option;
+
+	while((option = getopt(argc, argv, "n:l:t:")) != -1)
+	{
+		switch(option)
+		{
+		case 'n':
+			g_nodes = (uint8)strtoul(optarg, NULL, 0);
+			break;
+		case 'l':
+			g_nodeLoopUs = (uint32)strtoul(optarg, NULL, 0) * 1000UL;
+			break;
+		case 't':
+			g_durationMs = (uint32)strtoul(optarg, NULL, 0) * 1000UL;
+			break;
+		default:
+			g_nodes = 0;
+			break;
+		}
+	}
+	if(g_nodes < 2 || g_nodes > SIM_MAX_NODES || g_durationMs < 2 * SIM_REFRESH_MS)
+	{
+		fprintf(stderr, "usage: %s [-n nodes (2..%u)] [-l loopMs] [-t seconds (2..)] [seed]\n",
+				argv[0], SIM_MAX_NODES);
+		return EXIT_FAILURE;
+	}
+	srand((optind < argc) ? (unsigned)strtoul(argv[optind], NULL, 0) : 1);
+
+	printf("%u nodes, %lu baud, %lu bits per byte, node loop 0..%lu ms, deadline %lu ms, %lu s per loss rate\n",
+			g_nodes, SIM_BAUD_RATE, SIM_BITS_PER_BYTE, (unsigned long)g_nodeLoopUs / 1000,
+			(unsigned long)SIM_deadline(), (unsigned long)g_durationMs / 1000);
+	printf("loss  polls retries failed  late ");
+	for(node = 0; node < g_nodes; node++)
+	{
+		printf(" N%u Hz min", node + 1);
+	}
+	printf("  line%%   lcd%%\n");
+
+	for(rate = 0; rate < sizeof(g_lossRates); rate++)
+	{
+		SIM_run(g_lossRates[rate]);
+		SIM_print(g_lossRates[rate]);
+	}
+	return EXIT_SUCCESS;
+}